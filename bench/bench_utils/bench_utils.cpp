@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <istream>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bench_utils.hpp"
+
+namespace
+{
+
+auto allocation_counter = std::atomic<std::size_t> {0};
+
+auto counted_allocation(std::size_t n_bytes) -> void*
+{
+    allocation_counter.fetch_add(1, std::memory_order_relaxed);
+
+    // `malloc(0)` may return a null pointer, but `operator new` must not
+    if (auto pointer = std::malloc(n_bytes == 0 ? 1 : n_bytes)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc {};
+}
+
+auto counted_aligned_allocation(std::size_t n_bytes, std::align_val_t alignment) -> void*
+{
+    allocation_counter.fetch_add(1, std::memory_order_relaxed);
+
+    const auto align = static_cast<std::size_t>(alignment);
+    const auto rounded_n_bytes = ((n_bytes + align - 1) / align) * align;
+
+    if (auto pointer = std::aligned_alloc(align, rounded_n_bytes == 0 ? align : rounded_n_bytes)) {
+        return pointer;
+    }
+
+    throw std::bad_alloc {};
+}
+
+auto escape_json_string(std::string_view text) -> std::string
+{
+    auto escaped = std::string {};
+    for (const auto character : text) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+
+    return escaped;
+}
+
+// the string value that follows `"key": "` on the line, unescaped
+auto find_json_string_value(std::string_view line, std::string_view key) -> std::optional<std::string>
+{
+    auto pattern = std::string {"\""};
+    pattern += key;
+    pattern += "\": \"";
+
+    const auto start = line.find(pattern);
+    if (start == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    auto value = std::string {};
+    for (auto i_char = start + pattern.size(); i_char < line.size(); ++i_char) {
+        if (line[i_char] == '\\' && i_char + 1 < line.size()) {
+            value += line[++i_char];
+        }
+        else if (line[i_char] == '"') {
+            return value;
+        }
+        else {
+            value += line[i_char];
+        }
+    }
+
+    return std::nullopt;
+}
+
+// the number that follows `"key": ` on the line
+auto find_json_number_value(std::string_view line, std::string_view key) -> std::optional<double>
+{
+    auto pattern = std::string {"\""};
+    pattern += key;
+    pattern += "\": ";
+
+    const auto start = line.find(pattern);
+    if (start == std::string_view::npos) {
+        return std::nullopt;
+    }
+
+    auto value_stream = std::istringstream {std::string {line.substr(start + pattern.size())}};
+    auto value = double {};
+    if (!(value_stream >> value)) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+}  // namespace
+
+// the array, nothrow and sized forms of `new` and `delete` forward to these
+auto operator new(std::size_t n_bytes) -> void*
+{
+    return counted_allocation(n_bytes);
+}
+
+auto operator new(std::size_t n_bytes, std::align_val_t alignment) -> void*
+{
+    return counted_aligned_allocation(n_bytes, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace bench_utils
+{
+
+auto n_allocations() noexcept -> std::size_t
+{
+    return allocation_counter.load(std::memory_order_relaxed);
+}
+
+void print_results_table(std::ostream& stream, const std::vector<BenchmarkResult>& results)
+{
+    auto name_width = std::size_t {10};
+    for (const auto& result : results) {
+        name_width = std::max(name_width, result.name.size());
+    }
+
+    const auto name_column = static_cast<int>(name_width + 2);
+
+    stream << std::left << std::setw(name_column) << "benchmark" << std::right;
+    stream << std::setw(16) << "ns/op" << std::setw(18) << "evaluations/s" << std::setw(14) << "allocs/op" << '\n';
+
+    for (const auto& result : results) {
+        stream << std::left << std::setw(name_column) << result.name << std::right;
+        stream << std::fixed << std::setprecision(1) << std::setw(16) << result.ns_per_op;
+        stream << std::scientific << std::setprecision(3) << std::setw(18) << result.evaluations_per_second;
+        stream << std::fixed << std::setprecision(2) << std::setw(14) << result.allocations_per_op << '\n';
+    }
+
+    stream << std::defaultfloat;
+}
+
+void write_results_json(
+    std::ostream& stream,
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<std::pair<std::string, std::string>>& context
+)
+{
+    auto json = std::stringstream {};
+    json << std::setprecision(10);
+
+    json << "{\n";
+    json << "  \"context\": {";
+    for (std::size_t i {0}; i < context.size(); ++i) {
+        const auto& [key, value] = context[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    \"" << escape_json_string(key) << "\": \"" << escape_json_string(value) << '"';
+    }
+    json << "\n  },\n";
+
+    json << "  \"benchmarks\": [";
+    for (std::size_t i {0}; i < results.size(); ++i) {
+        const auto& result = results[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    {";
+        json << "\"name\": \"" << escape_json_string(result.name) << "\", ";
+        json << "\"evaluations_per_op\": " << result.n_evaluations_per_op << ", ";
+        json << "\"n_ops\": " << result.n_ops << ", ";
+        json << "\"ns_per_op\": " << result.ns_per_op << ", ";
+        json << "\"evaluations_per_second\": " << result.evaluations_per_second << ", ";
+        json << "\"allocations_per_op\": " << result.allocations_per_op;
+        json << "}";
+    }
+    json << "\n  ]\n";
+    json << "}\n";
+
+    stream << json.str();
+}
+
+auto read_results_json(std::istream& stream) -> std::vector<std::pair<std::string, double>>
+{
+    auto entries = std::vector<std::pair<std::string, double>> {};
+
+    auto line = std::string {};
+    while (std::getline(stream, line)) {
+        const auto name = find_json_string_value(line, "name");
+        const auto evaluations_per_second = find_json_number_value(line, "evaluations_per_second");
+        if (name && evaluations_per_second) {
+            entries.emplace_back(*name, *evaluations_per_second);
+        }
+    }
+
+    return entries;
+}
+
+auto compare_to_baseline(
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<std::pair<std::string, double>>& baseline,
+    double tolerance
+) -> std::vector<BaselineComparison>
+{
+    auto comparisons = std::vector<BaselineComparison> {};
+
+    for (const auto& result : results) {
+        const auto it_baseline = std::find_if(baseline.begin(), baseline.end(), [&](const auto& entry) {
+            return entry.first == result.name;
+        });
+
+        if (it_baseline == baseline.end() || it_baseline->second <= 0.0) {
+            continue;
+        }
+
+        const auto baseline_evaluations_per_second = it_baseline->second;
+        const auto relative_change = result.evaluations_per_second / baseline_evaluations_per_second - 1.0;
+        const auto is_regression = relative_change < -tolerance;
+
+        comparisons.push_back({
+            result.name,
+            baseline_evaluations_per_second,
+            result.evaluations_per_second,
+            relative_change,
+            is_regression
+        });
+    }
+
+    return comparisons;
+}
+
+void print_baseline_comparison(std::ostream& stream, const std::vector<BaselineComparison>& comparisons)
+{
+    auto name_width = std::size_t {10};
+    for (const auto& comparison : comparisons) {
+        name_width = std::max(name_width, comparison.name.size());
+    }
+
+    const auto name_column = static_cast<int>(name_width + 2);
+
+    stream << std::left << std::setw(name_column) << "benchmark" << std::right;
+    stream << std::setw(18) << "baseline evals/s" << std::setw(18) << "evaluations/s" << std::setw(12) << "change";
+    stream << "  status\n";
+
+    for (const auto& comparison : comparisons) {
+        stream << std::left << std::setw(name_column) << comparison.name << std::right;
+        stream << std::scientific << std::setprecision(3);
+        stream << std::setw(18) << comparison.baseline_evaluations_per_second;
+        stream << std::setw(18) << comparison.evaluations_per_second;
+        stream << std::fixed << std::setprecision(1) << std::showpos;
+        stream << std::setw(11) << 100.0 * comparison.relative_change << '%' << std::noshowpos;
+        stream << "  " << (comparison.is_regression ? "REGRESSION" : "ok") << '\n';
+    }
+
+    stream << std::defaultfloat;
+}
+
+}  // namespace bench_utils
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench_utils
+{
+
+/*
+    The number of calls made so far to the global `operator new`, on any thread; the benchmark executable
+    replaces `operator new` to count them (see `bench_utils.cpp`).
+*/
+auto n_allocations() noexcept -> std::size_t;
+
+// keeps the compiler from optimizing away a value that is computed only to be measured
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchmarkSettings
+{
+    // each sample repeats the operation until at least this much time has passed
+    double min_seconds_per_sample {0.05};
+    std::size_t n_samples {5};
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t n_evaluations_per_op;
+    std::size_t n_ops;
+    double ns_per_op;
+    double evaluations_per_second;
+    double allocations_per_op;
+};
+
+/*
+    Time `operation()`, which performs `n_evaluations_per_op` evaluations (pair energies, moves, and so on)
+    each time it is called.
+
+    The number of calls per sample is chosen so that each sample takes at least `min_seconds_per_sample`;
+    the median time per call over the samples is reported, which is less sensitive to the occasional
+    interruption than the mean.
+*/
+template <typename Operation>
+auto run_benchmark(
+    std::string name,
+    std::size_t n_evaluations_per_op,
+    Operation&& operation,
+    const BenchmarkSettings& settings = {}
+) -> BenchmarkResult
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto seconds_for = [&](std::size_t n_ops) {
+        const auto start = clock::now();
+        for (std::size_t i_op {0}; i_op < n_ops; ++i_op) {
+            operation();
+        }
+
+        return std::chrono::duration<double> {clock::now() - start}.count();
+    };
+
+    // the first call also warms up the caches and any buffers the operation fills lazily
+    auto n_ops_per_sample = std::size_t {1};
+    while (seconds_for(n_ops_per_sample) < settings.min_seconds_per_sample) {
+        n_ops_per_sample *= 2;
+    }
+
+    auto ns_per_op_samples = std::vector<double> {};
+    ns_per_op_samples.reserve(settings.n_samples);
+
+    const auto n_allocations_before = n_allocations();
+    for (std::size_t i_sample {0}; i_sample < settings.n_samples; ++i_sample) {
+        const auto seconds = seconds_for(n_ops_per_sample);
+        ns_per_op_samples.push_back(1.0e9 * seconds / static_cast<double>(n_ops_per_sample));
+    }
+    const auto n_allocations_made = n_allocations() - n_allocations_before;
+
+    // the vector was reserved up front, so sorting it and the timing loop above make no allocations
+    std::sort(ns_per_op_samples.begin(), ns_per_op_samples.end());
+    const auto ns_per_op = ns_per_op_samples[ns_per_op_samples.size() / 2];
+
+    const auto n_ops = n_ops_per_sample * settings.n_samples;
+    const auto evaluations_per_second = 1.0e9 * static_cast<double>(n_evaluations_per_op) / ns_per_op;
+    const auto allocations_per_op = static_cast<double>(n_allocations_made) / static_cast<double>(n_ops);
+
+    return {std::move(name), n_evaluations_per_op, n_ops, ns_per_op, evaluations_per_second, allocations_per_op};
+}
+
+void print_results_table(std::ostream& stream, const std::vector<BenchmarkResult>& results);
+
+/*
+    Write the results as a JSON document; `context` holds extra string-valued fields that describe the run
+    (the inputs used, the seed, and so on), so that results from different runs can be told apart.
+*/
+void write_results_json(
+    std::ostream& stream,
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<std::pair<std::string, std::string>>& context
+);
+
+/*
+    The name and the evaluations per second of each benchmark in a JSON document written by
+    `write_results_json()`; this is not a general JSON parser, and relies on each benchmark being written
+    on a line of its own.
+*/
+auto read_results_json(std::istream& stream) -> std::vector<std::pair<std::string, double>>;
+
+struct BaselineComparison
+{
+    std::string name;
+    double baseline_evaluations_per_second;
+    double evaluations_per_second;
+    double relative_change;
+    bool is_regression;
+};
+
+/*
+    Compare the throughput of each result against the baseline with the same name; a result is a regression
+    if its throughput has fallen by more than the fraction `tolerance`. Results without a baseline are left
+    out of the comparison.
+*/
+auto compare_to_baseline(
+    const std::vector<BenchmarkResult>& results,
+    const std::vector<std::pair<std::string, double>>& baseline,
+    double tolerance
+) -> std::vector<BaselineComparison>;
+
+void print_baseline_comparison(std::ostream& stream, const std::vector<BaselineComparison>& comparisons);
+
+}  // namespace bench_utils
@@ -0,0 +1,547 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <torch/script.h>
+
+#include <bench_utils.hpp>
+#include <constants/constants.hpp>
+#include <coordinates/attard/four_body.hpp>
+#include <coordinates/cell_list.hpp>
+#include <coordinates/coordinates.hpp>
+#include <environment/environment.hpp>
+#include <estimators/pimc/centroid.hpp>
+#include <estimators/pimc/centroid_radial_distribution_function.hpp>
+#include <estimators/pimc/four_body_potential.hpp>
+#include <estimators/pimc/primitive_kinetic.hpp>
+#include <estimators/pimc/radial_distribution_function.hpp>
+#include <estimators/pimc/three_body_potential.hpp>
+#include <estimators/pimc/two_body_potential.hpp>
+#include <geometries/lattice_type.hpp>
+#include <interactions/four_body/published_potential.hpp>
+#include <interactions/handlers/composite_interaction_handler.hpp>
+#include <interactions/handlers/nearest_neighbour_interaction_handler.hpp>
+#include <mathtools/grid/grid3d.hpp>
+#include <mathtools/histogram/histogram.hpp>
+#include <mathtools/interpolate/trilinear_interp.hpp>
+#include <pimc/bisection_multibead_position_move_performer.hpp>
+#include <pimc/centre_of_mass_move.hpp>
+#include <pimc/single_bead_position_move.hpp>
+#include <rng/generator.hpp>
+#include <worldline/worldline.hpp>
+
+#include <helper.cpp>
+
+/*
+    Microbenchmarks for the pieces of the simulation that the main loop spends its time in.
+
+    Every input is fixed: the worldlines are an HCP lattice with a small seeded jitter on each bead, and
+    the move performers use a seeded PRNG, so that two runs on the same machine measure the same work.
+*/
+
+namespace
+{
+
+constexpr auto NDIM = std::size_t {3};
+
+constexpr auto DENSITY = double {0.026};
+constexpr auto N_UNIT_CELLS = std::array<std::size_t, 3> {3, 2, 2};
+constexpr auto N_TIMESLICES = std::size_t {64};
+constexpr auto TEMPERATURE = double {4.2};
+constexpr auto SEED = std::uint64_t {12345};
+
+// the bead positions are displaced from their lattice sites by up to this fraction of the lattice constant
+constexpr auto JITTER_FRACTION = double {0.05};
+
+constexpr auto FOUR_BODY_BATCH_SIZES = std::array<long int, 4> {1, 16, 128, 1024};
+
+struct CommandLineArguments
+{
+    std::filesystem::path two_body_filepath;
+    std::filesystem::path three_body_filepath;
+    std::optional<std::filesystem::path> four_body_filepath {std::nullopt};
+    std::optional<std::filesystem::path> json_filepath {std::nullopt};
+};
+
+void print_usage()
+{
+    std::cout << "pimc-sim-bench two_body_filepath three_body_filepath [--four-body path] [--json path]\n";
+}
+
+auto parse_command_line_arguments(int argc, char** argv) -> std::optional<CommandLineArguments>
+{
+    if (argc < 3) {
+        return std::nullopt;
+    }
+
+    auto arguments = CommandLineArguments {argv[1], argv[2]};
+
+    for (int i_arg {3}; i_arg < argc; i_arg += 2) {
+        const auto option = std::string_view {argv[i_arg]};
+        if (i_arg + 1 >= argc) {
+            return std::nullopt;
+        }
+
+        if (option == "--four-body") {
+            arguments.four_body_filepath = argv[i_arg + 1];
+        }
+        else if (option == "--json") {
+            arguments.json_filepath = argv[i_arg + 1];
+        }
+        else {
+            return std::nullopt;
+        }
+    }
+
+    return arguments;
+}
+
+template <std::floating_point FP>
+auto jittered_lattice_worldlines(FP density) -> std::pair<worldline::Worldlines<FP, NDIM>, coord::BoxSides<FP, NDIM>>
+{
+    const auto [n_particles, minimage_box, lattice_site_positions] =
+        build_hcp_lattice_structure(density, N_UNIT_CELLS);
+
+    const auto lattice_constant = geom::density_to_lattice_constant(density, geom::LatticeType::HCP);
+    const auto max_jitter = static_cast<FP>(JITTER_FRACTION) * lattice_constant;
+
+    auto prng = std::mt19937 {SEED};
+    auto distrib = std::uniform_real_distribution<FP> {-max_jitter, max_jitter};
+
+    auto worldlines = worldline::worldlines_from_positions<FP, NDIM>(lattice_site_positions, N_TIMESLICES);
+    for (std::size_t i_tslice {0}; i_tslice < N_TIMESLICES; ++i_tslice) {
+        for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+            auto point = worldlines.get(i_tslice, i_part);
+            for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+                point[i_dim] += distrib(prng);
+            }
+            worldlines.set(i_tslice, i_part, point);
+        }
+    }
+
+    return {std::move(worldlines), minimage_box};
+}
+
+// the mutual nearest-neighbour pairs and triplets of the first timeslice
+template <std::floating_point FP>
+auto nearest_neighbour_groups(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const coord::BoxSides<FP, NDIM>& box,
+    FP cutoff_distance
+)
+{
+    const auto distance_calculator = coord::PeriodicDistanceMeasureWrapper<FP, NDIM> {box};
+    const auto timeslice = worldlines.timeslice(0);
+    const auto n_particles = worldlines.n_worldlines();
+
+    auto pair_distances = std::vector<FP> {};
+    auto triplet_distances = std::vector<std::array<FP, 3>> {};
+
+    for (std::size_t ip0 {0}; ip0 < n_particles; ++ip0) {
+        for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles; ++ip1) {
+            const auto dist01 = distance_calculator(timeslice[ip0], timeslice[ip1]);
+            if (dist01 > cutoff_distance) {
+                continue;
+            }
+
+            pair_distances.push_back(dist01);
+
+            for (std::size_t ip2 {ip1 + 1}; ip2 < n_particles; ++ip2) {
+                const auto dist02 = distance_calculator(timeslice[ip0], timeslice[ip2]);
+                const auto dist12 = distance_calculator(timeslice[ip1], timeslice[ip2]);
+                if (dist02 <= cutoff_distance && dist12 <= cutoff_distance) {
+                    triplet_distances.push_back({dist01, dist02, dist12});
+                }
+            }
+        }
+    }
+
+    return std::pair {std::move(pair_distances), std::move(triplet_distances)};
+}
+
+// the side lengths of the quadruplets formed by each particle and the first three of its neighbours
+auto nearest_neighbour_quadruplet_side_lengths(
+    const worldline::Worldlines<float, NDIM>& worldlines,
+    const coord::BoxSides<float, NDIM>& box,
+    const mathtools::SquareAdjacencyMatrix& adjmat
+) -> std::vector<coord::FourBodySideLengths<float>>
+{
+    const auto distance_calculator = coord::PeriodicDistanceMeasureWrapper<float, NDIM> {box};
+    const auto timeslice = worldlines.timeslice(0);
+
+    auto side_lengths = std::vector<coord::FourBodySideLengths<float>> {};
+    for (std::size_t ip0 {0}; ip0 < worldlines.n_worldlines(); ++ip0) {
+        const auto neighbours = adjmat.neighbours(ip0);
+        if (neighbours.size() < 3) {
+            continue;
+        }
+
+        const auto p0 = timeslice[ip0];
+        const auto p1 = timeslice[neighbours[0]];
+        const auto p2 = timeslice[neighbours[1]];
+        const auto p3 = timeslice[neighbours[2]];
+
+        side_lengths.push_back({
+            distance_calculator(p0, p1),
+            distance_calculator(p0, p2),
+            distance_calculator(p0, p3),
+            distance_calculator(p1, p2),
+            distance_calculator(p1, p3),
+            distance_calculator(p2, p3)
+        });
+    }
+
+    return side_lengths;
+}
+
+void run_potential_benchmarks(const CommandLineArguments& arguments, std::vector<bench_utils::BenchmarkResult>& results)
+{
+    const auto [worldlines, box] = jittered_lattice_worldlines<double>(DENSITY);
+    const auto lattice_constant = geom::density_to_lattice_constant(DENSITY, geom::LatticeType::HCP);
+    const auto [pair_distances, triplet_distances] = nearest_neighbour_groups(worldlines, box, 1.1 * lattice_constant);
+
+    const auto pot2b = interact::two_body_schmidt2015<double>(arguments.two_body_filepath);
+    auto pair_distances_squared = std::vector<double> {};
+    for (const auto dist : pair_distances) {
+        pair_distances_squared.push_back(dist * dist);
+    }
+
+    results.push_back(bench_utils::run_benchmark("FSHTwoBodyPotential", pair_distances_squared.size(), [&]() {
+        auto energy = double {};
+        for (const auto dist_sq : pair_distances_squared) {
+            energy += pot2b(dist_sq);
+        }
+        bench_utils::do_not_optimize(energy);
+    }));
+
+    auto triplet_distances_float = std::vector<std::array<float, 3>> {};
+    for (const auto& [dist01, dist02, dist12] : triplet_distances) {
+        triplet_distances_float.push_back(
+            {static_cast<float>(dist01), static_cast<float>(dist02), static_cast<float>(dist12)}
+        );
+    }
+
+    const auto pot3b = interact::three_body_ibrahim2022<float>(arguments.three_body_filepath);
+    results.push_back(bench_utils::run_benchmark("ThreeBodyParaH2Potential", triplet_distances_float.size(), [&]() {
+        auto energy = float {};
+        for (const auto& [dist01, dist02, dist12] : triplet_distances_float) {
+            energy += pot3b(dist01, dist02, dist12);
+        }
+        bench_utils::do_not_optimize(energy);
+    }));
+
+    // the interpolator is measured on its own, at points spread evenly over its whole domain
+    auto table = interact::read_ibrahim2022_table<float>(arguments.three_body_filepath);
+    const auto shape = mathtools::Shape3D {table.shape.at(0), table.shape.at(1), table.shape.at(2)};
+    const auto limits0 = mathtools_utils::AxisLimits {table.limits.at(0), table.limits.at(1)};
+    const auto limits1 = mathtools_utils::AxisLimits {table.limits.at(2), table.limits.at(3)};
+    const auto limits2 = mathtools_utils::AxisLimits {table.limits.at(4), table.limits.at(5)};
+    const auto interpolator = mathtools::TrilinearInterpolator<float> {
+        mathtools::Grid3D<float> {std::move(table.values), shape}, limits0, limits1, limits2
+    };
+
+    auto prng = std::mt19937 {SEED};
+    auto distrib0 = std::uniform_real_distribution<float> {limits0.lower(), limits0.upper()};
+    auto distrib1 = std::uniform_real_distribution<float> {limits1.lower(), limits1.upper()};
+    auto distrib2 = std::uniform_real_distribution<float> {limits2.lower(), limits2.upper()};
+
+    auto interpolation_points = std::vector<std::array<float, 3>>(1024);
+    for (auto& point : interpolation_points) {
+        point = {distrib0(prng), distrib1(prng), distrib2(prng)};
+    }
+
+    results.push_back(bench_utils::run_benchmark("TrilinearInterpolator", interpolation_points.size(), [&]() {
+        auto energy = float {};
+        for (const auto& [x0, x1, x2] : interpolation_points) {
+            energy += interpolator(x0, x1, x2);
+        }
+        bench_utils::do_not_optimize(energy);
+    }));
+}
+
+void run_simulation_benchmarks(
+    const CommandLineArguments& arguments,
+    std::vector<bench_utils::BenchmarkResult>& results
+)
+{
+    auto [worldlines, minimage_box] = jittered_lattice_worldlines<double>(DENSITY);
+    const auto n_particles = worldlines.n_worldlines();
+
+    const auto periodic_distance_calculator = coord::PeriodicDistanceMeasureWrapper<double, NDIM> {minimage_box};
+    const auto periodic_distance_squared_calculator =
+        coord::PeriodicDistanceSquaredMeasureWrapper<double, NDIM> {minimage_box};
+
+    const auto pot = fsh_potential<double>(minimage_box, arguments.two_body_filepath);
+    const auto pot3b = threebodyparah2_potential(minimage_box, arguments.three_body_filepath);
+
+    // the handlers are built the same way as in `main.cpp`
+    using PairInteractionHandler = interact::NearestNeighbourPairInteractionHandler<decltype(pot), double, NDIM>;
+    using TripletInteractionHandler =
+        interact::NearestNeighbourTripletInteractionHandler<decltype(pot3b), double, NDIM>;
+    using InteractionHandler = interact::
+        CompositeNearestNeighbourInteractionHandler<double, NDIM, PairInteractionHandler, TripletInteractionHandler>;
+
+    const auto lattice_constant = geom::density_to_lattice_constant(DENSITY, geom::LatticeType::HCP);
+    const auto pair_cutoff_distance = 2.2 * lattice_constant;
+    const auto triplet_cutoff_distance = 1.1 * lattice_constant;
+
+    auto pair_handler = PairInteractionHandler {pot, n_particles};
+    auto triplet_handler = TripletInteractionHandler {pot3b, n_particles};
+    auto interaction_handler = InteractionHandler {
+        PairInteractionHandler {pot, n_particles},
+        TripletInteractionHandler {pot3b, n_particles}
+    };
+
+    const auto update_adjmat = [&](mathtools::SquareAdjacencyMatrix& adjmat, double cutoff_distance) {
+        interact::update_centroid_adjacency_matrix<double, NDIM>(
+            worldlines, periodic_distance_squared_calculator, adjmat, cutoff_distance
+        );
+    };
+
+    update_adjmat(pair_handler.adjacency_matrix(), pair_cutoff_distance);
+    update_adjmat(triplet_handler.adjacency_matrix(), triplet_cutoff_distance);
+    update_adjmat(interaction_handler.adjacency_matrix<0>(), pair_cutoff_distance);
+    update_adjmat(interaction_handler.adjacency_matrix<1>(), triplet_cutoff_distance);
+
+    // each operation evaluates the energy of every particle on one timeslice, cycling through the timeslices
+    const auto benchmark_handler = [&](std::string name, auto& handler) {
+        auto i_tslice = std::size_t {0};
+        results.push_back(bench_utils::run_benchmark(std::move(name), n_particles, [&]() {
+            auto energy = double {};
+            for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+                energy += handler(i_tslice, i_part, worldlines);
+            }
+            i_tslice = (i_tslice + 1) % N_TIMESLICES;
+            bench_utils::do_not_optimize(energy);
+        }));
+    };
+
+    benchmark_handler("NearestNeighbourPairInteractionHandler", pair_handler);
+    benchmark_handler("NearestNeighbourTripletInteractionHandler", triplet_handler);
+    benchmark_handler("CompositeNearestNeighbourInteractionHandler", interaction_handler);
+
+    /* the move performers; each operation moves every particle once, or every bead of one particle */
+    const auto h2_mass = constants::H2_MASS_IN_AMU<double>;
+    const auto environment = envir::create_environment(TEMPERATURE, h2_mass, N_TIMESLICES, n_particles);
+    auto prngw = rng::RandomNumberGeneratorWrapper<std::mt19937>::from_uint64(SEED);
+
+    auto com_mover = pimc::CentreOfMassMovePerformer<double, NDIM> {N_TIMESLICES, 0.3};
+    auto single_bead_mover = pimc::SingleBeadPositionMovePerformer<double, NDIM> {N_TIMESLICES};
+    auto multi_bead_mover = pimc::BisectionMultibeadPositionMovePerformer<double, NDIM> {
+        pimc::BisectionLevelMoveInfo {0.5, 2}
+    };
+
+    results.push_back(bench_utils::run_benchmark("CentreOfMassMovePerformer", n_particles, [&]() {
+        for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+            com_mover(i_part, worldlines, prngw, interaction_handler, environment);
+        }
+    }));
+
+    auto i_part_single = std::size_t {0};
+    results.push_back(bench_utils::run_benchmark("SingleBeadPositionMovePerformer", N_TIMESLICES, [&]() {
+        for (std::size_t i_tslice {0}; i_tslice < N_TIMESLICES; ++i_tslice) {
+            single_bead_mover(i_part_single, i_tslice, worldlines, prngw, interaction_handler, environment);
+        }
+        i_part_single = (i_part_single + 1) % n_particles;
+    }));
+
+    auto i_part_multi = std::size_t {0};
+    results.push_back(bench_utils::run_benchmark("BisectionMultibeadPositionMovePerformer", N_TIMESLICES, [&]() {
+        for (std::size_t i_tslice {0}; i_tslice < N_TIMESLICES; ++i_tslice) {
+            multi_bead_mover(i_part_multi, i_tslice, worldlines, prngw, interaction_handler, environment);
+        }
+        i_part_multi = (i_part_multi + 1) % n_particles;
+    }));
+
+    /* the estimators; each operation is one call, as made once per block in `main.cpp` */
+    const auto box_cutoff_distance = coord::box_cutoff_distance(minimage_box);
+    auto radial_dist_histo = mathtools::Histogram<double> {0.0, box_cutoff_distance, 1024};
+    auto centroid_dist_histo = mathtools::Histogram<double> {0.0, box_cutoff_distance, 1024};
+
+    // the cell list only prunes in a box this small with a cutoff shorter than that of the triplet handler
+    const auto cell_list_cutoff_distance =
+        std::min(triplet_cutoff_distance, coord::longest_pruning_cell_list_cutoff_distance(minimage_box));
+
+    const auto benchmark_estimator = [&](std::string name, auto&& estimator) {
+        results.push_back(bench_utils::run_benchmark(std::move(name), 1, [&]() {
+            bench_utils::do_not_optimize(estimator());
+        }));
+    };
+
+    benchmark_estimator("total_primitive_kinetic_energy", [&]() {
+        return estim::total_primitive_kinetic_energy(worldlines, environment);
+    });
+    benchmark_estimator("total_pair_potential_energy_periodic", [&]() {
+        return estim::total_pair_potential_energy_periodic(worldlines, pot);
+    });
+    benchmark_estimator("total_triplet_potential_energy_periodic", [&]() {
+        const auto& point_pot = interaction_handler.get<1>().point_potential();
+        return estim::total_triplet_potential_energy_periodic(worldlines, point_pot);
+    });
+    benchmark_estimator("total_triplet_potential_energy_periodic_adjacency_matrix", [&]() {
+        const auto& point_pot = interaction_handler.get<1>().point_potential();
+        const auto& adjmat = interaction_handler.adjacency_matrix<1>();
+        return estim::total_triplet_potential_energy_periodic(worldlines, point_pot, adjmat);
+    });
+    benchmark_estimator("total_triplet_potential_energy_periodic_cell_list", [&]() {
+        const auto& point_pot = interaction_handler.get<1>().point_potential();
+        return estim::total_triplet_potential_energy_periodic(
+            worldlines, point_pot, minimage_box, cell_list_cutoff_distance
+        );
+    });
+    benchmark_estimator("rms_centroid_distance", [&]() { return estim::rms_centroid_distance(worldlines); });
+    benchmark_estimator("absolute_centroid_distance", [&]() { return estim::absolute_centroid_distance(worldlines); });
+    benchmark_estimator("update_radial_distribution_function_histogram", [&]() {
+        estim::update_radial_distribution_function_histogram(
+            radial_dist_histo, periodic_distance_calculator, worldlines
+        );
+        return radial_dist_histo.bins().size();
+    });
+    benchmark_estimator("update_centroid_radial_distribution_function_histogram", [&]() {
+        estim::update_centroid_radial_distribution_function_histogram(
+            centroid_dist_histo, periodic_distance_calculator, worldlines
+        );
+        return centroid_dist_histo.bins().size();
+    });
+}
+
+void run_four_body_benchmarks(
+    const std::filesystem::path& four_body_filepath,
+    std::vector<bench_utils::BenchmarkResult>& results
+)
+{
+    const auto density = static_cast<float>(DENSITY);
+    const auto [worldlines, minimage_box] = jittered_lattice_worldlines<float>(density);
+    const auto n_particles = worldlines.n_worldlines();
+
+    const auto lattice_constant = geom::density_to_lattice_constant(density, geom::LatticeType::HCP);
+    const auto quadruplet_cutoff_distance = 1.1f * lattice_constant;
+
+    const auto periodic_distance_squared_calculator =
+        coord::PeriodicDistanceSquaredMeasureWrapper<float, NDIM> {minimage_box};
+
+    constexpr auto flag = interact::PermutationTransformerFlag::EXACT;
+
+    /* the unbuffered potential, evaluated directly on batches of different sizes */
+    const auto pot4b = interact::get_published_four_body_potential<NDIM, flag>(four_body_filepath);
+
+    auto adjmat = mathtools::SquareAdjacencyMatrix {n_particles};
+    interact::update_centroid_adjacency_matrix<float, NDIM>(
+        worldlines, periodic_distance_squared_calculator, adjmat, quadruplet_cutoff_distance
+    );
+    const auto side_lengths = nearest_neighbour_quadruplet_side_lengths(worldlines, minimage_box, adjmat);
+
+    for (const auto batch_size : FOUR_BODY_BATCH_SIZES) {
+        auto samples = torch::empty({batch_size, 6});
+        for (long int i_sample {0}; i_sample < batch_size; ++i_sample) {
+            const auto& sides = side_lengths[static_cast<std::size_t>(i_sample) % side_lengths.size()];
+            samples[i_sample][0] = sides.dist01;
+            samples[i_sample][1] = sides.dist02;
+            samples[i_sample][2] = sides.dist03;
+            samples[i_sample][3] = sides.dist12;
+            samples[i_sample][4] = sides.dist13;
+            samples[i_sample][5] = sides.dist23;
+        }
+
+        auto name = std::string {"ExtrapolatedPotential::evaluate_batch/"};
+        name += std::to_string(batch_size);
+
+        const auto n_samples = static_cast<std::size_t>(batch_size);
+        results.push_back(bench_utils::run_benchmark(std::move(name), n_samples, [&]() {
+            const auto energies = pot4b.evaluate_batch(samples);
+            bench_utils::do_not_optimize(energies.data_ptr<float>());
+        }));
+    }
+
+    /* the buffered potential, through the handler and the estimator, as in `perturbative2b3b4b.cpp` */
+    const long int buffer_size = 1024;
+    using QuadrupletPotential = decltype(interact::get_published_buffered_four_body_potential<NDIM, flag>(
+        four_body_filepath, buffer_size
+    ));
+    using QuadrupletInteractionHandler =
+        interact::NearestNeighbourQuadrupletInteractionHandler<QuadrupletPotential, float, NDIM>;
+
+    auto quadruplet_handler = QuadrupletInteractionHandler {
+        interact::get_published_buffered_four_body_potential<NDIM, flag>(four_body_filepath, buffer_size),
+        n_particles
+    };
+    quadruplet_handler.adjacency_matrix() = adjmat;
+
+    auto i_tslice = std::size_t {0};
+    results.push_back(bench_utils::run_benchmark("NearestNeighbourQuadrupletInteractionHandler", n_particles, [&]() {
+        auto energy = float {};
+        for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+            energy += quadruplet_handler(i_tslice, i_part, worldlines);
+        }
+        i_tslice = (i_tslice + 1) % N_TIMESLICES;
+        bench_utils::do_not_optimize(energy);
+    }));
+
+    auto estimator_pot4b =
+        interact::get_published_buffered_four_body_potential<NDIM, flag>(four_body_filepath, buffer_size);
+    results.push_back(bench_utils::run_benchmark("total_quadruplet_potential_energy_periodic", 1, [&]() {
+        const auto energy = estim::total_quadruplet_potential_energy_periodic(
+            worldlines, estimator_pot4b, minimage_box, quadruplet_cutoff_distance
+        );
+        bench_utils::do_not_optimize(energy);
+    }));
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    const auto arguments = parse_command_line_arguments(argc, argv);
+    if (!arguments) {
+        std::cout << "ERROR: program incorrectly called from command line.\n";
+        print_usage();
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto results = std::vector<bench_utils::BenchmarkResult> {};
+
+    run_potential_benchmarks(*arguments, results);
+    run_simulation_benchmarks(*arguments, results);
+    if (arguments->four_body_filepath) {
+        run_four_body_benchmarks(*arguments->four_body_filepath, results);
+    }
+
+    bench_utils::print_results_table(std::cout, results);
+
+    if (arguments->json_filepath) {
+        const auto [n_particles, minimage_box, lattice_site_positions] =
+            build_hcp_lattice_structure(DENSITY, N_UNIT_CELLS);
+
+        const auto context = std::vector<std::pair<std::string, std::string>> {
+            {"two_body_filepath",   arguments->two_body_filepath.string()  },
+            {"three_body_filepath", arguments->three_body_filepath.string()},
+            {"four_body_filepath",
+             arguments->four_body_filepath ? arguments->four_body_filepath->string() : std::string {}},
+            {"density",             std::to_string(DENSITY)                },
+            {"n_particles",         std::to_string(n_particles)            },
+            {"n_timeslices",        std::to_string(N_TIMESLICES)           },
+            {"seed",                std::to_string(SEED)                   }
+        };
+
+        auto stream = std::ofstream {*arguments->json_filepath};
+        if (!stream.is_open()) {
+            std::cout << "ERROR: unable to open '" << arguments->json_filepath->string() << "' for writing\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        bench_utils::write_results_json(stream, results, context);
+    }
+
+    return 0;
+}
@@ -0,0 +1,444 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <bench_utils.hpp>
+#include <common/thread_pool.hpp>
+#include <common/toml_utils.hpp>
+#include <constants/constants.hpp>
+#include <coordinates/cell_list.hpp>
+#include <coordinates/coordinates.hpp>
+#include <environment/environment.hpp>
+#include <estimators/pimc/centroid.hpp>
+#include <estimators/pimc/centroid_radial_distribution_function.hpp>
+#include <estimators/pimc/primitive_kinetic.hpp>
+#include <estimators/pimc/radial_distribution_function.hpp>
+#include <estimators/pimc/three_body_potential.hpp>
+#include <estimators/pimc/two_body_potential.hpp>
+#include <geometries/lattice_type.hpp>
+#include <interactions/handlers/composite_interaction_handler.hpp>
+#include <interactions/handlers/nearest_neighbour_interaction_handler.hpp>
+#include <mathtools/histogram/histogram.hpp>
+#include <pimc/bisection_multibead_position_move_performer.hpp>
+#include <pimc/centre_of_mass_move.hpp>
+#include <pimc/single_bead_position_move.hpp>
+#include <rng/generator.hpp>
+#include <simulation/phase_timer.hpp>
+#include <tomlplusplus/toml.hpp>
+#include <worldline/worldline.hpp>
+
+#include <helper.cpp>
+
+/*
+    An end-to-end throughput check on a fixed reference system, to catch performance regressions before a
+    new build is deployed.
+
+    The system is described by a TOML file (the bundled `configs/perfcheck.toml` by default). It is run for
+    a fixed number of passes of the same loop as `main.cpp`, from a fixed seed, and the number of moves of
+    each type made per second is reported, along with the cost of each estimator. With `--baseline`, the
+    results are compared against the JSON written by an earlier run with `--json`, and the program fails if
+    any throughput has fallen by more than the tolerance.
+*/
+
+namespace
+{
+
+constexpr auto NDIM = std::size_t {3};
+
+constexpr auto DEFAULT_TOLERANCE = double {0.1};
+
+#if defined(PIMC_SIM_PERFCHECK_DEFAULT_CONFIG)
+constexpr auto DEFAULT_CONFIG_FILEPATH = std::string_view {PIMC_SIM_PERFCHECK_DEFAULT_CONFIG};
+#else
+constexpr auto DEFAULT_CONFIG_FILEPATH = std::string_view {"configs/perfcheck.toml"};
+#endif
+
+struct CommandLineArguments
+{
+    std::filesystem::path two_body_filepath;
+    std::filesystem::path three_body_filepath;
+    std::filesystem::path config_filepath {DEFAULT_CONFIG_FILEPATH};
+    std::optional<std::filesystem::path> baseline_filepath {std::nullopt};
+    std::optional<std::filesystem::path> json_filepath {std::nullopt};
+    double tolerance {DEFAULT_TOLERANCE};
+};
+
+struct PerfcheckConfig
+{
+    std::tuple<std::size_t, std::size_t, std::size_t> n_unit_cells;
+    std::size_t n_timeslices;
+    double density;
+    double temperature;
+    std::uint64_t seed;
+    std::size_t n_warmup_passes;
+    std::size_t n_passes;
+    double centre_of_mass_step_size;
+    std::size_t bisection_level;
+    double bisection_ratio;
+};
+
+void print_usage()
+{
+    std::cout << "pimc-sim-perfcheck two_body_filepath three_body_filepath ";
+    std::cout << "[--config path] [--baseline path] [--tolerance fraction] [--json path]\n";
+}
+
+auto parse_command_line_arguments(int argc, char** argv) -> std::optional<CommandLineArguments>
+{
+    if (argc < 3) {
+        return std::nullopt;
+    }
+
+    auto arguments = CommandLineArguments {argv[1], argv[2]};
+
+    for (int i_arg {3}; i_arg < argc; i_arg += 2) {
+        const auto option = std::string_view {argv[i_arg]};
+        if (i_arg + 1 >= argc) {
+            return std::nullopt;
+        }
+
+        if (option == "--config") {
+            arguments.config_filepath = argv[i_arg + 1];
+        }
+        else if (option == "--baseline") {
+            arguments.baseline_filepath = argv[i_arg + 1];
+        }
+        else if (option == "--json") {
+            arguments.json_filepath = argv[i_arg + 1];
+        }
+        else if (option == "--tolerance") {
+            try {
+                arguments.tolerance = std::stod(argv[i_arg + 1]);
+            }
+            catch (const std::exception&) {
+                return std::nullopt;
+            }
+
+            if (arguments.tolerance < 0.0) {
+                return std::nullopt;
+            }
+        }
+        else {
+            return std::nullopt;
+        }
+    }
+
+    return arguments;
+}
+
+auto parse_perfcheck_config(const std::filesystem::path& filepath) -> PerfcheckConfig
+{
+    using common::io::cast_toml_to;
+
+    const auto table = toml::parse_file(filepath.string());
+
+    auto config = PerfcheckConfig {};
+    std::get<0>(config.n_unit_cells) = cast_toml_to<std::size_t>(table, "n_cells_dim0");
+    std::get<1>(config.n_unit_cells) = cast_toml_to<std::size_t>(table, "n_cells_dim1");
+    std::get<2>(config.n_unit_cells) = cast_toml_to<std::size_t>(table, "n_cells_dim2");
+    config.n_timeslices = cast_toml_to<std::size_t>(table, "n_timeslices");
+    config.density = cast_toml_to<double>(table, "density");
+    config.temperature = cast_toml_to<double>(table, "temperature");
+    config.seed = static_cast<std::uint64_t>(cast_toml_to<std::int64_t>(table, "seed"));
+    config.n_warmup_passes = cast_toml_to<std::size_t>(table, "n_warmup_passes");
+    config.n_passes = cast_toml_to<std::size_t>(table, "n_passes");
+    config.centre_of_mass_step_size = cast_toml_to<double>(table, "centre_of_mass_step_size");
+    config.bisection_level = cast_toml_to<std::size_t>(table, "bisection_level");
+    config.bisection_ratio = cast_toml_to<double>(table, "bisection_ratio");
+
+    if (config.n_passes == 0) {
+        throw std::runtime_error {"ERROR: 'n_passes' must be a positive integer."};
+    }
+
+    return config;
+}
+
+// the result for a move type, timed over the whole run rather than calibrated like the other benchmarks
+auto move_result(
+    std::string name,
+    std::size_t n_moves_per_pass,
+    std::size_t n_passes,
+    double seconds,
+    std::size_t n_allocations
+) -> bench_utils::BenchmarkResult
+{
+    const auto ns_per_pass = 1.0e9 * seconds / static_cast<double>(n_passes);
+    const auto moves_per_second = static_cast<double>(n_moves_per_pass * n_passes) / seconds;
+    const auto allocations_per_pass = static_cast<double>(n_allocations) / static_cast<double>(n_passes);
+
+    return {std::move(name), n_moves_per_pass, n_passes, ns_per_pass, moves_per_second, allocations_per_pass};
+}
+
+auto run_perfcheck(const CommandLineArguments& arguments, const PerfcheckConfig& config)
+    -> std::vector<bench_utils::BenchmarkResult>
+{
+    const auto n_timeslices = config.n_timeslices;
+
+    const auto [n_particles, minimage_box, lattice_site_positions] =
+        build_hcp_lattice_structure(config.density, config.n_unit_cells);
+
+    const auto periodic_distance_calculator = coord::PeriodicDistanceMeasureWrapper<double, NDIM> {minimage_box};
+    const auto periodic_distance_squared_calculator =
+        coord::PeriodicDistanceSquaredMeasureWrapper<double, NDIM> {minimage_box};
+
+    auto worldlines = worldline::worldlines_from_positions<double, NDIM>(lattice_site_positions, n_timeslices);
+
+    const auto pot = fsh_potential<double>(minimage_box, arguments.two_body_filepath);
+    const auto pot3b = threebodyparah2_potential(minimage_box, arguments.three_body_filepath);
+
+    const auto h2_mass = constants::H2_MASS_IN_AMU<double>;
+    const auto environment = envir::create_environment(config.temperature, h2_mass, n_timeslices, n_particles);
+
+    /* the interaction handler is built the same way as in `main.cpp` */
+    using PairInteractionHandler = interact::NearestNeighbourPairInteractionHandler<decltype(pot), double, NDIM>;
+    using TripletInteractionHandler =
+        interact::NearestNeighbourTripletInteractionHandler<decltype(pot3b), double, NDIM>;
+    using InteractionHandler = interact::
+        CompositeNearestNeighbourInteractionHandler<double, NDIM, PairInteractionHandler, TripletInteractionHandler>;
+
+    auto interaction_handler = InteractionHandler {
+        PairInteractionHandler {pot, n_particles},
+        TripletInteractionHandler {pot3b, n_particles}
+    };
+
+    const auto lattice_constant = geom::density_to_lattice_constant(config.density, geom::LatticeType::HCP);
+    const auto pair_cutoff_distance = 2.2 * lattice_constant;
+    const auto triplet_cutoff_distance = 1.1 * lattice_constant;
+
+    interact::update_centroid_adjacency_matrix<double, NDIM>(
+        worldlines,
+        periodic_distance_squared_calculator,
+        interaction_handler.adjacency_matrix<0>(),
+        pair_cutoff_distance
+    );
+    interact::update_centroid_adjacency_matrix<double, NDIM>(
+        worldlines,
+        periodic_distance_squared_calculator,
+        interaction_handler.adjacency_matrix<1>(),
+        triplet_cutoff_distance
+    );
+
+    auto prngw = rng::RandomNumberGeneratorWrapper<std::mt19937>::from_uint64(config.seed);
+
+    auto com_mover = pimc::CentreOfMassMovePerformer<double, NDIM> {n_timeslices, config.centre_of_mass_step_size};
+    auto single_bead_mover = pimc::SingleBeadPositionMovePerformer<double, NDIM> {n_timeslices};
+    auto multi_bead_mover = pimc::BisectionMultibeadPositionMovePerformer<double, NDIM> {
+        pimc::BisectionLevelMoveInfo {config.bisection_ratio, config.bisection_level}
+    };
+
+    /* the passes, timed per move type with the same phases as the simulation's timing breakdown */
+    using Phase = sim::SimulationPhase;
+    auto phase_timer = sim::PhaseTimer<true> {};
+    auto n_move_allocations = std::array<std::size_t, 3> {};
+
+    const auto run_phase = [&](Phase phase, std::size_t i_move_type, auto&& moves) {
+        const auto n_allocations_before = bench_utils::n_allocations();
+        {
+            const auto scope = phase_timer.scope(phase);
+            moves();
+        }
+        n_move_allocations[i_move_type] += bench_utils::n_allocations() - n_allocations_before;
+    };
+
+    const auto run_pass = [&]() {
+        for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+            run_phase(Phase::CENTRE_OF_MASS_MOVES, 0, [&]() {
+                com_mover(i_part, worldlines, prngw, interaction_handler, environment);
+            });
+
+            run_phase(Phase::SINGLE_BEAD_MOVES, 1, [&]() {
+                for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+                    single_bead_mover(i_part, i_tslice, worldlines, prngw, interaction_handler, environment);
+                }
+            });
+
+            run_phase(Phase::BISECTION_MOVES, 2, [&]() {
+                for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+                    multi_bead_mover(i_part, i_tslice, worldlines, prngw, interaction_handler, environment);
+                }
+            });
+        }
+    };
+
+    for (std::size_t i_pass {0}; i_pass < config.n_warmup_passes; ++i_pass) {
+        run_pass();
+    }
+
+    phase_timer.reset();
+    n_move_allocations.fill(0);
+
+    for (std::size_t i_pass {0}; i_pass < config.n_passes; ++i_pass) {
+        run_pass();
+    }
+
+    auto results = std::vector<bench_utils::BenchmarkResult> {};
+
+    const auto add_move_result = [&](std::string name, Phase phase, std::size_t i_move_type, std::size_t n_moves) {
+        const auto seconds = phase_timer.seconds(phase);
+        const auto n_allocations = n_move_allocations[i_move_type];
+        results.push_back(move_result(std::move(name), n_moves, config.n_passes, seconds, n_allocations));
+    };
+
+    const auto n_bead_moves_per_pass = n_particles * n_timeslices;
+    add_move_result("centre_of_mass_moves", Phase::CENTRE_OF_MASS_MOVES, 0, n_particles);
+    add_move_result("single_bead_moves", Phase::SINGLE_BEAD_MOVES, 1, n_bead_moves_per_pass);
+    add_move_result("bisection_moves", Phase::BISECTION_MOVES, 2, n_bead_moves_per_pass);
+
+    /* the estimators, on the worldlines left by the passes; each operation is one call, as made per block */
+    const auto box_cutoff_distance = coord::box_cutoff_distance(minimage_box);
+    auto radial_dist_histo = mathtools::Histogram<double> {0.0, box_cutoff_distance, 1024};
+    auto centroid_dist_histo = mathtools::Histogram<double> {0.0, box_cutoff_distance, 1024};
+
+    // the same single estimator thread that `main.cpp` uses by default
+    auto estimator_pool = common::ThreadPool {1};
+
+    // the cell list only prunes in a box this small with a cutoff shorter than that of the triplet handler
+    const auto cell_list_cutoff_distance =
+        std::min(triplet_cutoff_distance, coord::longest_pruning_cell_list_cutoff_distance(minimage_box));
+
+    const auto benchmark_estimator = [&](std::string name, auto&& estimator) {
+        results.push_back(bench_utils::run_benchmark(std::move(name), 1, [&]() {
+            bench_utils::do_not_optimize(estimator());
+        }));
+    };
+
+    benchmark_estimator("total_primitive_kinetic_energy", [&]() {
+        return estim::total_primitive_kinetic_energy(worldlines, environment);
+    });
+    benchmark_estimator("total_pair_potential_energy_periodic", [&]() {
+        return estim::total_pair_potential_energy_periodic(worldlines, pot);
+    });
+    benchmark_estimator("total_triplet_potential_energy_periodic", [&]() {
+        const auto& point_pot = interaction_handler.get<1>().point_potential();
+        return estim::total_triplet_potential_energy_periodic(worldlines, point_pot, estimator_pool);
+    });
+    benchmark_estimator("total_triplet_potential_energy_periodic_adjacency_matrix", [&]() {
+        const auto& point_pot = interaction_handler.get<1>().point_potential();
+        const auto& adjmat = interaction_handler.adjacency_matrix<1>();
+        return estim::total_triplet_potential_energy_periodic(worldlines, point_pot, adjmat, estimator_pool);
+    });
+    benchmark_estimator("total_triplet_potential_energy_periodic_cell_list", [&]() {
+        const auto& point_pot = interaction_handler.get<1>().point_potential();
+        return estim::total_triplet_potential_energy_periodic(
+            worldlines, point_pot, minimage_box, cell_list_cutoff_distance, estimator_pool
+        );
+    });
+    benchmark_estimator("rms_centroid_distance", [&]() { return estim::rms_centroid_distance(worldlines); });
+    benchmark_estimator("absolute_centroid_distance", [&]() { return estim::absolute_centroid_distance(worldlines); });
+    benchmark_estimator("update_radial_distribution_function_histogram", [&]() {
+        estim::update_radial_distribution_function_histogram(
+            radial_dist_histo, periodic_distance_calculator, worldlines
+        );
+        return radial_dist_histo.bins().size();
+    });
+    benchmark_estimator("update_centroid_radial_distribution_function_histogram", [&]() {
+        estim::update_centroid_radial_distribution_function_histogram(
+            centroid_dist_histo, periodic_distance_calculator, worldlines
+        );
+        return centroid_dist_histo.bins().size();
+    });
+
+    return results;
+}
+
+}  // namespace
+
+auto main(int argc, char** argv) -> int
+{
+    const auto arguments = parse_command_line_arguments(argc, argv);
+    if (!arguments) {
+        std::cout << "ERROR: program incorrectly called from command line.\n";
+        print_usage();
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto config = PerfcheckConfig {};
+    try {
+        config = parse_perfcheck_config(arguments->config_filepath);
+    }
+    catch (const toml::parse_error& err) {
+        std::cout << "ERROR: unable to parse '" << arguments->config_filepath.string() << "'\n" << err << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+    catch (const std::runtime_error& err) {
+        std::cout << "ERROR: unable to parse '" << arguments->config_filepath.string() << "'\n" << err.what() << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto results = run_perfcheck(*arguments, config);
+
+    bench_utils::print_results_table(std::cout, results);
+
+    if (arguments->json_filepath) {
+        const auto [n_cells0, n_cells1, n_cells2] = config.n_unit_cells;
+        auto n_unit_cells = std::to_string(n_cells0);
+        n_unit_cells += 'x';
+        n_unit_cells += std::to_string(n_cells1);
+        n_unit_cells += 'x';
+        n_unit_cells += std::to_string(n_cells2);
+
+        const auto context = std::vector<std::pair<std::string, std::string>> {
+            {"config_filepath",     arguments->config_filepath.string()    },
+            {"two_body_filepath",   arguments->two_body_filepath.string()  },
+            {"three_body_filepath", arguments->three_body_filepath.string()},
+            {"n_unit_cells",        n_unit_cells                           },
+            {"n_timeslices",        std::to_string(config.n_timeslices)    },
+            {"n_passes",            std::to_string(config.n_passes)        },
+            {"seed",                std::to_string(config.seed)            }
+        };
+
+        auto stream = std::ofstream {*arguments->json_filepath};
+        if (!stream.is_open()) {
+            std::cout << "ERROR: unable to open '" << arguments->json_filepath->string() << "' for writing\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        bench_utils::write_results_json(stream, results, context);
+    }
+
+    if (arguments->baseline_filepath) {
+        auto stream = std::ifstream {*arguments->baseline_filepath};
+        if (!stream.is_open()) {
+            std::cout << "ERROR: unable to open '" << arguments->baseline_filepath->string() << "' for reading\n";
+            std::exit(EXIT_FAILURE);
+        }
+
+        const auto baseline = bench_utils::read_results_json(stream);
+        const auto comparisons = bench_utils::compare_to_baseline(results, baseline, arguments->tolerance);
+
+        std::cout << '\n';
+        bench_utils::print_baseline_comparison(std::cout, comparisons);
+
+        if (comparisons.size() != results.size()) {
+            std::cout << "NOTE: " << results.size() - comparisons.size() << " results have no baseline\n";
+        }
+
+        auto n_regressions = std::size_t {0};
+        for (const auto& comparison : comparisons) {
+            n_regressions += comparison.is_regression ? 1 : 0;
+        }
+
+        if (n_regressions != 0) {
+            std::cout << "FAILED: " << n_regressions << " results are more than ";
+            std::cout << std::fixed << std::setprecision(1) << 100.0 * arguments->tolerance;
+            std::cout << "% slower than the baseline\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    return 0;
+}
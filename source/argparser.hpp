@@ -10,9 +10,13 @@
 #include <string>
 #include <string_view>
 #include <tuple>
+#include <utility>
 #include <variant>
+#include <vector>
 
+#include <estimators/pimc/triplet_estimator_method.hpp>
 #include <rng/prng_state.hpp>
+#include <worldline/writers/worldline_file_format.hpp>
 
 #include <common/toml_utils.hpp>
 #include <tomlplusplus/toml.hpp>
@@ -97,6 +101,14 @@ public:
     std::filesystem::path abs_four_body_filepath {};
     std::variant<rng::RandomSeedFlag, std::uint64_t> initial_seed_state;
     bool freeze_monte_carlo_step_sizes_in_equilibrium {false};
+    std::size_t n_estimator_threads {1};
+    estim::TripletEstimatorMethod triplet_estimator_method {estim::TripletEstimatorMethod::ALL_TRIPLETS};
+    std::optional<FP> triplet_estimator_cutoff {std::nullopt};
+    worldline::WorldlineFileFormat worldline_file_format {worldline::WorldlineFileFormat::TEXT};
+    bool record_hardware_counters {false};
+    std::optional<std::pair<std::size_t, std::size_t>> traced_block_indices {std::nullopt};
+    std::vector<std::pair<std::string, FP>> target_relative_errors {};
+    std::optional<FP> wall_clock_budget_seconds {std::nullopt};
 
 private:
     bool parse_success_flag_ {};
@@ -137,6 +149,13 @@ private:
             freeze_monte_carlo_step_sizes_in_equilibrium = cast_toml_to<bool>(table, "freeze_monte_carlo_step_sizes_in_equilibrium");
 
             parse_seed_(table);
+            parse_n_estimator_threads_(table);
+            parse_triplet_estimator_method_(table);
+            parse_worldline_file_format_(table);
+            parse_record_hardware_counters_(table);
+            parse_traced_block_indices_(table);
+            parse_target_relative_errors_(table);
+            parse_wall_clock_budget_seconds_(table);
 
             parse_success_flag_ = true;
         }
@@ -150,6 +169,146 @@ private:
         }
     }
 
+    // the estimators run on a single thread unless told otherwise
+    void parse_n_estimator_threads_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("n_estimator_threads")) {
+            return;
+        }
+
+        n_estimator_threads = cast_toml_to<std::size_t>(table, "n_estimator_threads");
+        if (n_estimator_threads == 0) {
+            throw std::runtime_error {"ERROR: 'n_estimator_threads' must be a positive integer."};
+        }
+    }
+
+    // the triplet estimator visits every triplet unless told otherwise
+    void parse_triplet_estimator_method_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("triplet_estimator")) {
+            return;
+        }
+
+        const auto method = cast_toml_to<std::string>(table, "triplet_estimator");
+        triplet_estimator_method = estim::map_triplet_estimator_method(method);
+
+        // the cell list truncates the three-body interaction, so the distance it truncates at must be chosen
+        if (triplet_estimator_method != estim::TripletEstimatorMethod::CELL_LIST) {
+            return;
+        }
+
+        if (!table.contains("triplet_estimator_cutoff")) {
+            throw std::runtime_error {
+                "ERROR: 'triplet_estimator_cutoff' must be given if the 'triplet_estimator' is \"cell_list\"."
+            };
+        }
+
+        triplet_estimator_cutoff = cast_toml_to<FP>(table, "triplet_estimator_cutoff");
+        if (*triplet_estimator_cutoff <= FP {0.0}) {
+            throw std::runtime_error {"ERROR: 'triplet_estimator_cutoff' must be a positive number."};
+        }
+    }
+
+    // the hardware performance counters are only opened when asked for
+    void parse_record_hardware_counters_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("record_hardware_counters")) {
+            return;
+        }
+
+        record_hardware_counters = cast_toml_to<bool>(table, "record_hardware_counters");
+    }
+
+    // no blocks are traced unless both ends of the range are given; as with the blocks themselves, the last
+    // index is one past the final block to trace
+    void parse_traced_block_indices_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        const auto has_first = table.contains("first_traced_block_index");
+        const auto has_last = table.contains("last_traced_block_index");
+        if (!has_first && !has_last) {
+            return;
+        }
+
+        if (has_first != has_last) {
+            throw std::runtime_error {
+                "ERROR: 'first_traced_block_index' and 'last_traced_block_index' must be given together."
+            };
+        }
+
+        const auto first = cast_toml_to<std::size_t>(table, "first_traced_block_index");
+        const auto last = cast_toml_to<std::size_t>(table, "last_traced_block_index");
+        if (first >= last) {
+            throw std::runtime_error {
+                "ERROR: 'first_traced_block_index' must be less than 'last_traced_block_index'."
+            };
+        }
+
+        traced_block_indices = std::pair {first, last};
+    }
+
+    // a table from the names of estimators to the relative errors at which the run may stop, like
+    // `target_relative_error = {kinetic = 1.0e-3, pair = 5.0e-4}`; the names are checked by the simulation
+    void parse_target_relative_errors_(const toml::table& table)
+    {
+        if (!table.contains("target_relative_error")) {
+            return;
+        }
+
+        const auto* targets = table["target_relative_error"].as_table();
+        if (targets == nullptr || targets->empty()) {
+            throw std::runtime_error {
+                "ERROR: 'target_relative_error' must be a table of estimator names and relative errors."
+            };
+        }
+
+        for (const auto& [name, node] : *targets) {
+            const auto maybe_target = node.template value<FP>();
+            if (!maybe_target || *maybe_target <= FP {0.0}) {
+                auto err_msg = std::stringstream {};
+                err_msg << "ERROR: the target relative error for '" << name.str() << "' must be a positive number.";
+                throw std::runtime_error {err_msg.str()};
+            }
+
+            target_relative_errors.emplace_back(std::string {name.str()}, *maybe_target);
+        }
+    }
+
+    // the run is only limited by its last block index unless given a budget
+    void parse_wall_clock_budget_seconds_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("wall_clock_budget_seconds")) {
+            return;
+        }
+
+        wall_clock_budget_seconds = cast_toml_to<FP>(table, "wall_clock_budget_seconds");
+        if (*wall_clock_budget_seconds <= FP {0.0}) {
+            throw std::runtime_error {"ERROR: 'wall_clock_budget_seconds' must be a positive number."};
+        }
+    }
+
+    // the worldlines are saved as text files unless told otherwise
+    void parse_worldline_file_format_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("worldline_file_format")) {
+            return;
+        }
+
+        const auto format = cast_toml_to<std::string>(table, "worldline_file_format");
+        worldline_file_format = worldline::map_worldline_file_format(format);
+    }
+
     void parse_seed_(const toml::table& table)
     {
         const auto maybe_uint64t = table["initial_seed"].value<std::uint64_t>();
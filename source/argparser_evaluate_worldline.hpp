@@ -4,6 +4,7 @@
 #include <array>
 #include <concepts>
 #include <filesystem>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -69,6 +70,9 @@ public:
     bool evaluate_two_body {};
     bool evaluate_three_body {};
     bool evaluate_four_body {};
+    std::optional<FP> four_body_cache_tolerance {};
+    std::size_t four_body_cache_capacity {};
+    std::size_t n_evaluation_threads {1};
 
 private:
     bool parse_success_flag_ {};
@@ -94,6 +98,8 @@ private:
             evaluate_two_body = cast_toml_to<bool>(table, "evaluate_two_body");
             evaluate_three_body = cast_toml_to<bool>(table, "evaluate_three_body");
             evaluate_four_body = cast_toml_to<bool>(table, "evaluate_four_body");
+            parse_four_body_cache_(table);
+            parse_n_evaluation_threads_(table);
 
             parse_success_flag_ = true;
         }
@@ -107,6 +113,34 @@ private:
         }
     }
 
+    // the four-body energy cache is optional, and only turned on if a tolerance is given
+    void parse_four_body_cache_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("four_body_cache_tolerance")) {
+            return;
+        }
+
+        four_body_cache_tolerance = cast_toml_to<FP>(table, "four_body_cache_tolerance");
+        four_body_cache_capacity = cast_toml_to<std::size_t>(table, "four_body_cache_capacity");
+    }
+
+    // the snapshots are evaluated one at a time unless more threads are asked for
+    void parse_n_evaluation_threads_(const toml::table& table)
+    {
+        using common::io::cast_toml_to;
+
+        if (!table.contains("n_evaluation_threads")) {
+            return;
+        }
+
+        n_evaluation_threads = cast_toml_to<std::size_t>(table, "n_evaluation_threads");
+        if (n_evaluation_threads == 0) {
+            throw std::runtime_error {"ERROR: 'n_evaluation_threads' must be at least 1."};
+        }
+    }
+
     void parse_block_indices_(const toml::table& table)
     {
         if (auto block_indices_array = table["block_indices"].as_array()) {
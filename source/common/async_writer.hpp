@@ -0,0 +1,157 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace common::writers
+{
+
+/*
+    The AsyncWriterService runs file-writing tasks on a single background thread, so that the simulation
+    loop does not have to wait on the filesystem.
+
+    The tasks are run one at a time, in the order they were submitted; a task that writes a checkpoint can
+    therefore rely on every task submitted before it having finished. Each task should own a snapshot of
+    the data it writes (captured by value, or moved in), so the caller is free to keep changing its own
+    copy as soon as `submit()` returns.
+
+    At most `max_queued_tasks` tasks wait in the queue; `submit()` blocks once the queue is full, which keeps
+    the memory used by the snapshots bounded if the filesystem falls behind.
+
+    `fence()` blocks until every submitted task has finished. If any task throws, the first exception is
+    rethrown on the calling thread by the next call to `submit()` or `fence()`.
+*/
+class AsyncWriterService
+{
+public:
+    explicit AsyncWriterService(std::size_t max_queued_tasks = 64)
+        : max_queued_tasks_ {max_queued_tasks}
+    {
+        ctr_check_max_queued_tasks_positive_(max_queued_tasks_);
+
+        worker_ = std::thread {[this]() { worker_loop_(); }};
+    }
+
+    AsyncWriterService(const AsyncWriterService&) = delete;
+    AsyncWriterService(AsyncWriterService&&) = delete;
+    auto operator=(const AsyncWriterService&) -> AsyncWriterService& = delete;
+    auto operator=(AsyncWriterService&&) -> AsyncWriterService& = delete;
+
+    // the remaining tasks are still run; any exception they throw is lost, so call `fence()` first
+    ~AsyncWriterService()
+    {
+        {
+            const auto lock = std::lock_guard<std::mutex> {mutex_};
+            is_stopping_ = true;
+        }
+        task_available_.notify_one();
+
+        worker_.join();
+    }
+
+    void submit(std::function<void()> task)
+    {
+        auto lock = std::unique_lock<std::mutex> {mutex_};
+        rethrow_if_failed_(lock);
+
+        space_available_.wait(lock, [this]() { return tasks_.size() < max_queued_tasks_; });
+        tasks_.push_back(std::move(task));
+
+        lock.unlock();
+        task_available_.notify_one();
+    }
+
+    void fence()
+    {
+        auto lock = std::unique_lock<std::mutex> {mutex_};
+        all_done_.wait(lock, [this]() { return tasks_.empty() && !is_running_task_; });
+
+        rethrow_if_failed_(lock);
+    }
+
+    constexpr auto max_queued_tasks() const noexcept -> std::size_t
+    {
+        return max_queued_tasks_;
+    }
+
+private:
+    std::size_t max_queued_tasks_;
+
+    std::mutex mutex_ {};
+    std::condition_variable task_available_ {};
+    std::condition_variable space_available_ {};
+    std::condition_variable all_done_ {};
+
+    std::deque<std::function<void()>> tasks_ {};
+    bool is_running_task_ {false};
+    bool is_stopping_ {false};
+    std::exception_ptr exception_ {};
+
+    std::thread worker_ {};
+
+    void rethrow_if_failed_(std::unique_lock<std::mutex>& lock)
+    {
+        if (exception_) {
+            auto exception = std::exchange(exception_, nullptr);
+            lock.unlock();
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void worker_loop_()
+    {
+        while (true) {
+            auto task = std::function<void()> {};
+            {
+                auto lock = std::unique_lock<std::mutex> {mutex_};
+                task_available_.wait(lock, [this]() { return is_stopping_ || !tasks_.empty(); });
+
+                if (tasks_.empty()) {
+                    return;
+                }
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                is_running_task_ = true;
+            }
+            space_available_.notify_one();
+
+            auto exception = std::exception_ptr {};
+            try {
+                task();
+            }
+            catch (...) {
+                exception = std::current_exception();
+            }
+
+            {
+                const auto lock = std::lock_guard<std::mutex> {mutex_};
+                is_running_task_ = false;
+                if (exception && !exception_) {
+                    exception_ = exception;
+                }
+            }
+            all_done_.notify_all();
+        }
+    }
+
+    void ctr_check_max_queued_tasks_positive_(std::size_t max_queued_tasks) const
+    {
+        if (max_queued_tasks == 0) {
+            auto err_msg = std::stringstream {};
+            err_msg << "The AsyncWriterService must be able to queue at least one task.\n";
+            err_msg << "Found: max_queued_tasks = " << max_queued_tasks << '\n';
+            throw std::runtime_error {err_msg.str()};
+        }
+    }
+};
+
+}  // namespace common::writers
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+/*
+    Helpers for the binary files written by the simulation (worldline snapshots, checkpoints); the values
+    are stored with the byte order of the machine that writes them.
+*/
+
+namespace common
+{
+
+namespace io
+{
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void write_binary(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void write_binary(std::ostream& stream, std::span<const T> values)
+{
+    stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+}
+
+/*
+    Reads values one after the other from a block of bytes; reading past the end of the block throws,
+    so a truncated file is reported instead of being read as garbage.
+*/
+class BinaryReader
+{
+public:
+    explicit BinaryReader(std::span<const char> bytes)
+        : bytes_ {bytes}
+    {}
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    auto read() -> T
+    {
+        auto value = T {};
+        std::memcpy(&value, read_bytes(sizeof(T)).data(), sizeof(T));
+
+        return value;
+    }
+
+    auto read_bytes(std::size_t n_bytes) -> std::span<const char>
+    {
+        if (n_bytes > n_remaining()) {
+            auto err_msg = std::stringstream {};
+            err_msg << "ERROR: attempted to read past the end of the binary data.\n";
+            err_msg << "Requested: " << n_bytes << " bytes; remaining: " << n_remaining() << " bytes\n";
+            throw std::runtime_error {err_msg.str()};
+        }
+
+        const auto bytes = bytes_.subspan(offset_, n_bytes);
+        offset_ += n_bytes;
+
+        return bytes;
+    }
+
+    constexpr auto n_remaining() const noexcept -> std::size_t
+    {
+        return bytes_.size() - offset_;
+    }
+
+    constexpr auto offset() const noexcept -> std::size_t
+    {
+        return offset_;
+    }
+
+private:
+    std::span<const char> bytes_;
+    std::size_t offset_ {0};
+};
+
+/*
+    The 64-bit FNV-1a hash of a block of bytes; it is used as a checksum, to detect files that were
+    damaged or only partly written.
+*/
+constexpr auto fnv1a_64(std::span<const char> bytes) noexcept -> std::uint64_t
+{
+    constexpr auto offset_basis = std::uint64_t {0xcbf29ce484222325};
+    constexpr auto prime = std::uint64_t {0x00000100000001b3};
+
+    auto hash = offset_basis;
+    for (const auto byte : bytes) {
+        hash ^= static_cast<std::uint8_t>(byte);
+        hash *= prime;
+    }
+
+    return hash;
+}
+
+}  // namespace io
+
+}  // namespace common
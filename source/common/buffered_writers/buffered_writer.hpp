@@ -2,16 +2,22 @@
 
 #include <array>
 #include <concepts>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <ios>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <common/common_utils.hpp>
+#include <common/durable_io.hpp>
 #include <common/io_utils.hpp>
+#include <common/memory_usage.hpp>
 #include <common/writer_utils.hpp>
 
 #include <common/buffered_writers/format_info.hpp>
@@ -82,16 +88,30 @@ public:
     }
 
     void write_and_clear(std::ostream& out_stream, const cw::FormatInfo<NumValues>& format_info)
+    {
+        write(out_stream, buffered_data_, format_info);
+
+        buffered_data_.clear();
+    }
+
+    void write(
+        std::ostream& out_stream,
+        const std::vector<Data>& data_lines,
+        const cw::FormatInfo<NumValues>& format_info
+    ) const
     {
         auto lines_stream = std::stringstream {};
 
-        for (const auto& data : buffered_data_) {
+        for (const auto& data : data_lines) {
             lines_stream << formatted_line_(data, format_info);
         }
 
         out_stream << lines_stream.str();
+    }
 
-        buffered_data_.clear();
+    auto take_buffer() -> std::vector<Data>
+    {
+        return std::exchange(buffered_data_, std::vector<Data> {});
     }
 
     auto is_buffer_empty() const noexcept -> bool
@@ -99,6 +119,11 @@ public:
         return buffered_data_.empty();
     }
 
+    auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::vector_memory_usage(buffered_data_);
+    }
+
 private:
     std::vector<Data> buffered_data_ {};
 
@@ -121,6 +146,15 @@ private:
 namespace common::writers
 {
 
+/*
+    The BlockValueWriter appends lines of values, one per block, to a text file.
+
+    Each call to `write_and_clear()` only appends the new lines to the file, so it costs O(new data) no matter
+    how large the file has grown. To keep the file safe from crashes, the number of bytes that are known to
+    be complete is kept in a small sidecar file (the "committed length"), which is only updated after the
+    new lines are synced to disk. If the program is stopped partway through an append, the next writer for
+    that file truncates the incomplete lines away before appending anything.
+*/
 template <common::Numeric... Number>
 class BlockValueWriter
 {
@@ -148,23 +182,43 @@ public:
 
     void write_and_clear()
     {
-        if (stream_writer_.is_buffer_empty()) {
+        write_data(stream_writer_.take_buffer());
+    }
+
+    /*
+        Remove the accumulated data from the writer and hand it to the caller, to be passed to `write_data()`
+        later; this is how the data is written from a different thread (see `AsyncWriterService`) while
+        new data keeps being accumulated. `accumulate()` and `take_buffered_data()` only touch the buffer,
+        and `write_data()` only touches the file, so the two sides may be used from different threads.
+    */
+    auto take_buffered_data() -> std::vector<Data>
+    {
+        return stream_writer_.take_buffer();
+    }
+
+    void write_data(const std::vector<Data>& data_lines)
+    {
+        if (data_lines.empty()) {
             return;
         }
 
-        // performs an atomic write of the new data
         namespace fs = std::filesystem;
 
-        auto temp_filepath = filepath_;
-        temp_filepath += common::writers::DEFAULT_TEMPORARY_SUFFIX;
-
         if (!fs::exists(filepath_)) {
             write_first_();
         }
+        else if (!committed_length_) {
+            committed_length_ = recover_committed_length_();
+        }
+
+        auto lines_stream = std::stringstream {};
+        stream_writer_.write(lines_stream, data_lines, format_info_);
+        const auto lines = lines_stream.str();
+
+        common::io::append_durably(filepath_, lines);
 
-        fs::copy_file(filepath_, temp_filepath, fs::copy_options::overwrite_existing);
-        write_and_clear_(temp_filepath);
-        fs::rename(temp_filepath, filepath_);
+        *committed_length_ += lines.size();
+        write_committed_length_();
     }
 
     void write_nonatomic()
@@ -176,6 +230,16 @@ public:
         }
 
         write_and_clear_(filepath_);
+
+        // the file no longer matches the committed length; the whole file is trusted on the next atomic write
+        committed_length_ = std::nullopt;
+        fs::remove(committed_length_filepath_());
+    }
+
+    // the lines accumulated since the last write, and the header
+    auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return stream_writer_.memory_usage() + common::MemoryUsage {header_contents_.capacity(), 0};
     }
 
 private:
@@ -183,6 +247,7 @@ private:
     std::string header_contents_;
     FormatInfo<NumValues> format_info_;
     impl_block_value_writer::BufferedStreamValueWriter<Number...> stream_writer_;
+    std::optional<std::uintmax_t> committed_length_ {};
 
     void write_and_clear_(const std::filesystem::path& filepath)
     {
@@ -190,10 +255,54 @@ private:
         stream_writer_.write_and_clear(out_stream, format_info_);
     }
 
-    void write_first_() const
+    void write_first_()
+    {
+        common::io::replace_durably(filepath_, header_contents_);
+
+        committed_length_ = header_contents_.size();
+        write_committed_length_();
+    }
+
+    auto committed_length_filepath_() const -> std::filesystem::path
+    {
+        auto committed_length_filepath = filepath_;
+        committed_length_filepath += common::writers::DEFAULT_COMMITTED_LENGTH_SUFFIX;
+
+        return committed_length_filepath;
+    }
+
+    void write_committed_length_() const
     {
-        auto out_stream = common::io::open_output_filestream_checked(filepath_);
-        out_stream << header_contents_;
+        common::io::replace_durably(committed_length_filepath_(), std::to_string(*committed_length_) + '\n');
+    }
+
+    /*
+        Find how much of an existing file is complete, and cut off anything past that point. Files without a
+        committed length (for example, those written before the committed length was introduced) are
+        trusted in their entirety.
+    */
+    auto recover_committed_length_() const -> std::uintmax_t
+    {
+        namespace fs = std::filesystem;
+
+        const auto file_size = fs::file_size(filepath_);
+        const auto committed_length_filepath = committed_length_filepath_();
+
+        if (!fs::exists(committed_length_filepath)) {
+            return file_size;
+        }
+
+        auto in_stream = common::io::open_input_filestream_checked(committed_length_filepath);
+        auto committed_length = std::uintmax_t {};
+        if (!(in_stream >> committed_length) || committed_length > file_size) {
+            return file_size;
+        }
+
+        if (committed_length < file_size) {
+            fs::resize_file(filepath_, committed_length);
+        }
+
+        return committed_length;
     }
 };
 
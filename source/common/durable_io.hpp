@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <ios>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <common/writer_utils.hpp>
+
+/*
+    Low-level file operations that make sure the data has reached the disk before they return, so that the
+    files they write survive a crash (or a job being killed) at any point.
+*/
+
+namespace impl_common
+{
+
+inline void throw_io_failure_(std::string_view action, const std::filesystem::path& filepath)
+{
+    auto err_msg = std::stringstream {};
+    err_msg << "Failed to " << action << ": " << filepath.string() << '\n';
+    err_msg << "Reason: " << std::strerror(errno) << '\n';
+    throw std::ios_base::failure {err_msg.str()};
+}
+
+class FileDescriptor
+{
+public:
+    FileDescriptor(const std::filesystem::path& filepath, int flags)
+        : fd_ {::open(filepath.c_str(), flags, 0644)}
+    {
+        if (fd_ < 0) {
+            throw_io_failure_("open file", filepath);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    auto operator=(const FileDescriptor&) -> FileDescriptor& = delete;
+
+    ~FileDescriptor()
+    {
+        ::close(fd_);
+    }
+
+    constexpr auto get() const noexcept -> int
+    {
+        return fd_;
+    }
+
+private:
+    int fd_;
+};
+
+inline void write_all_(const FileDescriptor& file, std::string_view data, const std::filesystem::path& filepath)
+{
+    while (!data.empty()) {
+        const auto n_written = ::write(file.get(), data.data(), data.size());
+        if (n_written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_io_failure_("write to file", filepath);
+        }
+
+        data.remove_prefix(static_cast<std::size_t>(n_written));
+    }
+}
+
+}  // namespace impl_common
+
+namespace common
+{
+
+namespace io
+{
+
+/*
+    Append `data` to the end of the file (creating it if needed), and wait until it is on the disk.
+*/
+inline void append_durably(const std::filesystem::path& filepath, std::string_view data)
+{
+    const auto file = impl_common::FileDescriptor {filepath, O_WRONLY | O_APPEND | O_CREAT};
+    impl_common::write_all_(file, data, filepath);
+
+    if (::fdatasync(file.get()) != 0) {
+        impl_common::throw_io_failure_("sync file", filepath);
+    }
+}
+
+/*
+    Replace the contents of the file with `contents`; the new contents are written to a temporary file,
+    synced, and renamed over the original, so the file holds either the old or the new contents, even if
+    the program stops halfway through.
+*/
+inline void replace_durably(const std::filesystem::path& filepath, std::string_view contents)
+{
+    auto temp_filepath = filepath;
+    temp_filepath += common::writers::DEFAULT_TEMPORARY_SUFFIX;
+
+    {
+        const auto file = impl_common::FileDescriptor {temp_filepath, O_WRONLY | O_CREAT | O_TRUNC};
+        impl_common::write_all_(file, contents, temp_filepath);
+
+        if (::fdatasync(file.get()) != 0) {
+            impl_common::throw_io_failure_("sync file", temp_filepath);
+        }
+    }
+
+    std::filesystem::rename(temp_filepath, filepath);
+
+    // the rename itself is only durable once the directory holding the file is synced
+    auto dirpath = filepath.parent_path();
+    if (dirpath.empty()) {
+        dirpath = ".";
+    }
+
+    const auto directory = impl_common::FileDescriptor {dirpath, O_RDONLY | O_DIRECTORY};
+    if (::fsync(directory.get()) != 0) {
+        impl_common::throw_io_failure_("sync directory", dirpath);
+    }
+}
+
+}  // namespace io
+
+}  // namespace common
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <ios>
+#include <span>
+#include <sstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace common
+{
+
+namespace io
+{
+
+/*
+    Read-only memory map of an entire file; the mapping is released when the instance is destroyed.
+*/
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& filepath)
+    {
+        const auto fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            auto err_msg = std::stringstream {};
+            err_msg << "Error: Unable to open file: '" << filepath << "'\n";
+            throw std::ios_base::failure {err_msg.str()};
+        }
+
+        struct stat file_status {};
+        if (::fstat(fd, &file_status) != 0 || file_status.st_size <= 0) {
+            ::close(fd);
+            auto err_msg = std::stringstream {};
+            err_msg << "Error: Unable to map empty or unreadable file: '" << filepath << "'\n";
+            throw std::ios_base::failure {err_msg.str()};
+        }
+
+        n_bytes_ = static_cast<std::size_t>(file_status.st_size);
+        mapped_ = ::mmap(nullptr, n_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (mapped_ == MAP_FAILED) {
+            mapped_ = nullptr;
+            auto err_msg = std::stringstream {};
+            err_msg << "Error: Unable to memory-map file: '" << filepath << "'\n";
+            throw std::ios_base::failure {err_msg.str()};
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : mapped_ {std::exchange(other.mapped_, nullptr)}
+        , n_bytes_ {std::exchange(other.n_bytes_, 0)}
+    {}
+
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&
+    {
+        std::swap(mapped_, other.mapped_);
+        std::swap(n_bytes_, other.n_bytes_);
+
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        if (mapped_ != nullptr) {
+            ::munmap(mapped_, n_bytes_);
+        }
+    }
+
+    auto bytes() const noexcept -> std::span<const char>
+    {
+        return {static_cast<const char*>(mapped_), n_bytes_};
+    }
+
+private:
+    void* mapped_ {nullptr};
+    std::size_t n_bytes_ {0};
+};
+
+}  // namespace io
+
+}  // namespace common
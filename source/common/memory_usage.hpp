@@ -0,0 +1,65 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <vector>
+
+/*
+    The heap memory held by an object, for planning how many simulations fit on a node.
+
+    Classes that hold a noticeable amount of memory provide a `memory_usage()` member function; wrappers
+    forward to the objects they hold through the free function `common::memory_usage()`, which gives zero
+    for types that don't track their memory (like an analytic potential with no tables).
+
+    Memory that is shared with other processes (such as a potential table in a shared mapping) is counted
+    separately, since it is only paid for once per node.
+*/
+
+namespace common
+{
+
+struct MemoryUsage
+{
+    std::size_t owned_bytes {};
+    std::size_t shared_bytes {};
+
+    constexpr auto operator+=(const MemoryUsage& other) noexcept -> MemoryUsage&
+    {
+        owned_bytes += other.owned_bytes;
+        shared_bytes += other.shared_bytes;
+        return *this;
+    }
+
+    friend constexpr auto operator+(MemoryUsage lhs, const MemoryUsage& rhs) noexcept -> MemoryUsage
+    {
+        lhs += rhs;
+        return lhs;
+    }
+
+    friend constexpr auto operator==(const MemoryUsage&, const MemoryUsage&) noexcept -> bool = default;
+};
+
+template <typename T>
+concept TracksMemoryUsage = requires(const T& object) {
+    { object.memory_usage() } -> std::same_as<MemoryUsage>;
+};
+
+template <typename T>
+constexpr auto memory_usage(const T& object) noexcept -> MemoryUsage
+{
+    if constexpr (TracksMemoryUsage<T>) {
+        return object.memory_usage();
+    }
+    else {
+        return MemoryUsage {};
+    }
+}
+
+// the buffer of a vector, including any capacity past its size
+template <typename T, typename Allocator>
+constexpr auto vector_memory_usage(const std::vector<T, Allocator>& values) noexcept -> MemoryUsage
+{
+    return MemoryUsage {values.capacity() * sizeof(T), 0};
+}
+
+}  // namespace common
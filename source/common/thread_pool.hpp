@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace common
+{
+
+/*
+    The ThreadPool keeps a fixed set of worker threads alive, so that parallel loops that run every
+    block (such as the estimators) do not pay for creating and joining threads each time.
+
+    The calling thread takes part in the work, so a pool with `n_threads` threads only creates
+    `n_threads - 1` workers; a pool with a single thread runs everything on the calling thread.
+
+    `parallel_for()` hands out the items dynamically, so the order in which the items are processed is
+    not fixed; callers that need reproducible results should write the result of each item into its own
+    slot, and combine the slots afterwards in a fixed order (see `parallel_ordered_sum()` below).
+*/
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t n_threads = 1)
+        : n_threads_ {n_threads == 0 ? std::size_t {1} : n_threads}
+    {
+        workers_.reserve(n_threads_ - 1);
+        for (std::size_t i {1}; i < n_threads_; ++i) {
+            workers_.emplace_back([this, i]() { worker_loop_(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+    auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+    ~ThreadPool()
+    {
+        {
+            const auto lock = std::lock_guard<std::mutex> {mutex_};
+            is_stopping_ = true;
+        }
+        work_ready_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    /*
+        Call `function(i_item)` for every `i_item` in [0, n_items), spread over the threads of the pool,
+        and return once every call has finished. If any of the calls throws, the first exception caught
+        is rethrown on the calling thread.
+    */
+    template <typename Function>
+    void parallel_for(std::size_t n_items, Function&& function)
+    {
+        parallel_for_with_thread_index(n_items, [&function](std::size_t i_item, std::size_t) { function(i_item); });
+    }
+
+    /*
+        Like `parallel_for()`, but calls `function(i_item, i_thread)`, where `i_thread` in [0, n_threads)
+        identifies the thread making the call. Calls with the same `i_thread` never overlap, so each thread
+        can be given its own copy of any state that cannot be shared (such as a buffered potential).
+    */
+    template <typename Function>
+    void parallel_for_with_thread_index(std::size_t n_items, Function&& function)
+    {
+        if (workers_.empty() || n_items < 2) {
+            for (std::size_t i_item {0}; i_item < n_items; ++i_item) {
+                function(i_item, std::size_t {0});
+            }
+            return;
+        }
+
+        {
+            const auto lock = std::lock_guard<std::mutex> {mutex_};
+            task_ = [&function](std::size_t i_item, std::size_t i_thread) { function(i_item, i_thread); };
+            n_items_ = n_items;
+            next_item_.store(0);
+            n_busy_workers_ = workers_.size();
+            exception_ = nullptr;
+            ++generation_;
+        }
+        work_ready_.notify_all();
+
+        run_items_(0);
+
+        auto lock = std::unique_lock<std::mutex> {mutex_};
+        work_done_.wait(lock, [this]() { return n_busy_workers_ == 0; });
+        task_ = nullptr;
+
+        if (exception_) {
+            std::rethrow_exception(std::exchange(exception_, nullptr));
+        }
+    }
+
+    constexpr auto n_threads() const noexcept -> std::size_t
+    {
+        return n_threads_;
+    }
+
+private:
+    std::size_t n_threads_;
+    std::vector<std::thread> workers_ {};
+
+    std::mutex mutex_ {};
+    std::condition_variable work_ready_ {};
+    std::condition_variable work_done_ {};
+
+    std::function<void(std::size_t, std::size_t)> task_ {};
+    std::size_t n_items_ {0};
+    std::atomic<std::size_t> next_item_ {0};
+    std::size_t n_busy_workers_ {0};
+    std::size_t generation_ {0};
+    bool is_stopping_ {false};
+    std::exception_ptr exception_ {};
+
+    void run_items_(std::size_t i_thread)
+    {
+        for (auto i_item = next_item_.fetch_add(1); i_item < n_items_; i_item = next_item_.fetch_add(1)) {
+            try {
+                task_(i_item, i_thread);
+            }
+            catch (...) {
+                const auto lock = std::lock_guard<std::mutex> {mutex_};
+                if (!exception_) {
+                    exception_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void worker_loop_(std::size_t i_thread)
+    {
+        auto seen_generation = std::size_t {0};
+
+        while (true) {
+            {
+                auto lock = std::unique_lock<std::mutex> {mutex_};
+                work_ready_.wait(lock, [&]() { return is_stopping_ || generation_ != seen_generation; });
+
+                if (is_stopping_) {
+                    return;
+                }
+
+                seen_generation = generation_;
+            }
+
+            run_items_(i_thread);
+
+            {
+                const auto lock = std::lock_guard<std::mutex> {mutex_};
+                --n_busy_workers_;
+            }
+            work_done_.notify_one();
+        }
+    }
+};
+
+/*
+    Evaluate `function(i_item, i_thread)` for every `i_item` in [0, n_items) on the threads of `pool`, and
+    add the results together in order of increasing `i_item`; `i_thread` identifies the calling thread, as
+    in `ThreadPool::parallel_for_with_thread_index()`, so that each thread can use its own state. The result
+    is identical for any number of threads.
+*/
+template <typename T, typename Function>
+auto parallel_ordered_sum_with_thread_index(ThreadPool& pool, std::size_t n_items, Function&& function) -> T
+{
+    auto partial_sums = std::vector<T>(n_items);
+    pool.parallel_for_with_thread_index(n_items, [&](std::size_t i_item, std::size_t i_thread) {
+        partial_sums[i_item] = function(i_item, i_thread);
+    });
+
+    auto total = T {};
+    for (const auto& partial_sum : partial_sums) {
+        total += partial_sum;
+    }
+
+    return total;
+}
+
+// like `parallel_ordered_sum_with_thread_index()`, for a `function(i_item)` that needs no state of its own
+template <typename T, typename Function>
+auto parallel_ordered_sum(ThreadPool& pool, std::size_t n_items, Function&& function) -> T
+{
+    return parallel_ordered_sum_with_thread_index<T>(pool, n_items, [&function](std::size_t i_item, std::size_t) {
+        return function(i_item);
+    });
+}
+
+}  // namespace common
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <ios>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include <common/io_utils.hpp>
+#include <common/memory_usage.hpp>
+
+/*
+    A tracer that records when the scopes of the simulation begin and end, and writes them out as a
+    Chrome `trace_event` JSON file that can be opened in Perfetto (https://ui.perfetto.dev) or in
+    `chrome://tracing`.
+
+    Without `PIMC_SIM_TRACE_EVENTS`, `TraceScope` never reads the clock. Otherwise, nothing is recorded
+    until `set_recording(true)` is called, so that only a chosen range of blocks is traced.
+
+    Each thread writes its events into its own ring buffer, without locks; once a buffer is full, the
+    oldest events are overwritten. The buffers must only be read while nothing is being recorded, which
+    in the simulation means between blocks.
+*/
+
+namespace common
+{
+
+namespace trace
+{
+
+#if defined(PIMC_SIM_TRACE_EVENTS)
+constexpr inline auto IS_TRACING_ENABLED = bool {true};
+#else
+constexpr inline auto IS_TRACING_ENABLED = bool {false};
+#endif
+
+/*
+    The names must outlive the tracer (in practice, they are string literals), and are written into the
+    JSON file without escaping.
+*/
+struct TraceEvent
+{
+    const char* name {nullptr};
+    const char* arg_name {nullptr};
+    std::int64_t arg_value {};
+    std::int64_t start_ns {};
+    std::int64_t duration_ns {};
+};
+
+struct TraceSummary
+{
+    std::size_t n_events {};
+    std::size_t n_overwritten_events {};
+};
+
+}  // namespace trace
+
+}  // namespace common
+
+namespace impl_common_trace
+{
+
+constexpr inline auto DEFAULT_TRACE_BUFFER_CAPACITY = std::size_t {1 << 18};
+
+using clock = std::chrono::steady_clock;
+
+class TraceRingBuffer
+{
+public:
+    TraceRingBuffer(std::size_t i_thread, std::size_t capacity)
+        : i_thread_ {i_thread}
+        , events_(capacity)
+    {}
+
+    // only ever called from the thread that owns the buffer
+    void push(const common::trace::TraceEvent& event) noexcept
+    {
+        const auto n_written = n_written_.load(std::memory_order_relaxed);
+        events_[n_written % events_.size()] = event;
+        n_written_.store(n_written + 1, std::memory_order_release);
+    }
+
+    // the events still held in the buffer, from oldest to newest
+    auto events() const -> std::vector<common::trace::TraceEvent>
+    {
+        const auto n_written = n_written_.load(std::memory_order_acquire);
+        const auto n_held = std::min<std::size_t>(n_written, events_.size());
+
+        auto output = std::vector<common::trace::TraceEvent> {};
+        output.reserve(n_held);
+        for (auto i_event = n_written - n_held; i_event < n_written; ++i_event) {
+            output.push_back(events_[i_event % events_.size()]);
+        }
+
+        return output;
+    }
+
+    auto n_overwritten() const noexcept -> std::size_t
+    {
+        const auto n_written = n_written_.load(std::memory_order_acquire);
+        return n_written > events_.size() ? n_written - events_.size() : 0;
+    }
+
+    auto i_thread() const noexcept -> std::size_t
+    {
+        return i_thread_;
+    }
+
+    void clear() noexcept
+    {
+        n_written_.store(0, std::memory_order_release);
+    }
+
+    auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::vector_memory_usage(events_);
+    }
+
+private:
+    std::size_t i_thread_;
+    std::vector<common::trace::TraceEvent> events_;
+    std::atomic<std::size_t> n_written_ {0};
+};
+
+/*
+    Owns the buffer of every thread that has recorded an event; the buffers are never removed, so the
+    events recorded by a thread that has since exited are still written out.
+*/
+class TraceRegistry
+{
+public:
+    auto add_thread() -> TraceRingBuffer&
+    {
+        auto lock = std::lock_guard {mutex_};
+        return buffers_.emplace_back(buffers_.size(), DEFAULT_TRACE_BUFFER_CAPACITY);
+    }
+
+    template <typename Function>
+    void for_each_buffer(Function&& function)
+    {
+        auto lock = std::lock_guard {mutex_};
+        for (auto& buffer : buffers_) {
+            function(buffer);
+        }
+    }
+
+    auto is_recording() const noexcept -> bool
+    {
+        return is_recording_.load(std::memory_order_relaxed);
+    }
+
+    void set_recording(bool is_recording) noexcept
+    {
+        is_recording_.store(is_recording, std::memory_order_relaxed);
+    }
+
+    // the timestamps are measured from the moment the registry is created
+    auto nanoseconds_since_origin(clock::time_point time_point) const noexcept -> std::int64_t
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time_point - origin_).count();
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<TraceRingBuffer> buffers_;
+    std::atomic<bool> is_recording_ {false};
+    clock::time_point origin_ {clock::now()};
+};
+
+inline auto trace_registry() -> TraceRegistry&
+{
+    static auto registry = TraceRegistry {};
+    return registry;
+}
+
+// a thread whose buffer cannot be allocated gets no buffer, and its events are dropped
+inline auto this_thread_buffer() noexcept -> TraceRingBuffer*
+{
+    thread_local auto* buffer = []() noexcept -> TraceRingBuffer* {
+        try {
+            return &trace_registry().add_thread();
+        }
+        catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }();
+
+    return buffer;
+}
+
+inline void write_microseconds(std::ostream& out_stream, std::int64_t nanoseconds)
+{
+    out_stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+}
+
+inline void write_trace_event(std::ostream& out_stream, const common::trace::TraceEvent& event, std::size_t i_thread)
+{
+    out_stream << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << i_thread << ",\"ts\":";
+    write_microseconds(out_stream, event.start_ns);
+    out_stream << ",\"dur\":";
+    write_microseconds(out_stream, event.duration_ns);
+    if (event.arg_name != nullptr) {
+        out_stream << ",\"args\":{\"" << event.arg_name << "\":" << event.arg_value << '}';
+    }
+    out_stream << '}';
+}
+
+}  // namespace impl_common_trace
+
+namespace common
+{
+
+namespace trace
+{
+
+inline auto is_recording() noexcept -> bool
+{
+    if constexpr (IS_TRACING_ENABLED) {
+        return impl_common_trace::trace_registry().is_recording();
+    }
+    else {
+        return false;
+    }
+}
+
+inline void set_recording(bool is_recording) noexcept
+{
+    if constexpr (IS_TRACING_ENABLED) {
+        impl_common_trace::trace_registry().set_recording(is_recording);
+    }
+}
+
+/*
+    Records a single event covering the time between its construction and destruction, on the calling
+    thread; an optional integer argument (the block index, the number of samples, ...) is attached to it.
+*/
+class TraceScope
+{
+public:
+    using clock = impl_common_trace::clock;
+
+    explicit TraceScope(const char* name, const char* arg_name = nullptr, std::int64_t arg_value = 0) noexcept
+    {
+        if constexpr (IS_TRACING_ENABLED) {
+            if (is_recording()) {
+                event_.name = name;
+                event_.arg_name = arg_name;
+                event_.arg_value = arg_value;
+                start_time_point_ = clock::now();
+            }
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    auto operator=(const TraceScope&) -> TraceScope& = delete;
+
+    ~TraceScope()
+    {
+        if constexpr (IS_TRACING_ENABLED) {
+            if (event_.name == nullptr) {
+                return;
+            }
+
+            auto* buffer = impl_common_trace::this_thread_buffer();
+            if (buffer == nullptr) {
+                return;
+            }
+
+            const auto& registry = impl_common_trace::trace_registry();
+            const auto end_time_point = clock::now();
+            event_.start_ns = registry.nanoseconds_since_origin(start_time_point_);
+            event_.duration_ns = registry.nanoseconds_since_origin(end_time_point) - event_.start_ns;
+
+            buffer->push(event_);
+        }
+    }
+
+private:
+    TraceEvent event_ {};
+    clock::time_point start_time_point_ {};
+};
+
+// the buffers of every thread that has recorded an event so far
+inline auto memory_usage() -> MemoryUsage
+{
+    auto usage = MemoryUsage {};
+    if constexpr (IS_TRACING_ENABLED) {
+        impl_common_trace::trace_registry().for_each_buffer([&](const impl_common_trace::TraceRingBuffer& buffer) {
+            usage += buffer.memory_usage();
+        });
+    }
+
+    return usage;
+}
+
+/*
+    Writes every event held in the buffers to `filepath` as a Chrome `trace_event` JSON file, and empties
+    the buffers; this must not be called while events are being recorded.
+*/
+inline auto write_trace_events(const std::filesystem::path& filepath) -> TraceSummary
+{
+    auto summary = TraceSummary {};
+    auto out_stream = common::io::open_output_filestream_checked(filepath);
+
+    out_stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    auto is_first_event = bool {true};
+    const auto write_separator = [&]() {
+        if (!is_first_event) {
+            out_stream << ",\n";
+        }
+        is_first_event = false;
+    };
+
+    impl_common_trace::trace_registry().for_each_buffer([&](impl_common_trace::TraceRingBuffer& buffer) {
+        const auto i_thread = buffer.i_thread();
+
+        write_separator();
+        out_stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i_thread;
+        out_stream << ",\"args\":{\"name\":\"thread " << i_thread << "\"}}";
+
+        for (const auto& event : buffer.events()) {
+            write_separator();
+            impl_common_trace::write_trace_event(out_stream, event, i_thread);
+            ++summary.n_events;
+        }
+
+        summary.n_overwritten_events += buffer.n_overwritten();
+        buffer.clear();
+    });
+
+    out_stream << "\n]}\n";
+
+    return summary;
+}
+
+}  // namespace trace
+
+}  // namespace common
@@ -13,6 +13,7 @@ constexpr auto DEFAULT_WRITER_BLOCK_INDEX_PADDING = int {5};
 constexpr auto DEFAULT_WRITER_FLOATING_POINT_PRECISION = int {8};
 constexpr auto DEFAULT_WRITER_INTEGER_PADDING = int {8};
 constexpr auto DEFAULT_TEMPORARY_SUFFIX = std::string {"_TEMPORARY"};
+constexpr auto DEFAULT_COMMITTED_LENGTH_SUFFIX = std::string {"_COMMITTED"};
 constexpr auto DEFAULT_MULTICOLUMN_SPACES = std::string {"   "};
 constexpr auto DEFAULT_SPACING = std::size_t {3};
 
@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
+
+#include <worldline/writers/binary_worldlines.hpp>
+#include <worldline/writers/read_worldlines.hpp>
+#include <worldline/writers/worldline_codec.hpp>
+
+constexpr auto NDIM = std::size_t {3};
+
+/*
+    Convert text worldline files into binary worldline files, in place; the files keep their names, so
+    a simulation that is continued from them finds them where it expects them.
+
+    The coordinates are stored in double precision unless the `--float` flag is given, and are stored
+    uncompressed unless the `--compress` flag is given; the flags must come before the paths.
+*/
+auto main(int argc, char** argv) -> int
+{
+    auto is_float = false;
+    auto codec = worldline::WorldlineCodec::RAW;
+
+    auto i_first_filepath = 1;
+    for (; i_first_filepath < argc; ++i_first_filepath) {
+        const auto argument = std::string_view {argv[i_first_filepath]};
+        if (argument == "--float") {
+            is_float = true;
+        }
+        else if (argument == "--compress") {
+            codec = worldline::WorldlineCodec::DELTA_BITPACK;
+        }
+        else {
+            break;
+        }
+    }
+
+    if (i_first_filepath == argc) {
+        std::cout << "ERROR: program incorrectly called from command line.\n";
+        std::cout << "a.out [--float] [--compress] path-to-worldline-file...\n";
+        std::exit(EXIT_FAILURE);
+    }
+
+    for (auto i_arg = i_first_filepath; i_arg < argc; ++i_arg) {
+        const auto filepath = std::filesystem::path {argv[i_arg]};
+
+        if (worldline::is_binary_worldline_file(filepath)) {
+            std::cout << "Skipping file already in the binary format: " << filepath << '\n';
+            continue;
+        }
+
+        try {
+            if (is_float) {
+                worldline::convert_text_worldlines_to_binary<float, NDIM>(filepath, filepath, codec);
+            }
+            else {
+                worldline::convert_text_worldlines_to_binary<double, NDIM>(filepath, filepath, codec);
+            }
+        }
+        catch (const std::exception& err) {
+            std::cout << "ERROR: failed to convert " << filepath << '\n';
+            std::cout << err.what() << '\n';
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <coordinates/box_sides.hpp>
+#include <coordinates/cartesian.hpp>
+
+namespace coord
+{
+
+// with fewer cells than this along a dimension, the adjacent cells would wrap around onto each other
+constexpr inline auto MINIMUM_CELL_LIST_CELLS_PER_DIMENSION = std::size_t {3};
+
+/*
+    The PeriodicCellList divides a periodic box into a grid of cells whose sides are at least as long as
+    a cutoff distance. Every point whose minimum image lies within the cutoff distance of a given point
+    must then lie in the same cell, or in one of the adjacent cells (including across the periodic
+    boundaries), so only those cells have to be searched.
+
+    If fewer than three cells fit along a dimension, the adjacent cells along that dimension would wrap
+    around onto each other; in that case, the entire dimension is treated as a single cell, so that no
+    point is ever visited twice.
+
+    The points are sorted into cells with a counting sort; the storage is reused between calls to `update()`,
+    so nothing is allocated once the number of points stops changing.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+class PeriodicCellList
+{
+public:
+    PeriodicCellList(const BoxSides<FP, NDIM>& box, FP cutoff_distance)
+    {
+        ctr_check_cutoff_distance_positive_(cutoff_distance);
+
+        std::size_t n_total_cells {1};
+        for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+            auto n_cells = static_cast<std::size_t>(std::floor(box[i_dim] / cutoff_distance));
+            if (n_cells < MINIMUM_CELL_LIST_CELLS_PER_DIMENSION) {
+                n_cells = 1;
+            }
+
+            n_cells_[i_dim] = n_cells;
+            cell_sizes_[i_dim] = box[i_dim] / static_cast<FP>(n_cells);
+            n_total_cells *= n_cells;
+        }
+
+        cell_starts_.resize(n_total_cells + 1);
+    }
+
+    void update(std::span<const Cartesian<FP, NDIM>> points)
+    {
+        const auto n_total_cells = cell_starts_.size() - 1;
+
+        point_cells_.resize(points.size());
+        cell_points_.resize(points.size());
+        std::fill(cell_starts_.begin(), cell_starts_.end(), std::size_t {0});
+
+        for (std::size_t i_point {0}; i_point < points.size(); ++i_point) {
+            const auto i_cell = flat_cell_index_(cell_coordinates_(points[i_point]));
+            point_cells_[i_point] = i_cell;
+            ++cell_starts_[i_cell + 1];
+        }
+
+        for (std::size_t i_cell {0}; i_cell < n_total_cells; ++i_cell) {
+            cell_starts_[i_cell + 1] += cell_starts_[i_cell];
+        }
+
+        // `cell_ends` marks where the next point of each cell goes; it ends up at the start of the next cell
+        auto* cell_ends = cell_starts_.data();
+        for (std::size_t i_point {0}; i_point < points.size(); ++i_point) {
+            cell_points_[cell_ends[point_cells_[i_point]]++] = i_point;
+        }
+
+        // shift the starts back to where they were before the points were placed
+        for (std::size_t i_cell {n_total_cells}; i_cell > 0; --i_cell) {
+            cell_starts_[i_cell] = cell_starts_[i_cell - 1];
+        }
+        cell_starts_[0] = 0;
+    }
+
+    /*
+        Call `function(i_point)` for the index of every point in the cell containing `point`, and in
+        all the cells adjacent to it. This includes every point within the cutoff distance of `point`,
+        but also points that are further away, so the caller still has to check the distances.
+    */
+    template <typename Function>
+    void for_each_nearby_index(const Cartesian<FP, NDIM>& point, Function&& function) const
+    {
+        const auto centre = cell_coordinates_(point);
+
+        auto offsets = std::array<long int, NDIM> {};
+        for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+            offsets[i_dim] = min_offset_(i_dim);
+        }
+
+        while (true) {
+            auto neighbour = std::array<std::size_t, NDIM> {};
+            for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+                const auto n_cells = static_cast<long int>(n_cells_[i_dim]);
+                const auto shifted = static_cast<long int>(centre[i_dim]) + offsets[i_dim];
+                neighbour[i_dim] = static_cast<std::size_t>((shifted + n_cells) % n_cells);
+            }
+
+            const auto i_cell = flat_cell_index_(neighbour);
+            for (auto i = cell_starts_[i_cell]; i < cell_starts_[i_cell + 1]; ++i) {
+                function(cell_points_[i]);
+            }
+
+            // advance the offsets like an odometer
+            std::size_t i_dim {0};
+            for (; i_dim < NDIM; ++i_dim) {
+                if (offsets[i_dim] < -min_offset_(i_dim)) {
+                    ++offsets[i_dim];
+                    break;
+                }
+                offsets[i_dim] = min_offset_(i_dim);
+            }
+
+            if (i_dim == NDIM) {
+                return;
+            }
+        }
+    }
+
+    constexpr auto n_cells(std::size_t i_dim) const noexcept -> std::size_t
+    {
+        return n_cells_[i_dim];
+    }
+
+private:
+    std::array<std::size_t, NDIM> n_cells_ {};
+    std::array<FP, NDIM> cell_sizes_ {};
+    std::vector<std::size_t> cell_starts_ {};
+    std::vector<std::size_t> cell_points_ {};
+    std::vector<std::size_t> point_cells_ {};
+
+    constexpr auto min_offset_(std::size_t i_dim) const noexcept -> long int
+    {
+        return n_cells_[i_dim] == 1 ? 0 : -1;
+    }
+
+    auto cell_coordinates_(const Cartesian<FP, NDIM>& point) const noexcept -> std::array<std::size_t, NDIM>
+    {
+        auto coordinates = std::array<std::size_t, NDIM> {};
+        for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+            const auto n_cells = static_cast<long int>(n_cells_[i_dim]);
+            const auto i_cell = static_cast<long int>(std::floor(point[i_dim] / cell_sizes_[i_dim]));
+
+            // the points are not guaranteed to lie inside the box, so wrap them back in
+            coordinates[i_dim] = static_cast<std::size_t>(((i_cell % n_cells) + n_cells) % n_cells);
+        }
+
+        return coordinates;
+    }
+
+    constexpr auto flat_cell_index_(const std::array<std::size_t, NDIM>& coordinates) const noexcept -> std::size_t
+    {
+        std::size_t index {0};
+        for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+            index = index * n_cells_[i_dim] + coordinates[i_dim];
+        }
+
+        return index;
+    }
+
+    void ctr_check_cutoff_distance_positive_(FP cutoff_distance) const
+    {
+        if (cutoff_distance <= FP {0.0}) {
+            auto err_msg = std::stringstream {};
+            err_msg << "The cutoff distance of a `PeriodicCellList` must be positive.\n";
+            err_msg << "Found: " << cutoff_distance << '\n';
+            throw std::runtime_error {err_msg.str()};
+        }
+    }
+};
+
+/*
+    A PeriodicCellList only saves any work along the dimensions into which at least three cells fit; along
+    the others, every point is visited anyways.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+auto is_cell_list_pruning_every_dimension(const BoxSides<FP, NDIM>& box, FP cutoff_distance) noexcept -> bool
+{
+    for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+        const auto n_cells = static_cast<std::size_t>(std::floor(box[i_dim] / cutoff_distance));
+        if (n_cells < MINIMUM_CELL_LIST_CELLS_PER_DIMENSION) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// the longest cutoff distance for which a PeriodicCellList still prunes along every dimension of the box
+template <std::floating_point FP, std::size_t NDIM>
+auto longest_pruning_cell_list_cutoff_distance(const BoxSides<FP, NDIM>& box) noexcept -> FP
+{
+    const auto& coords = box.coordinates();
+    const auto shortest_side = *std::min_element(std::begin(coords), std::end(coords));
+
+    // the division may round up just enough for the last cell to no longer fit
+    auto cutoff_distance = shortest_side / static_cast<FP>(MINIMUM_CELL_LIST_CELLS_PER_DIMENSION);
+    while (!is_cell_list_pruning_every_dimension(box, cutoff_distance)) {
+        cutoff_distance = std::nextafter(cutoff_distance, FP {0.0});
+    }
+
+    return cutoff_distance;
+}
+
+}  // namespace coord
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <coordinates/box_sides.hpp>
+#include <coordinates/cartesian.hpp>
+#include <coordinates/cell_list.hpp>
+#include <coordinates/measure.hpp>
+#include <coordinates/periodic_shift.hpp>
+
+namespace impl_estim
+{
+
+/*
+    A particle within the cutoff distance of the reference particle, translated to the periodic image
+    closest to the reference particle (which is placed at the origin).
+*/
+template <std::floating_point FP, std::size_t NDIM>
+struct ShiftedNeighbour
+{
+    std::size_t index;
+    coord::Cartesian<FP, NDIM> point;
+    FP dist_sq;
+};
+
+/*
+    The storage needed to enumerate the triplets or quadruplets of a timeslice; it is kept between the
+    timeslices, so that nothing has to be allocated inside the loops over the particles.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+struct PeriodicNeighbourWorkspace
+{
+    PeriodicNeighbourWorkspace(const coord::BoxSides<FP, NDIM>& periodic_box, FP cutoff_distance)
+        : box {periodic_box}
+        , cell_list {periodic_box, cutoff_distance}
+    {}
+
+    coord::BoxSides<FP, NDIM> box;
+    coord::PeriodicCellList<FP, NDIM> cell_list;
+    std::vector<ShiftedNeighbour<FP, NDIM>> neighbours {};
+};
+
+/*
+    Fill `neighbours` with every particle at index greater than `i0` whose minimum image lies within the
+    cutoff distance of particle `i0`, in order of increasing index.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+void collect_shifted_neighbours(
+    std::size_t i0,
+    std::span<const coord::Cartesian<FP, NDIM>> points,
+    FP cutoff_distance_sq,
+    PeriodicNeighbourWorkspace<FP, NDIM>& workspace
+)
+{
+    const auto origin = points[i0];
+    auto& neighbours = workspace.neighbours;
+    neighbours.clear();
+
+    // clang-format off
+    workspace.cell_list.for_each_nearby_index(origin, [&](std::size_t i_other) {
+        if (i_other <= i0) {
+            return;
+        }
+
+        const auto shifted = coord::translate_point_near_origin(points[i_other] - origin, workspace.box);
+        const auto dist_sq = coord::distance_squared(coord::Cartesian<FP, NDIM>::origin(), shifted);
+        if (dist_sq > cutoff_distance_sq) {
+            return;
+        }
+
+        neighbours.push_back({i_other, shifted, dist_sq});
+    });
+    // clang-format on
+
+    std::sort(neighbours.begin(), neighbours.end(), [](const auto& left, const auto& right) {
+        return left.index < right.index;
+    });
+}
+
+}  // namespace impl_estim
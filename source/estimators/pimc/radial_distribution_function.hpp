@@ -1,12 +1,41 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <span>
+#include <vector>
 
+#include <common/thread_pool.hpp>
+#include <coordinates/cartesian.hpp>
 #include <coordinates/measure_concepts.hpp>
 #include <mathtools/histogram/histogram.hpp>
 #include <worldline/worldline.hpp>
 
+namespace impl_estim
+{
+
+// fill `distances` with the distances between every pair of particles in the timeslice
+template <std::floating_point FP, std::size_t NDIM>
+void timeslice_pair_distances(
+    std::span<const coord::Cartesian<FP, NDIM>> timeslice,
+    const coord::DistanceCalculator<FP, NDIM> auto& distance_calculator,
+    std::vector<FP>& distances
+)
+{
+    distances.clear();
+
+    for (std::size_t ip0 {0}; ip0 < timeslice.size() - 1; ++ip0) {
+        const auto p0 = timeslice[ip0];
+        for (std::size_t ip1 {ip0 + 1}; ip1 < timeslice.size(); ++ip1) {
+            const auto p1 = timeslice[ip1];
+            distances.push_back(distance_calculator(p0, p1));
+        }
+    }
+}
+
+}  // namespace impl_estim
+
 namespace estim
 {
 
@@ -17,17 +46,49 @@ void update_radial_distribution_function_histogram(
     const worldline::Worldlines<FP, NDIM>& worldlines
 )
 {
+    auto distances = std::vector<FP> {};
+
     for (std::size_t i_tslice {0}; i_tslice < worldlines.n_timeslices(); ++i_tslice) {
         const auto timeslice = worldlines.timeslice(i_tslice);
-        for (std::size_t ip0 {0}; ip0 < timeslice.size() - 1; ++ip0) {
-            const auto p0 = timeslice[ip0];
-            for (std::size_t ip1 {ip0 + 1}; ip1 < timeslice.size(); ++ip1) {
-                const auto p1 = timeslice[ip1];
-
-                const auto distance = distance_calculator(p0, p1);
-                radial_dist_histo.add(distance);
-            }
+        impl_estim::timeslice_pair_distances<FP, NDIM>(timeslice, distance_calculator, distances);
+        radial_dist_histo.add_many(distances);
+    }
+}
+
+/*
+    The timeslices are split into one contiguous range per thread of `pool`; each range is binned into its
+    own copy (shard) of the histogram, and the shards are merged into `radial_dist_histo` at the end. The
+    bins only hold counts, so the result is identical to that of the serial overload.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+void update_radial_distribution_function_histogram(
+    mathtools::Histogram<FP>& radial_dist_histo,
+    const coord::DistanceCalculator<FP, NDIM> auto& distance_calculator,
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    common::ThreadPool& pool
+)
+{
+    const auto n_timeslices = worldlines.n_timeslices();
+    const auto n_shards = std::min(pool.n_threads(), n_timeslices);
+
+    auto empty_shard = radial_dist_histo;
+    empty_shard.reset();
+    auto shards = std::vector<mathtools::Histogram<FP>>(n_shards, empty_shard);
+
+    pool.parallel_for(n_shards, [&](std::size_t i_shard) {
+        const auto i_tslice_begin = (i_shard * n_timeslices) / n_shards;
+        const auto i_tslice_end = ((i_shard + 1) * n_timeslices) / n_shards;
+
+        auto distances = std::vector<FP> {};
+        for (std::size_t i_tslice {i_tslice_begin}; i_tslice < i_tslice_end; ++i_tslice) {
+            const auto timeslice = worldlines.timeslice(i_tslice);
+            impl_estim::timeslice_pair_distances<FP, NDIM>(timeslice, distance_calculator, distances);
+            shards[i_shard].add_many(distances);
         }
+    });
+
+    for (const auto& shard : shards) {
+        radial_dist_histo.merge(shard);
     }
 }
 
@@ -1,58 +1,199 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <span>
 #include <vector>
 
+#include <common/thread_pool.hpp>
 #include <coordinates/box_sides.hpp>
+#include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
+#include <estimators/pimc/periodic_neighbours.hpp>
+#include <estimators/pimc/timeslice_sum.hpp>
 #include <interactions/three_body/potential_concepts.hpp>
+#include <mathtools/grid/square_adjacency_matrix.hpp>
 #include <worldline/worldline.hpp>
 
 namespace impl_estim
 {
 
 template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
-constexpr auto total_triplet_potential_energy_maybe_periodic(
-    const worldline::Worldlines<FP, NDIM>& worldlines,
-    const PointPotential& potential
+constexpr auto triplet_potential_energy_maybe_periodic(
+    const PointPotential& potential,
+    const coord::Cartesian<FP, NDIM>& p0,
+    const coord::Cartesian<FP, NDIM>& p1,
+    const coord::Cartesian<FP, NDIM>& p2
 ) noexcept -> FP
 {
     if constexpr (IsPeriodic) {
         static_assert(interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>);
+        return potential.within_box_cutoff(p0, p1, p2);
     }
     else {
         static_assert(interact::TripletPointPotential<PointPotential, FP, NDIM>);
+        return potential(p0, p1, p2);
     }
+}
 
-    const auto n_timeslices = worldlines.n_timeslices();
-    const auto n_particles = worldlines.n_worldlines();
-
-    auto total_triplet_pot_energy = FP {0.0};
-
-    for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
-        const auto timeslice = worldlines.timeslice(i_tslice);
-
-        for (std::size_t ip0 {0}; ip0 < n_particles - 2; ++ip0) {
-            const auto p0 = timeslice[ip0];
-            for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles - 1; ++ip1) {
-                const auto p1 = timeslice[ip1];
-                for (std::size_t ip2 {ip1 + 1}; ip2 < n_particles; ++ip2) {
-                    const auto p2 = timeslice[ip2];
-                    if constexpr (IsPeriodic) {
-                        total_triplet_pot_energy += potential.within_box_cutoff(p0, p1, p2);
-                    }
-                    else {
-                        total_triplet_pot_energy += potential(p0, p1, p2);
-                    }
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
+constexpr auto timeslice_triplet_potential_energy_maybe_periodic(
+    std::span<const coord::Cartesian<FP, NDIM>> timeslice,
+    const PointPotential& potential
+) noexcept -> FP
+{
+    const auto n_particles = timeslice.size();
+
+    auto triplet_pot_energy = FP {0.0};
+
+    for (std::size_t ip0 {0}; ip0 < n_particles - 2; ++ip0) {
+        const auto p0 = timeslice[ip0];
+        for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles - 1; ++ip1) {
+            const auto p1 = timeslice[ip1];
+            for (std::size_t ip2 {ip1 + 1}; ip2 < n_particles; ++ip2) {
+                const auto p2 = timeslice[ip2];
+                triplet_pot_energy +=
+                    triplet_potential_energy_maybe_periodic<PointPotential, FP, NDIM, IsPeriodic>(potential, p0, p1, p2);
+            }
+        }
+    }
+
+    return triplet_pot_energy;
+}
+
+/*
+    Only the triplets in which every particle is a neighbour of the other two, according to `adjmat`, are
+    visited; each such triplet is visited exactly once, with its particle indices in increasing order.
+*/
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
+constexpr auto timeslice_triplet_potential_energy_from_neighbours_maybe_periodic(
+    std::span<const coord::Cartesian<FP, NDIM>> timeslice,
+    const PointPotential& potential,
+    const mathtools::SquareAdjacencyMatrix& adjmat
+) noexcept -> FP
+{
+    const auto n_particles = timeslice.size();
+
+    auto triplet_pot_energy = FP {0.0};
+
+    for (std::size_t ip0 {0}; ip0 < n_particles; ++ip0) {
+        const auto neighbours0 = adjmat.neighbours(ip0);
+        const auto p0 = timeslice[ip0];
+
+        for (auto ip1 : neighbours0) {
+            if (ip1 <= ip0) {
+                continue;
+            }
+
+            const auto neighbours1 = adjmat.neighbours(ip1);
+            const auto p1 = timeslice[ip1];
+
+            for (auto ip2 : neighbours0) {
+                if (ip2 <= ip1 || std::find(neighbours1.begin(), neighbours1.end(), ip2) == neighbours1.end()) {
+                    continue;
+                }
+
+                const auto p2 = timeslice[ip2];
+                triplet_pot_energy +=
+                    triplet_potential_energy_maybe_periodic<PointPotential, FP, NDIM, IsPeriodic>(potential, p0, p1, p2);
+            }
+        }
+    }
+
+    return triplet_pot_energy;
+}
+
+/*
+    Only the triplets in which every side length is within the cutoff distance of the workspace are visited;
+    they are found with a periodic cell list, by pairing up the neighbours of each reference particle. The
+    triplets are visited in the same order as in `timeslice_triplet_potential_energy_maybe_periodic()`, and
+    the skipped triplets would have contributed nothing, so the two give the same energy as long as the
+    cutoff distance is at least the box cutoff distance of the potential; a shorter cutoff distance leaves
+    out the triplets with a longer side.
+*/
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+auto timeslice_triplet_potential_energy_from_cell_list(
+    std::span<const coord::Cartesian<FP, NDIM>> timeslice,
+    const PointPotential& potential,
+    FP cutoff_distance,
+    PeriodicNeighbourWorkspace<FP, NDIM>& workspace
+) -> FP
+{
+    static_assert(interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>);
+
+    if (timeslice.size() < 3) {
+        return FP {0.0};
+    }
+
+    const auto cutoff_distance_sq = cutoff_distance * cutoff_distance;
+
+    workspace.cell_list.update(timeslice);
+
+    auto triplet_pot_energy = FP {0.0};
+
+    for (std::size_t ip0 {0}; ip0 < timeslice.size() - 2; ++ip0) {
+        collect_shifted_neighbours<FP, NDIM>(ip0, timeslice, cutoff_distance_sq, workspace);
+
+        const auto& neighbours = workspace.neighbours;
+        const auto p0 = timeslice[ip0];
+
+        for (std::size_t i1 {0}; i1 < neighbours.size(); ++i1) {
+            const auto& neigh1 = neighbours[i1];
+            const auto p1 = timeslice[neigh1.index];
+
+            for (std::size_t i2 {i1 + 1}; i2 < neighbours.size(); ++i2) {
+                const auto& neigh2 = neighbours[i2];
+
+                // the neighbours are already shifted to their Attard images around the reference particle
+                if (coord::distance_squared(neigh1.point, neigh2.point) > cutoff_distance_sq) {
+                    continue;
                 }
+
+                triplet_pot_energy += potential.within_box_cutoff(p0, p1, timeslice[neigh2.index]);
             }
         }
     }
 
-    total_triplet_pot_energy /= static_cast<FP>(n_timeslices);
+    return triplet_pot_energy;
+}
+
+// there is no point in searching beyond the box cutoff distance, where the potential is zero anyways
+template <std::floating_point FP, std::size_t NDIM>
+constexpr auto cell_list_cutoff_distance(const coord::BoxSides<FP, NDIM>& box, FP cutoff_distance) noexcept -> FP
+{
+    return std::min(cutoff_distance, coord::box_cutoff_distance(box));
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
+constexpr auto total_triplet_potential_energy_maybe_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential
+) noexcept -> FP
+{
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return timeslice_triplet_potential_energy_maybe_periodic<PointPotential, FP, NDIM, IsPeriodic>(
+            worldlines.timeslice(i_tslice), potential
+        );
+    };
 
-    return total_triplet_pot_energy;
+    return mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy);
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
+auto total_triplet_potential_energy_maybe_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    common::ThreadPool& pool
+) -> FP
+{
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return timeslice_triplet_potential_energy_maybe_periodic<PointPotential, FP, NDIM, IsPeriodic>(
+            worldlines.timeslice(i_tslice), potential
+        );
+    };
+
+    return mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy, pool);
 }
 
 }  // namespace impl_estim
@@ -84,4 +225,137 @@ constexpr auto total_triplet_potential_energy_periodic(
     );
 }
 
+/*
+    The timeslices are spread over the threads of `pool`; the potential is only ever accessed through
+    const member functions, and the result is identical to that of the serial overloads above.
+*/
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::TripletPointPotential<PointPotential, FP, NDIM>
+auto total_triplet_potential_energy(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    common::ThreadPool& pool
+) -> FP
+{
+    return impl_estim::total_triplet_potential_energy_maybe_periodic<PointPotential, FP, NDIM, false>(
+        worldlines, potential, pool
+    );
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>
+auto total_triplet_potential_energy_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    common::ThreadPool& pool
+) -> FP
+{
+    return impl_estim::total_triplet_potential_energy_maybe_periodic<PointPotential, FP, NDIM, true>(
+        worldlines, potential, pool
+    );
+}
+
+/*
+    Reuse the (centroid) adjacency matrix of a nearest-neighbour interaction handler instead of visiting
+    every triplet; only the triplets whose particles are all neighbours of each other contribute.
+
+    This is much cheaper than visiting all O(N^3) triplets, but it is only equal to the full estimator
+    if the adjacency matrix was built with a cutoff large enough to include every triplet that lies
+    within the box cutoff of the potential.
+*/
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>
+auto total_triplet_potential_energy_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    const mathtools::SquareAdjacencyMatrix& adjmat,
+    common::ThreadPool& pool
+) -> FP
+{
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return impl_estim::timeslice_triplet_potential_energy_from_neighbours_maybe_periodic<
+            PointPotential, FP, NDIM, true>(worldlines.timeslice(i_tslice), potential, adjmat);
+    };
+
+    return impl_estim::mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy, pool);
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>
+auto total_triplet_potential_energy_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    const mathtools::SquareAdjacencyMatrix& adjmat
+) -> FP
+{
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return impl_estim::timeslice_triplet_potential_energy_from_neighbours_maybe_periodic<
+            PointPotential, FP, NDIM, true>(worldlines.timeslice(i_tslice), potential, adjmat);
+    };
+
+    return impl_estim::mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy);
+}
+
+/*
+    Find the triplets with a periodic cell list, instead of visiting every triplet; only the triplets with
+    all three side lengths within `cutoff_distance` are evaluated, so the cost grows linearly with the
+    number of particles (at a fixed density).
+
+    The cell list only prunes any triplets if at least three cells fit along every side of the box (see
+    `coord::is_cell_list_pruning_every_dimension()`), and a cutoff distance that short truncates the
+    three-body interaction; the triplets with a longer side are left out, so the result is no longer
+    equal to that of the estimators that visit every triplet. With a cutoff distance at the box cutoff
+    distance, the result matches the full estimators, but the cell list collapses into a single cell and
+    saves nothing.
+*/
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>
+auto total_triplet_potential_energy_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    const coord::BoxSides<FP, NDIM>& box,
+    FP cutoff_distance
+) -> FP
+{
+    const auto cutoff = impl_estim::cell_list_cutoff_distance(box, cutoff_distance);
+    auto workspace = impl_estim::PeriodicNeighbourWorkspace<FP, NDIM> {box, cutoff};
+
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return impl_estim::timeslice_triplet_potential_energy_from_cell_list<PointPotential, FP, NDIM>(
+            worldlines.timeslice(i_tslice), potential, cutoff, workspace
+        );
+    };
+
+    return impl_estim::mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy);
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PeriodicTripletPointPotential<PointPotential, FP, NDIM>
+auto total_triplet_potential_energy_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    const coord::BoxSides<FP, NDIM>& box,
+    FP cutoff_distance,
+    common::ThreadPool& pool
+) -> FP
+{
+    const auto cutoff = impl_estim::cell_list_cutoff_distance(box, cutoff_distance);
+
+    // the workspaces cannot be shared between the threads, but each thread reuses its own between timeslices
+    auto workspaces = std::vector<impl_estim::PeriodicNeighbourWorkspace<FP, NDIM>> {};
+    workspaces.reserve(pool.n_threads());
+    for (std::size_t i_thread {0}; i_thread < pool.n_threads(); ++i_thread) {
+        workspaces.emplace_back(box, cutoff);
+    }
+
+    const auto timeslice_energy = [&](std::size_t i_tslice, std::size_t i_thread) {
+        return impl_estim::timeslice_triplet_potential_energy_from_cell_list<PointPotential, FP, NDIM>(
+            worldlines.timeslice(i_tslice), potential, cutoff, workspaces[i_thread]
+        );
+    };
+
+    const auto n_timeslices = worldlines.n_timeslices();
+    return impl_estim::mean_over_timeslices_with_thread_index<FP>(n_timeslices, timeslice_energy, pool);
+}
+
 }  // namespace estim
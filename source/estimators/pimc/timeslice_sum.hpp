@@ -0,0 +1,51 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+#include <common/thread_pool.hpp>
+
+namespace impl_estim
+{
+
+/*
+    The total energy estimators evaluate the energy of each timeslice separately, and add the energies
+    of the timeslices together in order of increasing timeslice index. The serial and the threaded
+    versions below perform exactly the same floating-point operations in the same order, so the result
+    does not depend on whether a thread pool is used, or on how many threads it has.
+*/
+template <std::floating_point FP, typename TimesliceEnergy>
+constexpr auto mean_over_timeslices(std::size_t n_timeslices, TimesliceEnergy&& timeslice_energy) -> FP
+{
+    auto total_energy = FP {0.0};
+    for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+        total_energy += timeslice_energy(i_tslice);
+    }
+
+    return total_energy / static_cast<FP>(n_timeslices);
+}
+
+template <std::floating_point FP, typename TimesliceEnergy>
+auto mean_over_timeslices(std::size_t n_timeslices, TimesliceEnergy&& timeslice_energy, common::ThreadPool& pool)
+    -> FP
+{
+    const auto total_energy = common::parallel_ordered_sum<FP>(pool, n_timeslices, timeslice_energy);
+
+    return total_energy / static_cast<FP>(n_timeslices);
+}
+
+// like the threaded version above, for a `timeslice_energy(i_tslice, i_thread)` that needs a workspace per thread
+template <std::floating_point FP, typename TimesliceEnergy>
+auto mean_over_timeslices_with_thread_index(
+    std::size_t n_timeslices,
+    TimesliceEnergy&& timeslice_energy,
+    common::ThreadPool& pool
+) -> FP
+{
+    const auto total_energy =
+        common::parallel_ordered_sum_with_thread_index<FP>(pool, n_timeslices, timeslice_energy);
+
+    return total_energy / static_cast<FP>(n_timeslices);
+}
+
+}  // namespace impl_estim
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace estim
+{
+
+/*
+    The ways the triplet potential energy estimator can find the triplets it evaluates:
+      - ALL_TRIPLETS: visit every triplet of particles in each timeslice
+      - ADJACENCY_MATRIX: only visit the triplets whose particles are all neighbours of each other in the
+        adjacency matrix of the triplet interaction handler; cheaper, but the triplets outside the
+        neighbour cutoff of the handler are left out
+      - CELL_LIST: only visit the triplets whose side lengths are all within a given cutoff distance,
+        found with a periodic cell list; also cheaper, but the triplets with a longer side are left out
+*/
+enum class TripletEstimatorMethod
+{
+    ALL_TRIPLETS,
+    ADJACENCY_MATRIX,
+    CELL_LIST
+};
+
+constexpr auto TRIPLET_ESTIMATOR_METHOD_OPTIONS = std::array<std::string_view, 3> {"all", "adjacency", "cell_list"};
+
+inline auto map_triplet_estimator_method(std::string_view name) -> TripletEstimatorMethod
+{
+    if (name == TRIPLET_ESTIMATOR_METHOD_OPTIONS[0]) {
+        return TripletEstimatorMethod::ALL_TRIPLETS;
+    }
+    else if (name == TRIPLET_ESTIMATOR_METHOD_OPTIONS[1]) {
+        return TripletEstimatorMethod::ADJACENCY_MATRIX;
+    }
+    else if (name == TRIPLET_ESTIMATOR_METHOD_OPTIONS[2]) {
+        return TripletEstimatorMethod::CELL_LIST;
+    }
+    else {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: unknown triplet estimator method: '" << name << "'\n";
+        err_msg << "The options are: ";
+        for (const auto option : TRIPLET_ESTIMATOR_METHOD_OPTIONS) {
+            err_msg << '"' << option << "\" ";
+        }
+        err_msg << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+}
+
+}  // namespace estim
@@ -2,8 +2,12 @@
 
 #include <concepts>
 #include <cstddef>
+#include <span>
 #include <vector>
 
+#include <common/thread_pool.hpp>
+#include <coordinates/cartesian.hpp>
+#include <estimators/pimc/timeslice_sum.hpp>
 #include <interactions/two_body/potential_concepts.hpp>
 #include <worldline/worldline.hpp>
 
@@ -11,8 +15,8 @@ namespace impl_estim
 {
 
 template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
-constexpr auto total_pair_potential_energy_maybe_periodic(
-    const worldline::Worldlines<FP, NDIM>& worldlines,
+constexpr auto timeslice_pair_potential_energy_maybe_periodic(
+    std::span<const coord::Cartesian<FP, NDIM>> timeslice,
     const PointPotential& potential
 ) noexcept -> FP
 {
@@ -23,31 +27,55 @@ constexpr auto total_pair_potential_energy_maybe_periodic(
         static_assert(interact::PairPointPotential<PointPotential, FP, NDIM>);
     }
 
-    const auto n_timeslices = worldlines.n_timeslices();
-    const auto n_particles = worldlines.n_worldlines();
-
-    auto total_pair_potential_energy = FP {0.0};
+    const auto n_particles = timeslice.size();
 
-    for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
-        const auto timeslice = worldlines.timeslice(i_tslice);
+    auto pair_potential_energy = FP {0.0};
 
-        for (std::size_t ip0 {0}; ip0 < n_particles - 1; ++ip0) {
-            const auto p0 = timeslice[ip0];
-            for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles; ++ip1) {
-                const auto p1 = timeslice[ip1];
-                if constexpr (IsPeriodic) {
-                    total_pair_potential_energy += potential.within_box_cutoff(p0, p1);
-                }
-                else {
-                    total_pair_potential_energy += potential(p0, p1);
-                }
+    for (std::size_t ip0 {0}; ip0 < n_particles - 1; ++ip0) {
+        const auto p0 = timeslice[ip0];
+        for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles; ++ip1) {
+            const auto p1 = timeslice[ip1];
+            if constexpr (IsPeriodic) {
+                pair_potential_energy += potential.within_box_cutoff(p0, p1);
+            }
+            else {
+                pair_potential_energy += potential(p0, p1);
             }
         }
     }
 
-    total_pair_potential_energy /= static_cast<FP>(n_timeslices);
+    return pair_potential_energy;
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
+constexpr auto total_pair_potential_energy_maybe_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential
+) noexcept -> FP
+{
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return timeslice_pair_potential_energy_maybe_periodic<PointPotential, FP, NDIM, IsPeriodic>(
+            worldlines.timeslice(i_tslice), potential
+        );
+    };
+
+    return mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy);
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM, bool IsPeriodic>
+auto total_pair_potential_energy_maybe_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    common::ThreadPool& pool
+) -> FP
+{
+    const auto timeslice_energy = [&](std::size_t i_tslice) {
+        return timeslice_pair_potential_energy_maybe_periodic<PointPotential, FP, NDIM, IsPeriodic>(
+            worldlines.timeslice(i_tslice), potential
+        );
+    };
 
-    return total_pair_potential_energy;
+    return mean_over_timeslices<FP>(worldlines.n_timeslices(), timeslice_energy, pool);
 }
 
 }  // namespace impl_estim
@@ -79,4 +107,34 @@ constexpr auto total_pair_potential_energy_periodic(
     );
 }
 
+/*
+    The timeslices are spread over the threads of `pool`; the potential is only ever accessed through
+    const member functions, and the result is identical to that of the serial overloads above.
+*/
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PairPointPotential<PointPotential, FP, NDIM>
+auto total_pair_potential_energy(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    common::ThreadPool& pool
+) -> FP
+{
+    return impl_estim::total_pair_potential_energy_maybe_periodic<PointPotential, FP, NDIM, false>(
+        worldlines, potential, pool
+    );
+}
+
+template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
+requires interact::PeriodicPairPointPotential<PointPotential, FP, NDIM>
+auto total_pair_potential_energy_periodic(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    const PointPotential& potential,
+    common::ThreadPool& pool
+) -> FP
+{
+    return impl_estim::total_pair_potential_energy_maybe_periodic<PointPotential, FP, NDIM, true>(
+        worldlines, potential, pool
+    );
+}
+
 }  // namespace estim
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <common/buffered_writers/buffered_writer.hpp>
+#include <common/memory_usage.hpp>
+#include <mathtools/statistics/blocking.hpp>
+
+/*
+    The running statistics of an estimator: every value it produces is added to a streaming blocking
+    analysis, and the mean, standard error, integrated autocorrelation time, and effective sample size
+    after each block are written to a file next to the file of the estimator itself.
+*/
+
+namespace impl_estim_statistics
+{
+
+constexpr inline auto STATISTICS_FILENAME_SUFFIX = std::string_view {"_statistics.dat"};
+
+template <std::floating_point FP>
+using StatisticsWriter = common::writers::BlockValueWriter<FP, FP, FP, FP, std::size_t>;
+
+inline auto statistics_file_header(std::string_view name) -> std::string
+{
+    auto header = std::string {};
+    header += "# this file contains the running blocking analysis of the '" + std::string {name} + "' estimator\n";
+    header += "# the first column is the number label for the block, and the other columns are, in order:\n";
+    header += "#   mean\n";
+    header += "#   standard_error\n";
+    header += "#   autocorrelation_time\n";
+    header += "#   effective_sample_size\n";
+    header += "#   is_converged (1 if the blocking analysis found a plateau, 0 otherwise)\n";
+
+    return header;
+}
+
+}  // namespace impl_estim_statistics
+
+namespace estim
+{
+
+template <std::floating_point FP>
+class EstimatorStatistics
+{
+public:
+    using Writer = impl_estim_statistics::StatisticsWriter<FP>;
+
+    EstimatorStatistics(std::string name, std::filesystem::path filepath)
+        : name_ {std::move(name)}
+        , writer_ {std::move(filepath), impl_estim_statistics::statistics_file_header(name_)}
+    {}
+
+    void add(std::size_t i_block, FP value)
+    {
+        analysis_.add(value);
+
+        const auto estimate = analysis_.estimate();
+        writer_.accumulate(
+            {i_block,
+             estimate.mean,
+             estimate.standard_error,
+             estimate.autocorrelation_time,
+             estimate.effective_sample_size,
+             static_cast<std::size_t>(estimate.is_converged)}
+        );
+    }
+
+    auto name() const noexcept -> const std::string&
+    {
+        return name_;
+    }
+
+    auto estimate() const -> mathtools::BlockingEstimate<FP>
+    {
+        return analysis_.estimate();
+    }
+
+    auto analysis() const noexcept -> const mathtools::StreamingBlockingAnalysis<FP>&
+    {
+        return analysis_;
+    }
+
+    // continue from the analysis of an earlier run of the same simulation
+    void restore(mathtools::StreamingBlockingAnalysis<FP> analysis)
+    {
+        analysis_ = std::move(analysis);
+    }
+
+    auto writer() noexcept -> Writer&
+    {
+        return writer_;
+    }
+
+    auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return analysis_.memory_usage() + writer_.memory_usage();
+    }
+
+private:
+    std::string name_;
+    mathtools::StreamingBlockingAnalysis<FP> analysis_ {};
+    Writer writer_;
+};
+
+/*
+    The statistics of the estimator written to `estimator_filename` go into a file with the same stem,
+    like `kinetic_statistics.dat` for `kinetic.dat`.
+*/
+template <std::floating_point FP>
+auto default_estimator_statistics(
+    std::string name,
+    std::string_view estimator_filename,
+    const std::filesystem::path& output_dirpath
+) -> EstimatorStatistics<FP>
+{
+    auto filename = std::filesystem::path {estimator_filename}.stem();
+    filename += impl_estim_statistics::STATISTICS_FILENAME_SUFFIX;
+
+    return EstimatorStatistics<FP> {std::move(name), output_dirpath / filename};
+}
+
+}  // namespace estim
@@ -1,12 +1,16 @@
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <random>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <torch/script.h>
 
+#include <common/thread_pool.hpp>
 #include <coordinates/box_sides.hpp>
 #include <estimators/pimc/three_body_potential.hpp>
 #include <estimators/pimc/two_body_potential.hpp>
@@ -62,16 +66,31 @@ auto main(int argc, char** argv) -> int
         }
     }();
 
+    /*
+        The buffered four-body potential keeps its samples in a buffer, so it cannot be shared between threads;
+        each thread that evaluates snapshots gets its own instance (and its own energy cache).
+    */
     const long int buffer_size = 1024;
     using ReturnType4B = decltype(interact::get_published_buffered_four_body_potential<NDIM, interact::PermutationTransformerFlag::EXACT>(parser.abs_four_body_filepath, buffer_size));
-    auto pot4b = [&]() -> std::optional<ReturnType4B> {
-        if (parser.evaluate_four_body) {
-            auto pot4b_ = interact::get_published_buffered_four_body_potential<NDIM, interact::PermutationTransformerFlag::EXACT>(parser.abs_four_body_filepath, buffer_size);
-            return std::make_optional(std::move(pot4b_));
-        } else {
-            return std::nullopt;
+    const auto create_pot4b = [&]() -> ReturnType4B {
+        if (parser.four_body_cache_tolerance) {
+            auto cache = interact::FourBodyEnergyCache<float> {*parser.four_body_cache_tolerance, parser.four_body_cache_capacity};
+            return interact::get_published_buffered_four_body_potential<NDIM, interact::PermutationTransformerFlag::EXACT>(parser.abs_four_body_filepath, buffer_size, std::move(cache));
         }
-    }();
+
+        return interact::get_published_buffered_four_body_potential<NDIM, interact::PermutationTransformerFlag::EXACT>(parser.abs_four_body_filepath, buffer_size);
+    };
+
+    auto pool = common::ThreadPool {parser.n_evaluation_threads};
+
+    auto pot4bs = std::vector<ReturnType4B> {};
+    if (parser.evaluate_four_body) {
+        pot4bs.reserve(pool.n_threads());
+        for (std::size_t i_thread {0}; i_thread < pool.n_threads(); ++i_thread) {
+            pot4bs.push_back(create_pot4b());
+        }
+    }
+    // clang-format on
 
     /* create the file writers for the estimators */
     auto pair_potential_writer = estim::default_pair_potential_writer<float>(output_dirpath);
@@ -85,44 +104,88 @@ auto main(int argc, char** argv) -> int
     // const auto quadruplet_filename = estim::writers::DEFAULT_QUADRUPLET_POTENTIAL_OUTPUT_FILENAME;
     // const auto quadruplet_potential_writer = common::writers::SingleValueBlockWriter<float> {output_dirpath / quadruplet_filename, quadruplet_header};
 
-    /* create the timer and the corresponding writer to keep track of how long each block takes */
-    auto timer = sim::Timer {};
+    /* keep track of how long the evaluation of each snapshot takes */
     auto timer_writer = sim::default_timer_writer(output_dirpath);
 
-    for (auto block_index : parser.block_indices) {
-        /* create the worldlines */
-        const auto worldlines = [&]()
-        {
-            const auto worldline_filepath = worldline_writer.output_filepath(block_index);
-            return worldline::read_worldlines<float, NDIM>(worldline_filepath);
-        }();
-
-        timer.start();
+    /*
+        The snapshots are evaluated in batches of one snapshot per thread; each thread reads its own snapshot
+        from disk, so the reads overlap with the evaluations running on the other threads. The results of each
+        batch are written in the order of the block indices, once the whole batch is done.
+    */
+    struct SnapshotResult
+    {
+        float pair_potential_energy {};
+        float triplet_potential_energy {};
+        float quadruplet_potential_energy {};
+        sim::Duration duration {};
+    };
+
+    const auto n_snapshots = parser.block_indices.size();
+    const auto batch_size = pool.n_threads();
+    auto results = std::vector<SnapshotResult>(batch_size);
+
+    for (std::size_t i_batch_start {0}; i_batch_start < n_snapshots; i_batch_start += batch_size) {
+        const auto n_in_batch = std::min(batch_size, n_snapshots - i_batch_start);
 
         // clang-format off
-        /* run estimators */
-        if (pot2b) {
-            const auto total_pair_potential_energy = estim::total_pair_potential_energy_periodic(worldlines, pot2b.value());
-            pair_potential_writer.accumulate({block_index, total_pair_potential_energy});
-            pair_potential_writer.write_and_clear();
-        }
+        pool.parallel_for_with_thread_index(n_in_batch, [&](std::size_t i_item, std::size_t i_thread) {
+            const auto block_index = parser.block_indices[i_batch_start + i_item];
+            const auto worldlines = worldline::read_worldlines<float, NDIM>(worldline_writer.output_filepath(block_index));
+
+            const auto timer = sim::Timer {};
+            auto& result = results[i_item];
 
-        if (pot3b) {
-            const auto total_triplet_potential_energy = estim::total_triplet_potential_energy_periodic(worldlines, pot3b.value());
-            triplet_potential_writer.accumulate({block_index, total_triplet_potential_energy});
-            triplet_potential_writer.write_and_clear();
+            /* run estimators */
+            if (pot2b) {
+                result.pair_potential_energy = estim::total_pair_potential_energy_periodic(worldlines, pot2b.value());
+            }
+
+            if (pot3b) {
+                result.triplet_potential_energy = estim::total_triplet_potential_energy_periodic(worldlines, pot3b.value());
+            }
+
+            if (!pot4bs.empty()) {
+                result.quadruplet_potential_energy = estim::total_quadruplet_potential_energy_periodic(worldlines, pot4bs[i_thread], minimage_box, fourbody_cutoff);
+            }
+
+            result.duration = timer.duration_since_last_start();
+        });
+        // clang-format on
+
+        for (std::size_t i_item {0}; i_item < n_in_batch; ++i_item) {
+            const auto block_index = parser.block_indices[i_batch_start + i_item];
+            const auto& result = results[i_item];
+
+            if (pot2b) {
+                pair_potential_writer.accumulate({block_index, result.pair_potential_energy});
+                pair_potential_writer.write_and_clear();
+            }
+
+            if (pot3b) {
+                triplet_potential_writer.accumulate({block_index, result.triplet_potential_energy});
+                triplet_potential_writer.write_and_clear();
+            }
+
+            if (!pot4bs.empty()) {
+                quadruplet_potential_writer.accumulate({block_index, result.quadruplet_potential_energy});
+                quadruplet_potential_writer.write_and_clear();
+            }
+
+            const auto& duration = result.duration;
+            timer_writer.accumulate({block_index, duration.seconds, duration.milliseconds, duration.microseconds});
+            timer_writer.write_and_clear();
         }
+    }
 
-        if (pot4b) {
-            const auto total_quadruplet_potential_energy = estim::total_quadruplet_potential_energy_periodic(worldlines, pot4b.value(), minimage_box, fourbody_cutoff);
-            quadruplet_potential_writer.accumulate({block_index, total_quadruplet_potential_energy});
-            quadruplet_potential_writer.write_and_clear();
+    if (!pot4bs.empty() && pot4bs.front().cache()) {
+        auto n_hits = std::size_t {0};
+        auto n_misses = std::size_t {0};
+        for (const auto& pot4b : pot4bs) {
+            n_hits += pot4b.cache()->n_hits();
+            n_misses += pot4b.cache()->n_misses();
         }
-        // clang-format on
 
-        const auto duration = timer.duration_since_last_start();
-        timer_writer.accumulate({block_index, duration.seconds, duration.milliseconds, duration.microseconds});
-        timer_writer.write_and_clear();
+        std::cout << "four-body energy cache: " << n_hits << " hits, " << n_misses << " misses\n";
     }
 
     return 0;
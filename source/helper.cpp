@@ -24,6 +24,7 @@
 #include <rng/prng_state.hpp>
 #include <simulation/continue.hpp>
 #include <worldline/worldline.hpp>
+#include <worldline/writers/read_worldlines.hpp>
 #include <worldline/writers/worldline_writer.hpp>
 
 constexpr auto build_hcp_lattice_structure(
@@ -51,14 +52,16 @@ constexpr auto build_hcp_lattice_structure(
 template <std::floating_point FP>
 auto fsh_potential(auto minimage_box, auto two_body_filepath)
 {
-    auto distance_pot = interact::two_body_schmidt2015<FP>(two_body_filepath);
+    auto distance_pot = interact::two_body_schmidt2015<FP>(two_body_filepath, interact::TableCacheStatus::ON);
 
     return interact::PeriodicTwoBodySquaredPointPotential {std::move(distance_pot), minimage_box};
 }
 
 auto threebodyparah2_potential(auto minimage_box, auto three_body_filepath)
 {
-    auto distance_pot = interact::three_body_ibrahim2022<float>(three_body_filepath);
+    // the three-body grid is large, so concurrent processes share one copy of it
+    const auto cache_status = interact::TableCacheStatus::SHARED;
+    auto distance_pot = interact::three_body_ibrahim2022<float>(three_body_filepath, std::nullopt, cache_status);
 
     return interact::PeriodicThreeBodyPointPotential {std::move(distance_pot), minimage_box};
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <concepts>
 #include <stdexcept>
@@ -28,24 +29,23 @@ constexpr auto convert_to_magnitude_and_direction(const coord::Cartesian<FP, NDI
     return {unit_vec, distance};
 }
 
-template <std::floating_point FP, std::size_t NDIM>
-constexpr auto quadruplet_contribution(
-    const MagnitudeAndDirection<FP, NDIM>& vec_ij,
-    const MagnitudeAndDirection<FP, NDIM>& vec_jk,
-    const MagnitudeAndDirection<FP, NDIM>& vec_kl,
-    const MagnitudeAndDirection<FP, NDIM>& vec_li
-) -> FP
+/*
+    The contribution of a single cycle of four vectors, given the product of their magnitudes, and the
+    dot products between each pair of their unit vectors.
+*/
+template <std::floating_point FP>
+constexpr auto quadruplet_contribution_from_products(
+    FP prod_of_mags,
+    FP prod_ijjk,
+    FP prod_ijkl,
+    FP prod_ijli,
+    FP prod_jkkl,
+    FP prod_jkli,
+    FP prod_klli
+) noexcept -> FP
 {
-    const auto prod_of_mags = vec_ij.magnitude * vec_jk.magnitude * vec_kl.magnitude * vec_li.magnitude;
     const auto denominator = prod_of_mags * prod_of_mags * prod_of_mags;
 
-    const auto prod_ijjk = coord::dot_product(vec_ij.direction, vec_jk.direction);
-    const auto prod_ijkl = coord::dot_product(vec_ij.direction, vec_kl.direction);
-    const auto prod_ijli = coord::dot_product(vec_ij.direction, vec_li.direction);
-    const auto prod_jkkl = coord::dot_product(vec_jk.direction, vec_kl.direction);
-    const auto prod_jkli = coord::dot_product(vec_jk.direction, vec_li.direction);
-    const auto prod_klli = coord::dot_product(vec_kl.direction, vec_li.direction);
-
     // clang-format off
     auto numerator =
         - FP{1.0}
@@ -65,6 +65,92 @@ constexpr auto quadruplet_contribution(
     return FP {2.0} * numerator / denominator;
 }
 
+template <std::floating_point FP, std::size_t NDIM>
+constexpr auto quadruplet_contribution(
+    const MagnitudeAndDirection<FP, NDIM>& vec_ij,
+    const MagnitudeAndDirection<FP, NDIM>& vec_jk,
+    const MagnitudeAndDirection<FP, NDIM>& vec_kl,
+    const MagnitudeAndDirection<FP, NDIM>& vec_li
+) -> FP
+{
+    const auto prod_of_mags = vec_ij.magnitude * vec_jk.magnitude * vec_kl.magnitude * vec_li.magnitude;
+
+    const auto prod_ijjk = coord::dot_product(vec_ij.direction, vec_jk.direction);
+    const auto prod_ijkl = coord::dot_product(vec_ij.direction, vec_kl.direction);
+    const auto prod_ijli = coord::dot_product(vec_ij.direction, vec_li.direction);
+    const auto prod_jkkl = coord::dot_product(vec_jk.direction, vec_kl.direction);
+    const auto prod_jkli = coord::dot_product(vec_jk.direction, vec_li.direction);
+    const auto prod_klli = coord::dot_product(vec_kl.direction, vec_li.direction);
+
+    return quadruplet_contribution_from_products(
+        prod_of_mags, prod_ijjk, prod_ijkl, prod_ijli, prod_jkkl, prod_jkli, prod_klli
+    );
+}
+
+/*
+    The squared side lengths and side lengths between each pair of the four points, stored as 4x4 tables
+    so that they can be looked up by the indices of the points.
+*/
+template <std::floating_point FP>
+struct SideLengthTables
+{
+    explicit constexpr SideLengthTables(const std::array<FP, 6>& side_lengths) noexcept
+    {
+        // the order of the side lengths is (01, 02, 03, 12, 13, 23)
+        constexpr auto pairs = std::array<std::array<std::size_t, 2>, 6> {
+            {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}}
+        };
+
+        for (std::size_t i_pair {0}; i_pair < 6; ++i_pair) {
+            const auto [i, j] = pairs[i_pair];
+            const auto side = side_lengths[i_pair];
+            dist[i][j] = side;
+            dist[j][i] = side;
+            dist_sq[i][j] = side * side;
+            dist_sq[j][i] = side * side;
+        }
+    }
+
+    /*
+        The dot product between the unit vectors along (p_a - p_b) and (p_c - p_d); with the points written
+        in terms of their pair distances, the dot product of the vectors themselves is
+            (r_ad^2 + r_bc^2 - r_ac^2 - r_bd^2) / 2
+    */
+    constexpr auto unit_dot(std::size_t a, std::size_t b, std::size_t c, std::size_t d) const noexcept -> FP
+    {
+        const auto dot = FP {0.5} * (dist_sq[a][d] + dist_sq[b][c] - dist_sq[a][c] - dist_sq[b][d]);
+        return dot / (dist[a][b] * dist[c][d]);
+    }
+
+    /*
+        The side length counterpart of `quadruplet_contribution()`; each of the four vectors is passed
+        as a pair of point indices {a, b}, representing the vector (p_a - p_b).
+    */
+    constexpr auto cycle_contribution(
+        std::array<std::size_t, 2> ij,
+        std::array<std::size_t, 2> jk,
+        std::array<std::size_t, 2> kl,
+        std::array<std::size_t, 2> li
+    ) const noexcept -> FP
+    {
+        const auto prod_of_mags = dist[ij[0]][ij[1]] * dist[jk[0]][jk[1]] * dist[kl[0]][kl[1]] * dist[li[0]][li[1]];
+
+        const auto prod_ijjk = unit_dot(ij[0], ij[1], jk[0], jk[1]);
+        const auto prod_ijkl = unit_dot(ij[0], ij[1], kl[0], kl[1]);
+        const auto prod_ijli = unit_dot(ij[0], ij[1], li[0], li[1]);
+        const auto prod_jkkl = unit_dot(jk[0], jk[1], kl[0], kl[1]);
+        const auto prod_jkli = unit_dot(jk[0], jk[1], li[0], li[1]);
+        const auto prod_klli = unit_dot(kl[0], kl[1], li[0], li[1]);
+
+        return quadruplet_contribution_from_products(
+            prod_of_mags, prod_ijjk, prod_ijkl, prod_ijli, prod_jkkl, prod_jkli, prod_klli
+        );
+    }
+
+    std::array<std::array<FP, 4>, 4> dist {};
+    std::array<std::array<FP, 4>, 4> dist_sq {};
+};
+
 }  // namespace impl_interact_dispersion
 
 namespace interact
@@ -107,6 +193,26 @@ public:
         return -bade_coefficient_ * total_energy;
     }
 
+    /*
+        Evaluate the dispersion energy directly from the six side lengths (01, 02, 03, 12, 13, 23), without
+        first reconstructing a set of Cartesian points that have those side lengths; all the dot products
+        between the pair vectors can be written in terms of the squared side lengths.
+    */
+    constexpr auto operator()(const std::array<FP, 6>& side_lengths) const noexcept -> FP
+    {
+        const auto tables = impl_interact_dispersion::SideLengthTables<FP> {side_lengths};
+
+        // the same three cycles as in the Cartesian version: (30, 32, 21, 10), (20, 32, 31, 10), (20, 21, 31, 30)
+        // clang-format off
+        const auto total_energy =
+              tables.cycle_contribution({3, 0}, {3, 2}, {2, 1}, {1, 0})
+            + tables.cycle_contribution({2, 0}, {3, 2}, {3, 1}, {1, 0})
+            + tables.cycle_contribution({2, 0}, {2, 1}, {3, 1}, {3, 0});
+        // clang-format on
+
+        return -bade_coefficient_ * total_energy;
+    }
+
 private:
     FP bade_coefficient_;
 
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <common/memory_usage.hpp>
+#include <coordinates/attard/four_body.hpp>
+#include <interactions/four_body/permutations.hpp>
+
+namespace impl_interact_energy_cache
+{
+
+using QuantizedSideLengths = std::array<std::int64_t, 6>;
+
+struct QuantizedSideLengthsHash
+{
+    auto operator()(const QuantizedSideLengths& key) const noexcept -> std::size_t
+    {
+        // FNV-1a style mixing of the six quantized side lengths
+        auto hash = std::uint64_t {14695981039346656037ULL};
+        for (auto value : key) {
+            hash ^= static_cast<std::uint64_t>(value);
+            hash *= std::uint64_t {1099511628211ULL};
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+};
+
+}  // namespace impl_interact_energy_cache
+
+namespace interact
+{
+
+/*
+    The FourBodyEnergyCache stores the four-body interaction energies of samples that have already been
+    evaluated, so that nearly identical samples do not have to be passed through the neural network again.
+
+    Each sample is keyed on its six side lengths, quantized to multiples of `tolerance`, and brought
+    into a canonical order over the 24 relabellings of the four particles. Two samples whose side lengths
+    fall into the same bins share an energy, so `tolerance` controls the trade-off between accuracy and
+    throughput.
+
+    Once `capacity` entries are stored, the least recently used entry is evicted to make room.
+*/
+template <std::floating_point FP>
+class FourBodyEnergyCache
+{
+public:
+    using Key = impl_interact_energy_cache::QuantizedSideLengths;
+
+    FourBodyEnergyCache(FP tolerance, std::size_t capacity)
+        : tolerance_ {tolerance}
+        , capacity_ {capacity}
+    {
+        ctr_check_tolerance_positive_(tolerance_);
+        ctr_check_capacity_positive_(capacity_);
+
+        entries_.reserve(capacity_);
+    }
+
+    auto key(const coord::FourBodySideLengths<FP>& side_lengths) const noexcept -> Key
+    {
+        const auto sides = std::array<FP, 6> {
+            side_lengths.dist01,
+            side_lengths.dist02,
+            side_lengths.dist03,
+            side_lengths.dist12,
+            side_lengths.dist13,
+            side_lengths.dist23};
+
+        auto quantized = Key {};
+        for (std::size_t i {0}; i < 6; ++i) {
+            quantized[i] = static_cast<std::int64_t>(std::llround(sides[i] / tolerance_));
+        }
+
+        // the quantized values are integers, so a plain lexicographic comparison is enough here
+        auto canonical = quantized;
+        for (std::size_t i_perm {1}; i_perm < trans::g_n_permutations; ++i_perm) {
+            canonical = std::min(canonical, trans::permute_six_side_lengths(i_perm, quantized));
+        }
+
+        return canonical;
+    }
+
+    auto find(const Key& key) -> std::optional<FP>
+    {
+        const auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            ++n_misses_;
+            return std::nullopt;
+        }
+
+        ++n_hits_;
+        recently_used_.splice(recently_used_.begin(), recently_used_, it->second);
+
+        return it->second->second;
+    }
+
+    void insert(const Key& key, FP energy)
+    {
+        const auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            it->second->second = energy;
+            recently_used_.splice(recently_used_.begin(), recently_used_, it->second);
+            return;
+        }
+
+        if (entries_.size() == capacity_) {
+            entries_.erase(recently_used_.back().first);
+            recently_used_.pop_back();
+        }
+
+        recently_used_.emplace_front(key, energy);
+        entries_.emplace(key, recently_used_.begin());
+    }
+
+    void clear() noexcept
+    {
+        entries_.clear();
+        recently_used_.clear();
+    }
+
+    void reset_counters() noexcept
+    {
+        n_hits_ = 0;
+        n_misses_ = 0;
+    }
+
+    constexpr auto n_hits() const noexcept -> std::size_t
+    {
+        return n_hits_;
+    }
+
+    constexpr auto n_misses() const noexcept -> std::size_t
+    {
+        return n_misses_;
+    }
+
+    auto size() const noexcept -> std::size_t
+    {
+        return entries_.size();
+    }
+
+    constexpr auto capacity() const noexcept -> std::size_t
+    {
+        return capacity_;
+    }
+
+    constexpr auto tolerance() const noexcept -> FP
+    {
+        return tolerance_;
+    }
+
+    /*
+        An estimate, since the layout of the nodes is up to the standard library: each entry is a node of
+        the list (the entry and two links) and a node of the map (the key, the iterator, a link, and the
+        cached hash), and the map also holds one pointer per bucket.
+    */
+    auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        constexpr auto list_node_bytes = sizeof(Entry) + 2 * sizeof(void*);
+        constexpr auto map_node_bytes = sizeof(Key) + sizeof(EntryIterator) + sizeof(void*) + sizeof(std::size_t);
+
+        const auto entry_bytes = entries_.size() * (list_node_bytes + map_node_bytes);
+        const auto bucket_bytes = entries_.bucket_count() * sizeof(void*);
+
+        return common::MemoryUsage {entry_bytes + bucket_bytes, 0};
+    }
+
+private:
+    using Entry = std::pair<Key, FP>;
+    using EntryIterator = typename std::list<Entry>::iterator;
+
+    FP tolerance_;
+    std::size_t capacity_;
+    std::size_t n_hits_ {0};
+    std::size_t n_misses_ {0};
+    std::list<Entry> recently_used_ {};
+    std::unordered_map<Key, EntryIterator, impl_interact_energy_cache::QuantizedSideLengthsHash> entries_ {};
+
+    void ctr_check_tolerance_positive_(FP tolerance) const
+    {
+        if (tolerance <= FP {0.0}) {
+            auto err_msg = std::stringstream {};
+            err_msg << "The tolerance of the four-body energy cache must be positive.\n";
+            err_msg << "Found: " << tolerance << '\n';
+            throw std::runtime_error {err_msg.str()};
+        }
+    }
+
+    void ctr_check_capacity_positive_(std::size_t capacity) const
+    {
+        if (capacity == 0) {
+            throw std::runtime_error {"The four-body energy cache must be able to hold at least one entry.\n"};
+        }
+    }
+};
+
+}  // namespace interact
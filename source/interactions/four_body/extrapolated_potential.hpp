@@ -2,21 +2,27 @@
 
 #include <algorithm>
 #include <array>
+#include <optional>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include <torch/script.h>
 
+#include <common/memory_usage.hpp>
+#include <common/trace_events.hpp>
 #include <coordinates/attard/four_body.hpp>
 #include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
 #include <interactions/four_body/constants.hpp>
+#include <interactions/four_body/energy_cache.hpp>
 #include <interactions/four_body/interaction_ranges.hpp>
 #include <interactions/four_body/long_range.hpp>
 #include <interactions/four_body/rescaling.hpp>
 #include <interactions/four_body/short_range.hpp>
 #include <interactions/four_body/transformers.hpp>
+#include <interactions/interaction_counters.hpp>
 
 namespace interact
 {
@@ -143,6 +149,20 @@ public:
         return output_energies;
     }
 
+    /*
+        The energies of long-range samples come entirely from the dispersion potential, so they can be
+        evaluated directly from the side lengths without going through the tensor pipeline.
+    */
+    constexpr auto evaluate_long_range(const std::array<FP, 6>& side_lengths) const -> FP
+    {
+        return long_range_corrector_.dispersion(side_lengths);
+    }
+
+    auto memory_usage() const -> common::MemoryUsage
+    {
+        return rescaling_model_.memory_usage();
+    }
+
 private:
     RescalingModel rescaling_model_;
     InputSampleTransformer transformer_;
@@ -256,13 +276,18 @@ private:
 
     constexpr auto transform_batch_sidelengths_(torch::Tensor& batch_sidelengths) const -> void
     {
-        const long int batch_size = batch_sidelengths.size(0);
-        const long int sample_size = batch_sidelengths.size(1);
-
-        for (long int i_batch {}; i_batch < batch_size; ++i_batch) {
-            auto sample = batch_sidelengths[i_batch];
-            sample = sample.view({sample_size});
-            transformer_(sample);
+        if constexpr (trans::BatchTransformable<InputSampleTransformer>) {
+            transformer_.transform_batch(batch_sidelengths);
+        }
+        else {
+            const long int batch_size = batch_sidelengths.size(0);
+            const long int sample_size = batch_sidelengths.size(1);
+
+            for (long int i_batch {}; i_batch < batch_size; ++i_batch) {
+                auto sample = batch_sidelengths[i_batch];
+                sample = sample.view({sample_size});
+                transformer_(sample);
+            }
         }
     }
 };
@@ -272,6 +297,7 @@ class BufferedExtrapolatedPotential
 {
 public:
     using ExtrapPotential = ExtrapolatedPotential<FP, NDIM, InputSampleTransformer>;
+    using EnergyCache = FourBodyEnergyCache<FP>;
 
     explicit BufferedExtrapolatedPotential(ExtrapPotential extrap_pot, long int buffer_size)
         : extrap_pot_ {std::move(extrap_pot)}
@@ -281,10 +307,56 @@ public:
     {
         ctr_check_buffer_size_positive_(buffer_size);
         sample_buffer_ = torch::empty({buffer_size, 6});
+        sample_weights_.resize(static_cast<std::size_t>(buffer_size));
+    }
+
+    /*
+        Samples whose energies are found in the cache are not added to the buffer at all; the energies
+        of all other samples are added to the cache once the buffer is evaluated.
+    */
+    BufferedExtrapolatedPotential(ExtrapPotential extrap_pot, long int buffer_size, EnergyCache cache)
+        : BufferedExtrapolatedPotential {std::move(extrap_pot), buffer_size}
+    {
+        cache_ = std::move(cache);
+        buffered_keys_.reserve(static_cast<std::size_t>(buffer_size));
     }
 
     constexpr void add_sample(const coord::FourBodySideLengths<FP>& side_lengths)
     {
+        add_sample(side_lengths, FP {1.0});
+    }
+
+    /*
+        The energy of the sample is multiplied by `weight` before it is added to the total energy.
+    */
+    constexpr void add_sample(const coord::FourBodySideLengths<FP>& side_lengths, FP weight)
+    {
+        // long-range samples are evaluated immediately, and never take up space in the buffer
+        const auto sides = std::array<FP, 6> {
+            side_lengths.dist01,
+            side_lengths.dist02,
+            side_lengths.dist03,
+            side_lengths.dist12,
+            side_lengths.dist13,
+            side_lengths.dist23};
+
+        const auto irange = interact_ranges::classify_interaction_range(sides.data(), sides.data() + sides.size());
+        count_sample_(irange);
+
+        if (irange == interact_ranges::InteractionRange::LONG) {
+            total_energy_ += weight * extrap_pot_.evaluate_long_range(sides);
+            return;
+        }
+
+        auto key = typename EnergyCache::Key {};
+        if (cache_) {
+            key = cache_->key(side_lengths);
+            if (const auto cached_energy = cache_->find(key)) {
+                total_energy_ += weight * (*cached_energy);
+                return;
+            }
+        }
+
         if (number_of_samples_ == buffer_size_) {
             total_energy_ += evaluate_buffer_(number_of_samples_);
             number_of_samples_ = 0;
@@ -296,6 +368,11 @@ public:
         sample_buffer_[number_of_samples_][3] = side_lengths.dist12;
         sample_buffer_[number_of_samples_][4] = side_lengths.dist13;
         sample_buffer_[number_of_samples_][5] = side_lengths.dist23;
+        sample_weights_[static_cast<std::size_t>(number_of_samples_)] = weight;
+
+        if (cache_) {
+            buffered_keys_.push_back(key);
+        }
 
         ++number_of_samples_;
     }
@@ -313,12 +390,34 @@ public:
         return energy_to_return;
     }
 
+    constexpr auto cache() const noexcept -> const std::optional<EnergyCache>&
+    {
+        return cache_;
+    }
+
+    // the network, the sample buffer, and the cache
+    auto memory_usage() const -> common::MemoryUsage
+    {
+        auto usage = extrap_pot_.memory_usage();
+        usage.owned_bytes += sample_buffer_.nbytes();
+        usage += common::vector_memory_usage(sample_weights_);
+        usage += common::vector_memory_usage(buffered_keys_);
+        if (cache_) {
+            usage += cache_->memory_usage();
+        }
+
+        return usage;
+    }
+
 private:
     ExtrapPotential extrap_pot_;
     long int buffer_size_;
     long int number_of_samples_;
     FP total_energy_;
     torch::Tensor sample_buffer_;
+    std::vector<FP> sample_weights_ {};
+    std::optional<EnergyCache> cache_ {std::nullopt};
+    std::vector<typename EnergyCache::Key> buffered_keys_ {};
 
     constexpr auto ctr_check_buffer_size_positive_(long int buffer_size) const -> void
     {
@@ -327,13 +426,46 @@ private:
         }
     }
 
-    constexpr auto evaluate_buffer_(long int number_of_samples) const -> FP
+    static void count_sample_(interact_ranges::InteractionRange irange)
+    {
+        using IC = InteractionCounter;
+        using IR = interact_ranges::InteractionRange;
+
+        // the counters for the interaction ranges are in the same order as the ranges themselves
+        static_assert(
+            static_cast<std::size_t>(IC::QUADRUPLET_LONG) - static_cast<std::size_t>(IC::QUADRUPLET_ABINITIO_SHORT)
+            == static_cast<std::size_t>(IR::LONG) - static_cast<std::size_t>(IR::ABINITIO_SHORT)
+        );
+
+        const auto i_range = static_cast<std::size_t>(irange) - static_cast<std::size_t>(IR::ABINITIO_SHORT);
+        const auto range_counter = static_cast<IC>(static_cast<std::size_t>(IC::QUADRUPLET_ABINITIO_SHORT) + i_range);
+
+        count_interaction(IC::QUADRUPLET_EVALUATIONS);
+        count_interaction(range_counter);
+    }
+
+    constexpr auto evaluate_buffer_(long int number_of_samples) -> FP
     {
         using namespace torch::indexing;
 
+        const auto trace = common::trace::TraceScope {"evaluate_four_body_buffer", "n_samples", number_of_samples};
+
         const auto energies = extrap_pot_.evaluate_batch(sample_buffer_.index({Slice(None, number_of_samples)}));
+        const auto* energies_ptr = energies.template data_ptr<FP>();
+
+        if (cache_) {
+            for (std::size_t i_sample {0}; i_sample < buffered_keys_.size(); ++i_sample) {
+                cache_->insert(buffered_keys_[i_sample], energies_ptr[i_sample]);
+            }
+            buffered_keys_.clear();
+        }
 
-        return torch::sum(energies).template item<FP>();
+        auto total_energy = FP {0.0};
+        for (std::size_t i_sample {0}; i_sample < static_cast<std::size_t>(number_of_samples); ++i_sample) {
+            total_energy += sample_weights_[i_sample] * energies_ptr[i_sample];
+        }
+
+        return total_energy;
     }
 };
 
@@ -365,6 +497,11 @@ public:
         return extrap_pot_.extract_energy();
     }
 
+    auto memory_usage() const -> common::MemoryUsage
+    {
+        return extrap_pot_.memory_usage();
+    }
+
 private:
     BufferedExtrapPotential extrap_pot_;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <concepts>
 #include <tuple>
 #include <type_traits>
@@ -44,8 +45,7 @@ public:
     constexpr auto dispersion(const Container& pair_distances) const -> FP
     {
         const auto& [r01, r02, r03, r12, r13, r23] = unpack_six_side_lengths_<Container>(pair_distances);
-        const auto& [p0, p1, p2, p3] = coord::six_side_lengths_to_cartesian<FP, NDIM>(r01, r02, r03, r12, r13, r23);
-        return dispersion(p0, p1, p2, p3);
+        return dispersion_potential_(std::array<FP, 6> {r01, r02, r03, r12, r13, r23});
     }
 
     template <typename Container>
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+
+/*
+    The permutation machinery used to bring the six side lengths of a four-body sample into a
+    canonical order. Everything in this file is independent of torch, so it can be used (and tested)
+    on plain arrays of side lengths.
+*/
+
+namespace impl_interact_trans
+{
+
+/*
+Perform a lexicographic comparison of two `std::array<FP, 6>` instances, but only consider an element
+in the left instance to be less than its corresponding element on the right instance if the absolute
+difference between the two is great enough.
+*/
+template <std::floating_point FP>
+class LessThanEpsilon
+{
+public:
+    explicit LessThanEpsilon(FP epsilon)
+        : epsilon_ {epsilon}
+    {
+        if (epsilon_ <= FP {0.0}) {
+            throw std::runtime_error("The value of `epsilon` provided to LessThanEpsilon must be positive.");
+        }
+    }
+
+    constexpr auto operator()(const std::array<FP, 6>& left, const std::array<FP, 6>& right) const noexcept -> bool
+    {
+        for (std::size_t i {0}; i < 6; ++i) {
+            const auto left_val = left[i];
+            const auto right_val = right[i];
+
+            if (std::abs(left_val - right_val) > epsilon_) {
+                return left_val < right_val;
+            }
+        }
+
+        return false;
+    }
+
+    constexpr auto epsilon() const noexcept -> FP
+    {
+        return epsilon_;
+    }
+
+private:
+    FP epsilon_;
+};
+
+}  // namespace impl_interact_trans
+
+namespace interact
+{
+
+namespace trans
+{
+
+constexpr static auto g_n_permutations = std::size_t {24};
+
+// clang-format off
+constexpr static auto g_index_swap_permutations = std::array<std::size_t, 6 * 24> {
+    0, 1, 2, 3, 4, 5,
+    0, 2, 1, 4, 3, 5,
+    0, 3, 4, 1, 2, 5,
+    0, 4, 3, 2, 1, 5,
+    1, 0, 2, 3, 5, 4,
+    1, 2, 0, 5, 3, 4,
+    1, 3, 5, 0, 2, 4,
+    1, 5, 3, 2, 0, 4,
+    2, 0, 1, 4, 5, 3,
+    2, 1, 0, 5, 4, 3,
+    2, 4, 5, 0, 1, 3,
+    2, 5, 4, 1, 0, 3,
+    3, 0, 4, 1, 5, 2,
+    3, 1, 5, 0, 4, 2,
+    3, 4, 0, 5, 1, 2,
+    3, 5, 1, 4, 0, 2,
+    4, 0, 3, 2, 5, 1,
+    4, 2, 5, 0, 3, 1,
+    4, 3, 0, 5, 2, 1,
+    4, 5, 2, 3, 0, 1,
+    5, 1, 3, 2, 4, 0,
+    5, 2, 4, 1, 3, 0,
+    5, 3, 1, 4, 2, 0,
+    5, 4, 2, 3, 1, 0
+};
+// clang-format on
+
+template <typename T>
+constexpr auto permute_six_side_lengths(std::size_t i_permutation, const std::array<T, 6>& side_lengths) noexcept
+    -> std::array<T, 6>
+{
+    std::array<T, 6> permuted_side_lengths;
+    auto i_offset = i_permutation * 6;
+
+    for (std::size_t i {}; i < 6; ++i) {
+        auto index_to_swap = g_index_swap_permutations[i_offset + i];
+        permuted_side_lengths[i] = side_lengths[index_to_swap];
+    }
+
+    return permuted_side_lengths;
+}
+
+/*
+    Search through all 24 permutations of the side lengths, in the order they appear in
+    `g_index_swap_permutations`, and return the smallest one according to `comparator`.
+*/
+template <std::floating_point FP>
+constexpr auto minimum_permutation(
+    const std::array<FP, 6>& side_lengths,
+    const impl_interact_trans::LessThanEpsilon<FP>& comparator
+) noexcept -> std::array<FP, 6>
+{
+    auto minimum_permuted = std::array<FP, 6>(side_lengths);
+
+    for (std::size_t i_perm {1}; i_perm < g_n_permutations; ++i_perm) {
+        const auto permuted = permute_six_side_lengths(i_perm, side_lengths);
+        minimum_permuted = std::min(minimum_permuted, permuted, comparator);
+    }
+
+    return minimum_permuted;
+}
+
+/*
+    The BatchMinimumPermutationTransformer gives exactly the same result as calling `minimum_permutation()`
+    on each sample, but works on an entire batch of samples at once, stored contiguously as an (N, 6) array.
+
+    The comparator is not transitive (two side lengths within `epsilon` of each other are treated as
+    equal), so the result depends on the order in which the permutations are visited; to reproduce
+    the exact transformer, the same 24 permutations are visited in the same order. The speedup comes
+    from how the work is laid out:
+      - the samples are processed in chunks, and each chunk is transposed so that each of the six side
+        lengths is contiguous across samples
+      - the comparison and the selection of the new minimum are done without branching, so the
+        innermost loops (over the samples in the chunk) can be vectorized by the compiler
+*/
+template <std::floating_point FP>
+class BatchMinimumPermutationTransformer
+{
+public:
+    explicit BatchMinimumPermutationTransformer(const impl_interact_trans::LessThanEpsilon<FP>& comparator)
+        : epsilon_ {comparator.epsilon()}
+    {}
+
+    void operator()(FP* samples, std::size_t n_samples) const noexcept
+    {
+        for (std::size_t i_start {0}; i_start < n_samples; i_start += CHUNK_SIZE_) {
+            const auto n_lanes = std::min(CHUNK_SIZE_, n_samples - i_start);
+            transform_chunk_(samples + 6 * i_start, n_lanes);
+        }
+    }
+
+private:
+    constexpr static auto CHUNK_SIZE_ = std::size_t {64};
+    using Lanes = std::array<FP, CHUNK_SIZE_>;
+    using Flags = std::array<bool, CHUNK_SIZE_>;
+
+    FP epsilon_;
+
+    void transform_chunk_(FP* chunk, std::size_t n_lanes) const noexcept
+    {
+        auto original = std::array<Lanes, 6> {};
+        for (std::size_t i_lane {0}; i_lane < n_lanes; ++i_lane) {
+            for (std::size_t i_side {0}; i_side < 6; ++i_side) {
+                original[i_side][i_lane] = chunk[6 * i_lane + i_side];
+            }
+        }
+
+        // the identity permutation is the first candidate, just like in `minimum_permutation()`
+        auto minimum = original;
+
+        for (std::size_t i_perm {1}; i_perm < g_n_permutations; ++i_perm) {
+            const auto* indices = &g_index_swap_permutations[6 * i_perm];
+
+            // equivalent to `comparator(permuted, minimum)`, evaluated for every lane at once
+            auto is_less = Flags {};
+            auto is_decided = Flags {};
+            for (std::size_t i_side {0}; i_side < 6; ++i_side) {
+                const auto& permuted_side = original[indices[i_side]];
+                const auto& minimum_side = minimum[i_side];
+
+                for (std::size_t i_lane {0}; i_lane < n_lanes; ++i_lane) {
+                    const auto permuted_val = permuted_side[i_lane];
+                    const auto minimum_val = minimum_side[i_lane];
+                    const bool is_significant = std::abs(permuted_val - minimum_val) > epsilon_;
+                    const bool is_smaller = permuted_val < minimum_val;
+
+                    is_less[i_lane] = is_less[i_lane] | (!is_decided[i_lane] & is_significant & is_smaller);
+                    is_decided[i_lane] = is_decided[i_lane] | is_significant;
+                }
+            }
+
+            for (std::size_t i_side {0}; i_side < 6; ++i_side) {
+                const auto& permuted_side = original[indices[i_side]];
+                auto& minimum_side = minimum[i_side];
+
+                for (std::size_t i_lane {0}; i_lane < n_lanes; ++i_lane) {
+                    minimum_side[i_lane] = is_less[i_lane] ? permuted_side[i_lane] : minimum_side[i_lane];
+                }
+            }
+        }
+
+        for (std::size_t i_lane {0}; i_lane < n_lanes; ++i_lane) {
+            for (std::size_t i_side {0}; i_side < 6; ++i_side) {
+                chunk[6 * i_lane + i_side] = minimum[i_side][i_lane];
+            }
+        }
+    }
+};
+
+}  // namespace trans
+
+}  // namespace interact
@@ -20,6 +20,19 @@ concept BufferedQuadrupletPotential = requires(Potential pot) {
     } -> std::same_as<FP>;
 };
 
+/*
+    A buffered potential where each sample can be given a weight; the energy extracted is the weighted
+    sum of the energies of the samples. This lets energies with opposite signs (for example, the energies
+    before and after a move) be evaluated in the same batch.
+*/
+template <typename Potential, typename FP>
+concept WeightedBufferedQuadrupletPotential = requires(Potential pot) {
+    requires BufferedQuadrupletPotential<Potential, FP>;
+    {
+        pot.add_sample(coord::FourBodySideLengths<FP> {}, FP {})
+    } -> std::same_as<void>;
+};
+
 template <typename Potential, typename FP, std::size_t NDIM>
 concept BufferedQuadrupletPointPotential = requires(Potential pot) {
     requires std::is_floating_point_v<FP>;
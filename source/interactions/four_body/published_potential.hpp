@@ -11,6 +11,7 @@
 
 #include <coordinates/attard/four_body.hpp>
 #include <interactions/four_body/constants.hpp>
+#include <interactions/four_body/energy_cache.hpp>
 #include <interactions/four_body/extrapolated_potential.hpp>
 #include <interactions/four_body/interaction_ranges.hpp>
 #include <interactions/four_body/long_range.hpp>
@@ -134,6 +135,18 @@ auto get_published_buffered_four_body_potential(const std::filesystem::path& res
     return interact::BufferedExtrapolatedPotential {std::move(extrap_pot), buffer_size};
 }
 
+template <std::size_t NDIM, interact::PermutationTransformerFlag Flag>
+auto get_published_buffered_four_body_potential(
+    const std::filesystem::path& rescaled_module_path,
+    long int buffer_size,
+    interact::FourBodyEnergyCache<float> cache
+)
+{
+    auto extrap_pot = get_published_four_body_potential<NDIM, Flag>(rescaled_module_path);
+
+    return interact::BufferedExtrapolatedPotential {std::move(extrap_pot), buffer_size, std::move(cache)};
+}
+
 template <std::size_t NDIM, interact::PermutationTransformerFlag Flag>
 auto get_published_buffered_four_body_point_potential(
     const std::filesystem::path& rescaled_module_path,
@@ -10,6 +10,8 @@
 
 #include <torch/script.h>
 
+#include <common/memory_usage.hpp>
+
 namespace interact
 {
 
@@ -224,6 +226,20 @@ public:
         return rescaled_energies;
     }
 
+    // the weights and buffers of the network; the memory used by the torch runtime itself is not counted
+    auto memory_usage() const -> common::MemoryUsage
+    {
+        auto usage = common::MemoryUsage {};
+        for (const auto& parameter : rescaled_module_.parameters()) {
+            usage.owned_bytes += parameter.nbytes();
+        }
+        for (const auto& buffer : rescaled_module_.buffers()) {
+            usage.owned_bytes += buffer.nbytes();
+        }
+
+        return usage;
+    }
+
 private:
     mutable torch::jit::script::Module rescaled_module_;  // .forward() is not const
     ReverseEnergyRescaler<FP> reverse_rescaler_;
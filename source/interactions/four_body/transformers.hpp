@@ -10,52 +10,13 @@
 
 #include <torch/script.h>
 
-/*
-    TODO: the MinimumPermutationTransformer can be optimized to not have to search through all 24
-    different permutations; really, only the smallest element, then the 2nd smallest element, are needed
-
-    But I just need to get it working for now
-*/
-
-namespace impl_interact_trans
-{
+#include <interactions/four_body/permutations.hpp>
 
 /*
-Perform a lexicographic comparison of two `std::array<FP, 6>` instances, but only consider an element
-in the left instance to be less than its corresponding element on the right instance if the absolute
-difference between the two is great enough.
+    NOTE: the MinimumPermutationTransformer searches through all 24 permutations for each sample on its
+    own; to transform a whole batch of samples at once, use the `BatchMinimumPermutationTransformer` in
+    `permutations.hpp`, which gives exactly the same result
 */
-template <std::floating_point FP>
-class LessThanEpsilon
-{
-public:
-    explicit LessThanEpsilon(FP epsilon)
-        : epsilon_ {epsilon}
-    {
-        if (epsilon_ <= FP {0.0}) {
-            throw std::runtime_error("The value of `epsilon` provided to LessThanEpsilon must be positive.");
-        }
-    }
-
-    constexpr auto operator()(const std::array<FP, 6>& left, const std::array<FP, 6>& right) const noexcept -> bool
-    {
-        for (std::size_t i {0}; i < 6; ++i) {
-            const auto left_val = left[i];
-            const auto right_val = right[i];
-
-            if (std::abs(left_val - right_val) > epsilon_) {
-                return left_val < right_val;
-            }
-        }
-
-        return false;
-    }
-
-private:
-    FP epsilon_;
-};
-
-}  // namespace impl_interact_trans
 
 namespace interact
 {
@@ -63,37 +24,6 @@ namespace interact
 namespace trans
 {
 
-constexpr static auto g_n_permutations = std::size_t {24};
-
-// clang-format off
-constexpr static auto g_index_swap_permutations = std::array<std::size_t, 6 * 24> {
-    0, 1, 2, 3, 4, 5,
-    0, 2, 1, 4, 3, 5,
-    0, 3, 4, 1, 2, 5,
-    0, 4, 3, 2, 1, 5,
-    1, 0, 2, 3, 5, 4,
-    1, 2, 0, 5, 3, 4,
-    1, 3, 5, 0, 2, 4,
-    1, 5, 3, 2, 0, 4,
-    2, 0, 1, 4, 5, 3,
-    2, 1, 0, 5, 4, 3,
-    2, 4, 5, 0, 1, 3,
-    2, 5, 4, 1, 0, 3,
-    3, 0, 4, 1, 5, 2,
-    3, 1, 5, 0, 4, 2,
-    3, 4, 0, 5, 1, 2,
-    3, 5, 1, 4, 0, 2,
-    4, 0, 3, 2, 5, 1,
-    4, 2, 5, 0, 3, 1,
-    4, 3, 0, 5, 2, 1,
-    4, 5, 2, 3, 0, 1,
-    5, 1, 3, 2, 4, 0,
-    5, 2, 4, 1, 3, 0,
-    5, 3, 1, 4, 2, 0,
-    5, 4, 2, 3, 1, 0
-};
-// clang-format on
-
 /*
     The ReciprocalFactorTransformer both calculates the reciprocal of each element, and
     multiplies it by a certain constant factor.
@@ -113,6 +43,13 @@ public:
         }
     }
 
+    constexpr void operator()(FP* values, std::size_t n_values) const noexcept
+    {
+        for (std::size_t i {}; i < n_values; ++i) {
+            values[i] = factor_ / values[i];
+        }
+    }
+
 private:
     FP factor_;
 };
@@ -132,32 +69,18 @@ public:
         const auto values_end = values.data_ptr<FP>() + values.numel();
         std::copy(values_begin, values_end, original_permutation.begin());
 
-        auto minimum_permuted = std::array<FP, 6>(original_permutation);
-
-        for (std::size_t i_perm {1}; i_perm < g_n_permutations; ++i_perm) {
-            const auto permuted = permute_six_side_lengths_(i_perm, original_permutation);
-            minimum_permuted = std::min(minimum_permuted, permuted, comparator_);
-        }
+        const auto minimum_permuted = minimum_permutation(original_permutation, comparator_);
 
         std::copy(minimum_permuted.begin(), minimum_permuted.end(), values.data_ptr<FP>());
     }
 
-private:
-    impl_interact_trans::LessThanEpsilon<FP> comparator_;
-
-    constexpr auto permute_six_side_lengths_(std::size_t i_permutation, const std::array<FP, 6>& side_lengths) const
-        -> std::array<FP, 6>
+    constexpr auto comparator() const noexcept -> const impl_interact_trans::LessThanEpsilon<FP>&
     {
-        std::array<FP, 6> permuted_side_lengths;
-        auto i_offset = i_permutation * 6;
-
-        for (std::size_t i {}; i < 6; ++i) {
-            auto index_to_swap = g_index_swap_permutations[i_offset + i];
-            permuted_side_lengths[i] = side_lengths[index_to_swap];
-        }
-
-        return permuted_side_lengths;
+        return comparator_;
     }
+
+private:
+    impl_interact_trans::LessThanEpsilon<FP> comparator_;
 };
 
 // clang-format off
@@ -224,6 +147,14 @@ private:
     }
 };
 
+/*
+    Transformers that can transform an entire batch of samples at once, instead of one sample at a time.
+*/
+template <typename Transformer>
+concept BatchTransformable = requires(const Transformer& transformer, torch::Tensor& batch) {
+    transformer.transform_batch(batch);
+};
+
 template <std::floating_point FP>
 class SampleTransformer
 {
@@ -234,6 +165,7 @@ public:
     )
         : reciprocal_factor_transformer_ {reciprocal_factor_transformer}
         , permutation_transformer_ {permutation_transformer}
+        , batch_permutation_transformer_ {permutation_transformer.comparator()}
     {}
 
     constexpr auto operator()(torch::Tensor& values) const
@@ -242,9 +174,27 @@ public:
         permutation_transformer_(values);
     }
 
+    /*
+        Transform an entire (N, 6) batch of samples at once; gives the same result as calling
+        `operator()` on each row of the batch, without going through torch for each element.
+    */
+    void transform_batch(torch::Tensor& batch) const
+    {
+        if (!batch.is_contiguous()) {
+            throw std::runtime_error("The batch passed to `SampleTransformer::transform_batch()` must be contiguous.");
+        }
+
+        auto* values = batch.data_ptr<FP>();
+        const auto n_samples = static_cast<std::size_t>(batch.size(0));
+
+        reciprocal_factor_transformer_(values, 6 * n_samples);
+        batch_permutation_transformer_(values, n_samples);
+    }
+
 private:
     ReciprocalFactorTransformer<FP> reciprocal_factor_transformer_;
     MinimumPermutationTransformer<FP> permutation_transformer_;
+    BatchMinimumPermutationTransformer<FP> batch_permutation_transformer_;
 };
 
 template <std::floating_point FP>
@@ -84,6 +84,30 @@ public:
         return pot_energy;
     }
 
+    constexpr void add_worldline_energy(
+        std::size_t i_particle,
+        const worldline::Worldlines<FP, NDIM>& worldlines,
+        FP weight
+    ) noexcept
+    requires(BatchedInteractionHandler<Handlers, FP, NDIM> && ...)
+    {
+        const auto handler_looper = [&](auto&&... handler)
+        { (handler.add_worldline_energy(i_particle, worldlines, weight), ...); };
+
+        std::apply(handler_looper, handlers_);
+    }
+
+    constexpr auto extract_energy() noexcept -> FP
+    requires(BatchedInteractionHandler<Handlers, FP, NDIM> && ...)
+    {
+        auto pot_energy = FP {};
+        const auto handler_looper = [&](auto&&... handler) { ((pot_energy += handler.extract_energy()), ...); };
+
+        std::apply(handler_looper, handlers_);
+
+        return pot_energy;
+    }
+
     template <std::size_t Index>
     constexpr auto adjacency_matrix() noexcept -> mathtools::SquareAdjacencyMatrix&
     {
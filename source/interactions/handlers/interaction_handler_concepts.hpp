@@ -29,4 +29,21 @@ concept NearestNeighbourInteractionHandler = requires(Handler t) {
     } -> std::same_as<mathtools::SquareAdjacencyMatrix&>;
 };
 
+/*
+    An interaction handler that can also accumulate the energy of a particle over all the timeslices of
+    the worldlines, multiplied by a weight, and only evaluate it when `extract_energy()` is called.
+
+    This lets a handler that evaluates its energies in batches (like the four-body potential) put all
+    the timeslices, both before and after a move, into a single batch.
+*/
+template <typename Handler, typename FP, std::size_t NDIM>
+concept BatchedInteractionHandler = requires(Handler t) {
+    requires InteractionHandler<Handler, FP, NDIM>;
+    t.add_worldline_energy(std::size_t {}, worldline::Worldlines<FP, NDIM> {std::size_t {}, std::size_t {}}, FP {});
+
+    {
+        t.extract_energy()
+    } -> std::same_as<FP>;
+};
+
 }  // namespace interact
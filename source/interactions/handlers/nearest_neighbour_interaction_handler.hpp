@@ -86,6 +86,32 @@ public:
         return pot_energy;
     }
 
+    /*
+        Add `weight` times the interaction energy of the particle at index `i_particle`, summed over all
+        timeslices, to the energy returned by the next call to `extract_energy()`.
+    */
+    constexpr void add_worldline_energy(
+        std::size_t i_particle,
+        const worldline::Worldlines<FP, NDIM>& worldlines,
+        FP weight
+    ) noexcept
+    {
+        auto pot_energy = FP {};
+        for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
+            pot_energy += (*this)(i_timeslice, i_particle, worldlines);
+        }
+
+        accumulated_energy_ += weight * pot_energy;
+    }
+
+    constexpr auto extract_energy() noexcept -> FP
+    {
+        const auto energy = accumulated_energy_;
+        accumulated_energy_ = FP {};
+
+        return energy;
+    }
+
     constexpr auto adjacency_matrix() noexcept -> mathtools::SquareAdjacencyMatrix&
     {
         // mutable reference to the underlying adjacency matrix so an external function can update it
@@ -100,6 +126,7 @@ public:
 private:
     PointPotential pot_;
     mathtools::SquareAdjacencyMatrix centroid_adjmat_;
+    FP accumulated_energy_ {};
 };
 
 template <typename PointPotential, std::floating_point FP, std::size_t NDIM>
@@ -141,6 +168,32 @@ public:
         return pot_energy;
     }
 
+    /*
+        Add `weight` times the interaction energy of the particle at index `i_particle`, summed over all
+        timeslices, to the energy returned by the next call to `extract_energy()`.
+    */
+    constexpr void add_worldline_energy(
+        std::size_t i_particle,
+        const worldline::Worldlines<FP, NDIM>& worldlines,
+        FP weight
+    ) noexcept
+    {
+        auto pot_energy = FP {};
+        for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
+            pot_energy += (*this)(i_timeslice, i_particle, worldlines);
+        }
+
+        accumulated_energy_ += weight * pot_energy;
+    }
+
+    constexpr auto extract_energy() noexcept -> FP
+    {
+        const auto energy = accumulated_energy_;
+        accumulated_energy_ = FP {};
+
+        return energy;
+    }
+
     constexpr auto adjacency_matrix() noexcept -> mathtools::SquareAdjacencyMatrix&
     {
         // mutable reference to the underlying adjacency matrix so an external function can update it
@@ -155,6 +208,7 @@ public:
 private:
     PointPotential pot_;
     mathtools::SquareAdjacencyMatrix centroid_adjmat_;
+    FP accumulated_energy_ {};
 };
 
 template <typename Potential, std::floating_point FP, std::size_t NDIM>
@@ -172,6 +226,68 @@ public:
         std::size_t i_particle,
         const worldline::Worldlines<FP, NDIM>& worldlines
     ) noexcept -> FP
+    {
+        add_timeslice_samples_(i_timeslice, i_particle, worldlines, FP {1.0});
+
+        const auto pot_energy = pot_.extract_energy();
+
+        return pot_energy;
+    }
+
+    /*
+        Add the samples of all the timeslices to the buffered potential, so that they can be evaluated in
+        as few batches as possible; with a potential that accepts weighted samples, the samples for
+        several calls (for example, before and after a move) are all evaluated together.
+    */
+    constexpr void add_worldline_energy(
+        std::size_t i_particle,
+        const worldline::Worldlines<FP, NDIM>& worldlines,
+        FP weight
+    ) noexcept
+    {
+        for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
+            add_timeslice_samples_(i_timeslice, i_particle, worldlines, weight);
+        }
+
+        if constexpr (!WeightedBufferedQuadrupletPotential<Potential, FP>) {
+            accumulated_energy_ += weight * pot_.extract_energy();
+        }
+    }
+
+    constexpr auto extract_energy() noexcept -> FP
+    {
+        auto energy = accumulated_energy_;
+        accumulated_energy_ = FP {};
+
+        if constexpr (WeightedBufferedQuadrupletPotential<Potential, FP>) {
+            energy += pot_.extract_energy();
+        }
+
+        return energy;
+    }
+
+    constexpr auto adjacency_matrix() noexcept -> mathtools::SquareAdjacencyMatrix&
+    {
+        // mutable reference to the underlying adjacency matrix so an external function can update it
+        return centroid_adjmat_;
+    }
+
+    constexpr auto point_potential() -> Potential&
+    {
+        return pot_;
+    }
+
+private:
+    Potential pot_;
+    mathtools::SquareAdjacencyMatrix centroid_adjmat_;
+    FP accumulated_energy_ {};
+
+    constexpr void add_timeslice_samples_(
+        std::size_t i_timeslice,
+        std::size_t i_particle,
+        const worldline::Worldlines<FP, NDIM>& worldlines,
+        FP weight
+    ) noexcept
     {
         // NOTE
         // this member function doesn't actually take periodicity into account; so the Attard
@@ -202,30 +318,17 @@ public:
                     const auto dist13 = coord::distance(point1, point3);
                     const auto dist23 = coord::distance(point2, point3);
 
-                    pot_.add_sample(coord::FourBodySideLengths<FP> {dist01, dist02, dist03, dist12, dist13, dist23});
+                    const auto sides = coord::FourBodySideLengths<FP> {dist01, dist02, dist03, dist12, dist13, dist23};
+                    if constexpr (WeightedBufferedQuadrupletPotential<Potential, FP>) {
+                        pot_.add_sample(sides, weight);
+                    }
+                    else {
+                        pot_.add_sample(sides);
+                    }
                 }
             }
         }
-
-        const auto pot_energy = pot_.extract_energy();
-
-        return pot_energy;
-    }
-
-    constexpr auto adjacency_matrix() noexcept -> mathtools::SquareAdjacencyMatrix&
-    {
-        // mutable reference to the underlying adjacency matrix so an external function can update it
-        return centroid_adjmat_;
     }
-
-    constexpr auto point_potential() -> Potential&
-    {
-        return pot_;
-    }
-
-private:
-    Potential pot_;
-    mathtools::SquareAdjacencyMatrix centroid_adjmat_;
 };
 
 }  // namespace interact
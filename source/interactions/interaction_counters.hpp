@@ -0,0 +1,194 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include <common/buffered_writers/buffered_writer.hpp>
+
+/*
+    Counters for the number of interactions evaluated, to see where the cost of a block goes and what a
+    change of cutoff buys.
+
+    Without `PIMC_SIM_INTERACTION_COUNTERS`, `count_interaction()` is empty.
+
+    Each thread increments its own counters, so the potentials can be evaluated from the estimator
+    thread pool without contention; `collect_interaction_counts()` sums the counters of every thread
+    that has ever counted anything, and resets them.
+*/
+
+namespace interact
+{
+
+#if defined(PIMC_SIM_INTERACTION_COUNTERS)
+constexpr inline auto IS_INTERACTION_COUNTING_ENABLED = bool {true};
+#else
+constexpr inline auto IS_INTERACTION_COUNTING_ENABLED = bool {false};
+#endif
+
+/*
+    The quadruplet counters are split by the `InteractionRange` of the sample, in the same order as that
+    enum; the total number of quadruplets is counted separately.
+*/
+enum class InteractionCounter : std::size_t
+{
+    PAIR_EVALUATIONS,
+    TRIPLET_EVALUATIONS,
+    THREE_BODY_ATM_FALLBACKS,
+    QUADRUPLET_EVALUATIONS,
+    QUADRUPLET_ABINITIO_SHORT,
+    QUADRUPLET_ABINITIO_SHORTMID,
+    QUADRUPLET_ABINITIO_MID,
+    QUADRUPLET_MIXED_SHORT,
+    QUADRUPLET_MIXED_SHORTMID,
+    QUADRUPLET_MIXED_MID,
+    QUADRUPLET_LONG
+};
+
+constexpr inline auto N_INTERACTION_COUNTERS = std::size_t {11};
+
+// the names of the counters, in the order of the `InteractionCounter` enum
+constexpr inline auto INTERACTION_COUNTER_NAMES = std::array<std::string_view, N_INTERACTION_COUNTERS> {
+    "pair_evaluations",
+    "triplet_evaluations",
+    "three_body_atm_fallbacks",
+    "quadruplet_evaluations",
+    "quadruplet_abinitio_short",
+    "quadruplet_abinitio_shortmid",
+    "quadruplet_abinitio_mid",
+    "quadruplet_mixed_short",
+    "quadruplet_mixed_shortmid",
+    "quadruplet_mixed_mid",
+    "quadruplet_long"
+};
+
+using InteractionCounts = std::array<std::uint64_t, N_INTERACTION_COUNTERS>;
+
+}  // namespace interact
+
+namespace impl_interact_counters
+{
+
+constexpr inline auto DEFAULT_INTERACTION_COUNTS_FILENAME = std::string_view {"interaction_counts.dat"};
+
+struct ThreadCounters
+{
+    std::array<std::atomic<std::uint64_t>, interact::N_INTERACTION_COUNTERS> counts {};
+};
+
+/*
+    Owns the counters of every thread; the counters are never removed, so the counts made by a thread
+    that has since exited are still collected.
+*/
+class CounterRegistry
+{
+public:
+    auto add_thread() -> ThreadCounters&
+    {
+        auto lock = std::lock_guard {mutex_};
+        return thread_counters_.emplace_back();
+    }
+
+    auto collect_and_reset() -> interact::InteractionCounts
+    {
+        auto lock = std::lock_guard {mutex_};
+
+        auto total = interact::InteractionCounts {};
+        for (auto& counters : thread_counters_) {
+            for (std::size_t i {0}; i < interact::N_INTERACTION_COUNTERS; ++i) {
+                total[i] += counters.counts[i].exchange(0, std::memory_order_relaxed);
+            }
+        }
+
+        return total;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<ThreadCounters> thread_counters_;
+};
+
+inline auto counter_registry() -> CounterRegistry&
+{
+    static auto registry = CounterRegistry {};
+    return registry;
+}
+
+inline auto this_thread_counters() -> ThreadCounters&
+{
+    thread_local auto& counters = counter_registry().add_thread();
+    return counters;
+}
+
+// every column of the writer holds a count
+template <std::size_t Index>
+using CountColumn = std::uint64_t;
+
+template <std::size_t... Indices>
+auto interaction_counts_writer_type(std::index_sequence<Indices...>)
+    -> common::writers::BlockValueWriter<CountColumn<Indices>...>;
+
+inline auto interaction_counts_file_header() -> std::string
+{
+    auto message = std::stringstream {};
+
+    message << "# this file contains the number of interactions evaluated during each block\n";
+    message << "# the first column is the number label for the block, and the other columns are, in order:\n";
+    for (const auto name : interact::INTERACTION_COUNTER_NAMES) {
+        message << "#   " << name << '\n';
+    }
+
+    return message.str();
+}
+
+}  // namespace impl_interact_counters
+
+namespace interact
+{
+
+inline void count_interaction(InteractionCounter counter, std::uint64_t n_interactions = 1)
+{
+    if constexpr (IS_INTERACTION_COUNTING_ENABLED) {
+        auto& count = impl_interact_counters::this_thread_counters().counts[static_cast<std::size_t>(counter)];
+        count.fetch_add(n_interactions, std::memory_order_relaxed);
+    }
+}
+
+/*
+    The counts made on every thread since the last call; this is meant to be called between blocks, when
+    no interactions are being evaluated, so that the counts for one block don't spill into the next.
+*/
+inline auto collect_interaction_counts() -> InteractionCounts
+{
+    return impl_interact_counters::counter_registry().collect_and_reset();
+}
+
+using InteractionCountsWriter = decltype(impl_interact_counters::interaction_counts_writer_type(
+    std::make_index_sequence<N_INTERACTION_COUNTERS> {}
+));
+
+inline auto interaction_counts_block_data(std::size_t i_block, const InteractionCounts& counts)
+    -> InteractionCountsWriter::Data
+{
+    const auto counts_tuple = std::apply([](auto... count) { return std::tuple {count...}; }, counts);
+    return std::tuple_cat(std::tuple {i_block}, counts_tuple);
+}
+
+inline auto default_interaction_counts_writer(const std::filesystem::path& output_dirpath) -> InteractionCountsWriter
+{
+    const auto filepath = output_dirpath / impl_interact_counters::DEFAULT_INTERACTION_COUNTS_FILENAME;
+    const auto header = impl_interact_counters::interaction_counts_file_header();
+
+    return InteractionCountsWriter {filepath, header};
+}
+
+}  // namespace interact
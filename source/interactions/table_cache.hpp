@@ -0,0 +1,381 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include <common/binary_io.hpp>
+#include <common/mapped_file.hpp>
+
+/*
+    A binary cache for the tables of energies that the published potentials read from text files.
+
+    Parsing a large text table takes a noticeable part of the startup time of a short simulation. The first
+    time a table is parsed, an image of it is written next to the text file (with `.bin` appended to the
+    file name); later loads map the image into memory and copy the values out directly, without parsing.
+
+    The image is only used if it was built from a text file with the same size and modification time as the
+    current one, if it holds values of the same floating-point type, and if its checksum matches; otherwise
+    the text file is parsed again, and the image is replaced.
+
+    An image is never changed in place (a new image is renamed over the old one), so a process may keep an
+    image mapped for as long as it runs, and read the values straight from the mapping.
+
+    The layout of the image is:
+      - the magic bytes "PIMCTABL"
+      - u32 version, u32 width of the floating-point type in bytes
+      - u64 size of the text file in bytes, i64 modification time of the text file
+      - u64 size of the payload in bytes, u64 FNV-1a checksum of the payload
+      - the payload:
+          - u64 number of axes, followed by the number of grid points along each axis (u64)
+          - the lower and upper limit of each axis (FP)
+          - the values, with the last axis changing fastest (FP)
+*/
+
+namespace impl_interact_table_cache
+{
+
+constexpr inline auto TABLE_CACHE_MAGIC = std::array<char, 8> {'P', 'I', 'M', 'C', 'T', 'A', 'B', 'L'};
+constexpr inline auto TABLE_CACHE_VERSION = std::uint32_t {1};
+constexpr inline auto DEFAULT_TABLE_CACHE_SUFFIX = std::string_view {".bin"};
+
+struct SourceFileStamp
+{
+    std::uint64_t n_bytes;
+    std::int64_t modification_time;
+
+    constexpr auto operator==(const SourceFileStamp& other) const noexcept -> bool = default;
+};
+
+inline auto source_file_stamp(const std::filesystem::path& source_filepath) -> SourceFileStamp
+{
+    const auto n_bytes = static_cast<std::uint64_t>(std::filesystem::file_size(source_filepath));
+    const auto modification_time = std::filesystem::last_write_time(source_filepath).time_since_epoch().count();
+
+    return {n_bytes, static_cast<std::int64_t>(modification_time)};
+}
+
+// each process writes to its own temporary file, so jobs that start at the same time do not clash
+inline auto temporary_cache_filepath(const std::filesystem::path& cache_filepath) -> std::filesystem::path
+{
+    auto temp_filepath = cache_filepath;
+    temp_filepath += '.';
+    temp_filepath += std::to_string(::getpid());
+    temp_filepath += ".tmp";
+
+    return temp_filepath;
+}
+
+// the parts of an image that passed every check, as views into its memory map
+struct TableImage
+{
+    std::shared_ptr<const common::io::MappedFile> file;
+    std::vector<std::size_t> shape;
+    std::span<const char> limits_bytes;
+    std::span<const char> values_bytes;
+};
+
+template <std::floating_point FP>
+auto open_table_image(const std::filesystem::path& source_filepath, const std::filesystem::path& cache_filepath)
+    -> std::optional<TableImage>
+{
+    auto error_code = std::error_code {};
+    if (!std::filesystem::is_regular_file(cache_filepath, error_code)) {
+        return std::nullopt;
+    }
+
+    try {
+        auto image = TableImage {};
+        image.file = std::make_shared<const common::io::MappedFile>(cache_filepath);
+
+        auto reader = common::io::BinaryReader {image.file->bytes()};
+
+        const auto magic = reader.read<std::array<char, 8>>();
+        const auto version = reader.read<std::uint32_t>();
+        const auto fp_width = reader.read<std::uint32_t>();
+        const auto stamp = reader.read<SourceFileStamp>();
+        const auto payload_n_bytes = reader.read<std::uint64_t>();
+        const auto checksum = reader.read<std::uint64_t>();
+
+        if (magic != TABLE_CACHE_MAGIC || version != TABLE_CACHE_VERSION || fp_width != sizeof(FP)) {
+            return std::nullopt;
+        }
+
+        if (stamp != source_file_stamp(source_filepath)) {
+            return std::nullopt;
+        }
+
+        if (payload_n_bytes != reader.n_remaining()) {
+            return std::nullopt;
+        }
+
+        const auto payload = reader.read_bytes(payload_n_bytes);
+        if (common::io::fnv1a_64(payload) != checksum) {
+            return std::nullopt;
+        }
+
+        auto payload_reader = common::io::BinaryReader {payload};
+
+        image.shape.resize(payload_reader.read<std::uint64_t>());
+
+        auto n_values = std::size_t {1};
+        for (auto& size : image.shape) {
+            size = payload_reader.read<std::uint64_t>();
+            n_values *= size;
+        }
+
+        image.limits_bytes = payload_reader.read_bytes(2 * image.shape.size() * sizeof(FP));
+        image.values_bytes = payload_reader.read_bytes(n_values * sizeof(FP));
+
+        if (payload_reader.n_remaining() != 0) {
+            return std::nullopt;
+        }
+
+        return image;
+    }
+    catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+template <std::floating_point FP>
+auto copy_values(std::span<const char> bytes) -> std::vector<FP>
+{
+    auto values = std::vector<FP>(bytes.size() / sizeof(FP));
+    std::memcpy(values.data(), bytes.data(), bytes.size());
+
+    return values;
+}
+
+}  // namespace impl_interact_table_cache
+
+namespace interact
+{
+
+/*
+    OFF:     always parse the text file
+    ON:      use the binary image, and copy its values into the table
+    SHARED:  use the binary image, and leave its values in the memory-mapped file (see `map_table_cache()`)
+*/
+enum class TableCacheStatus
+{
+    ON,
+    OFF,
+    SHARED
+};
+
+/*
+    A regular grid of values, along with the number of points and the limits of each axis.
+
+    A table mapped from a binary image keeps its values in `shared_values` instead of `values`.
+*/
+template <std::floating_point FP>
+struct PotentialTable
+{
+    std::vector<std::size_t> shape;
+    std::vector<FP> limits;
+    std::vector<FP> values;
+    std::shared_ptr<const FP> shared_values {};
+
+    auto n_values() const noexcept -> std::size_t
+    {
+        return std::accumulate(shape.begin(), shape.end(), std::size_t {1}, std::multiplies<> {});
+    }
+
+    // moves the values out of the table, copying them if they are shared
+    auto release_values() -> std::vector<FP>
+    {
+        if (shared_values) {
+            return std::vector<FP>(shared_values.get(), shared_values.get() + n_values());
+        }
+
+        return std::move(values);
+    }
+};
+
+inline auto table_cache_filepath(const std::filesystem::path& source_filepath) -> std::filesystem::path
+{
+    auto cache_filepath = source_filepath;
+    cache_filepath += impl_interact_table_cache::DEFAULT_TABLE_CACHE_SUFFIX;
+
+    return cache_filepath;
+}
+
+/*
+    Write the binary image of `table` for the text file at `source_filepath`; the image is written to a
+    temporary file first and renamed into place, so a job reading the image never sees a partial one, even
+    if several jobs build it at the same time.
+*/
+template <std::floating_point FP>
+void write_table_cache(const std::filesystem::path& source_filepath, const PotentialTable<FP>& table)
+{
+    namespace cio = common::io;
+    using impl_interact_table_cache::TABLE_CACHE_MAGIC;
+    using impl_interact_table_cache::TABLE_CACHE_VERSION;
+
+    auto payload_stream = std::ostringstream {};
+    cio::write_binary(payload_stream, static_cast<std::uint64_t>(table.shape.size()));
+    for (const auto size : table.shape) {
+        cio::write_binary(payload_stream, static_cast<std::uint64_t>(size));
+    }
+    cio::write_binary(payload_stream, std::span<const FP> {table.limits});
+    cio::write_binary(payload_stream, std::span<const FP> {table.values});
+    const auto payload = payload_stream.str();
+
+    const auto stamp = impl_interact_table_cache::source_file_stamp(source_filepath);
+    const auto cache_filepath = table_cache_filepath(source_filepath);
+
+    const auto temp_filepath = impl_interact_table_cache::temporary_cache_filepath(cache_filepath);
+
+    {
+        auto out_stream = std::ofstream {temp_filepath, std::ios::binary | std::ios::trunc};
+        if (!out_stream.is_open()) {
+            auto err_msg = std::stringstream {};
+            err_msg << "Error: Unable to open file for the potential table cache: '" << temp_filepath << "'\n";
+            throw std::ios_base::failure {err_msg.str()};
+        }
+
+        cio::write_binary(out_stream, TABLE_CACHE_MAGIC);
+        cio::write_binary(out_stream, TABLE_CACHE_VERSION);
+        cio::write_binary(out_stream, static_cast<std::uint32_t>(sizeof(FP)));
+        cio::write_binary(out_stream, stamp);
+        cio::write_binary(out_stream, static_cast<std::uint64_t>(payload.size()));
+        cio::write_binary(out_stream, cio::fnv1a_64(std::span<const char> {payload}));
+        out_stream.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+
+        if (!out_stream) {
+            auto err_msg = std::stringstream {};
+            err_msg << "Error: Unable to write the potential table cache: '" << temp_filepath << "'\n";
+            throw std::ios_base::failure {err_msg.str()};
+        }
+    }
+
+    std::filesystem::rename(temp_filepath, cache_filepath);
+}
+
+/*
+    Read the binary image for the text file at `source_filepath`, and copy the values out of it; returns
+    `std::nullopt` if there is no usable image (it is missing, out of date, damaged, or holds a different
+    floating-point type).
+*/
+template <std::floating_point FP>
+auto read_table_cache(const std::filesystem::path& source_filepath) -> std::optional<PotentialTable<FP>>
+{
+    const auto cache_filepath = table_cache_filepath(source_filepath);
+
+    auto image = impl_interact_table_cache::open_table_image<FP>(source_filepath, cache_filepath);
+    if (!image) {
+        return std::nullopt;
+    }
+
+    auto table = PotentialTable<FP> {};
+    table.shape = std::move(image->shape);
+    table.limits = impl_interact_table_cache::copy_values<FP>(image->limits_bytes);
+    table.values = impl_interact_table_cache::copy_values<FP>(image->values_bytes);
+
+    return table;
+}
+
+/*
+    Like `read_table_cache()`, but the values are left in the memory-mapped image instead of being copied;
+    the pages of a mapped file are shared by every process on the node that maps the same image, so
+    concurrent simulations that use the same table keep only one physical copy of it.
+*/
+template <std::floating_point FP>
+auto map_table_cache(const std::filesystem::path& source_filepath) -> std::optional<PotentialTable<FP>>
+{
+    const auto cache_filepath = table_cache_filepath(source_filepath);
+
+    auto image = impl_interact_table_cache::open_table_image<FP>(source_filepath, cache_filepath);
+    if (!image) {
+        return std::nullopt;
+    }
+
+    const auto values_address = reinterpret_cast<std::uintptr_t>(image->values_bytes.data());
+    if (values_address % alignof(FP) != 0) {
+        return std::nullopt;
+    }
+
+    auto table = PotentialTable<FP> {};
+    table.shape = std::move(image->shape);
+    table.limits = impl_interact_table_cache::copy_values<FP>(image->limits_bytes);
+
+    // the aliasing constructor ties the lifetime of the mapping to the pointer to the values inside it
+    const auto values = reinterpret_cast<const FP*>(image->values_bytes.data());
+    table.shared_values = std::shared_ptr<const FP> {std::move(image->file), values};
+
+    return table;
+}
+
+/*
+    Load the table from its binary image if there is a usable one, and otherwise get it from `parse_table()`;
+    a freshly parsed table is written out as the image for the next load.
+
+    The cache is only an optimization, so failing to write the image (for example, if the directory holding
+    the text file is read-only) is not an error; with `TableCacheStatus::SHARED`, the table then falls back
+    to holding its own copy of the values.
+*/
+template <std::floating_point FP>
+auto load_potential_table(
+    const std::filesystem::path& source_filepath,
+    TableCacheStatus cache_status,
+    const std::function<PotentialTable<FP>()>& parse_table
+) -> PotentialTable<FP>
+{
+    if (cache_status == TableCacheStatus::OFF) {
+        return parse_table();
+    }
+
+    const auto load_cached_table = [&]() {
+        if (cache_status == TableCacheStatus::SHARED) {
+            return map_table_cache<FP>(source_filepath);
+        }
+        return read_table_cache<FP>(source_filepath);
+    };
+
+    if (auto cached_table = load_cached_table()) {
+        return std::move(*cached_table);
+    }
+
+    auto table = parse_table();
+
+    try {
+        write_table_cache<FP>(source_filepath, table);
+    }
+    catch (const std::exception&) {
+        const auto cache_filepath = table_cache_filepath(source_filepath);
+
+        auto error_code = std::error_code {};
+        std::filesystem::remove(impl_interact_table_cache::temporary_cache_filepath(cache_filepath), error_code);
+
+        return table;
+    }
+
+    if (cache_status == TableCacheStatus::SHARED) {
+        if (auto mapped_table = map_table_cache<FP>(source_filepath)) {
+            return std::move(*mapped_table);
+        }
+    }
+
+    return table;
+}
+
+}  // namespace interact
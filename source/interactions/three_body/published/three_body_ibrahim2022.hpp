@@ -6,10 +6,13 @@
 #include <fstream>
 #include <ios>
 #include <optional>
+#include <sstream>
+#include <utility>
 #include <vector>
 
 #include <common/writer_utils.hpp>
 #include <constants/constants.hpp>
+#include <interactions/table_cache.hpp>
 #include <interactions/three_body/three_body_parah2.hpp>
 #include <mathtools/grid/grid3d.hpp>
 #include <mathtools/interpolate/trilinear_interp.hpp>
@@ -19,10 +22,7 @@ namespace interact
 {
 
 template <std::floating_point FP>
-auto three_body_ibrahim2022(
-    const std::filesystem::path& data_filepath,
-    const std::optional<FP>& c9_coefficient = std::nullopt
-)
+auto read_ibrahim2022_table(const std::filesystem::path& data_filepath) -> PotentialTable<FP>
 {
     auto instream = std::ifstream(data_filepath, std::ios::in);
     if (!instream.is_open()) {
@@ -47,11 +47,6 @@ auto three_body_ibrahim2022(
     instream >> u_min;
     instream >> u_max;
 
-    const auto shape = mathtools::Shape3D {r_size, s_size, u_size};
-    const auto r_limits = mathtools_utils::AxisLimits {r_min, r_max};
-    const auto s_limits = mathtools_utils::AxisLimits {s_min, s_max};
-    const auto u_limits = mathtools_utils::AxisLimits {u_min, u_max};
-
     // read in all the energies into a vector
     const auto n_elements = r_size * s_size * u_size;
     auto energies = std::vector<FP> {};
@@ -63,8 +58,37 @@ auto three_body_ibrahim2022(
         energies.push_back(energy);
     }
 
-    // create the 3D grid of energies to perform trilinear interpolation on
-    auto grid = mathtools::Grid3D {std::move(energies), shape};
+    return PotentialTable<FP> {
+        {r_size, s_size, u_size},
+        {r_min, r_max, s_min, s_max, u_min, u_max},
+        std::move(energies)
+    };
+}
+
+template <std::floating_point FP>
+auto three_body_ibrahim2022(
+    const std::filesystem::path& data_filepath,
+    const std::optional<FP>& c9_coefficient = std::nullopt,
+    TableCacheStatus cache_status = TableCacheStatus::OFF
+)
+{
+    // with the cache turned on, the table is loaded from its binary image (see `table_cache.hpp`)
+    auto table = load_potential_table<FP>(data_filepath, cache_status, [&]() {
+        return read_ibrahim2022_table<FP>(data_filepath);
+    });
+
+    const auto shape = mathtools::Shape3D {table.shape.at(0), table.shape.at(1), table.shape.at(2)};
+    const auto r_limits = mathtools_utils::AxisLimits {table.limits.at(0), table.limits.at(1)};
+    const auto s_limits = mathtools_utils::AxisLimits {table.limits.at(2), table.limits.at(3)};
+    const auto u_limits = mathtools_utils::AxisLimits {table.limits.at(4), table.limits.at(5)};
+
+    // create the 3D grid of energies to perform trilinear interpolation on; a shared table is not copied
+    auto grid = [&]() {
+        if (table.shared_values) {
+            return mathtools::Grid3D<FP> {table.shared_values, shape};
+        }
+        return mathtools::Grid3D<FP> {std::move(table.values), shape};
+    }();
 
     auto interpolator = mathtools::TrilinearInterpolator<FP> {std::move(grid), r_limits, s_limits, u_limits};
     const auto coefficient = c9_coefficient.value_or(constants::C9_ATM_COEFFICIENT_HINDE2008<FP>);
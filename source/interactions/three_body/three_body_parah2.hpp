@@ -5,6 +5,8 @@
 #include <concepts>
 #include <utility>
 
+#include <common/memory_usage.hpp>
+#include <interactions/interaction_counters.hpp>
 #include <interactions/three_body/axilrod_teller_muto.hpp>
 #include <mathtools/interpolate/trilinear_interp.hpp>
 
@@ -83,10 +85,16 @@ public:
             return interpolator_(r, s, cosu);
         }
         else {
+            count_interaction(InteractionCounter::THREE_BODY_ATM_FALLBACKS);
             return atm_potential_(dist01, dist02, dist12);
         }
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return interpolator_.memory_usage();
+    }
+
 private:
     mathtools::TrilinearInterpolator<FP> interpolator_;
     AxilrodTellerMutoPotential<FP> atm_potential_;
@@ -138,6 +146,11 @@ public:
         return interpolator_(r, s, cosu);
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return interpolator_.memory_usage();
+    }
+
 private:
     mathtools::TrilinearInterpolator<FP> interpolator_;
     EarlyRejectInfo<FP> info_;
@@ -4,9 +4,11 @@
 #include <concepts>
 #include <cstddef>
 
+#include <common/memory_usage.hpp>
 #include <coordinates/attard/three_body.hpp>
 #include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
+#include <interactions/interaction_counters.hpp>
 #include <interactions/three_body/potential_concepts.hpp>
 #include <interactions/three_body/three_body_parah2.hpp>
 
@@ -26,9 +28,15 @@ public:
 
     constexpr auto operator()(const Point& p0, const Point& p1, const Point& p2) const noexcept -> FP
     {
+        count_interaction(InteractionCounter::TRIPLET_EVALUATIONS);
         return pot_(coord::distance(p0, p1), coord::distance(p0, p2), coord::distance(p1, p2));
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::memory_usage(pot_);
+    }
+
 private:
     Potential pot_;
 };
@@ -52,6 +60,7 @@ public:
         const auto dist01 = coord::distance_periodic(p0, p1, box_);
         const auto dist02 = coord::distance_periodic(p0, p2, box_);
         const auto dist12 = coord::distance_periodic(p1, p2, box_);
+        count_interaction(InteractionCounter::TRIPLET_EVALUATIONS);
         return pot_(dist01, dist02, dist12);
     }
 
@@ -61,6 +70,7 @@ public:
             coord::three_body_attard_side_lengths_squared({p0, p1, p2}, box_);
 
         if (dist01_sq < cutoff_dist_sq_ && dist02_sq < cutoff_dist_sq_ && dist12_sq < cutoff_dist_sq_) {
+            count_interaction(InteractionCounter::TRIPLET_EVALUATIONS);
             return pot_(std::sqrt(dist01_sq), std::sqrt(dist02_sq), std::sqrt(dist12_sq));
         }
         else {
@@ -68,6 +78,11 @@ public:
         }
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::memory_usage(pot_);
+    }
+
 private:
     FP cutoff_dist_sq_;
     Box box_;
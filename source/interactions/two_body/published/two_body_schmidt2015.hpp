@@ -5,10 +5,13 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include <common/memory_usage.hpp>
+#include <interactions/table_cache.hpp>
 #include <mathtools/interpolate/linear_interp.hpp>
 
 namespace interact
@@ -66,6 +69,11 @@ public:
         }
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return interpolator_.memory_usage();
+    }
+
 private:
     FP c6_multipole_coeff_;
     mathtools::RegularLinearInterpolator<FP> interpolator_;
@@ -115,16 +123,8 @@ auto read_one_distance_squared_and_energy(std::ifstream& instream) -> std::tuple
 }
 
 template <std::floating_point FP>
-auto two_body_schmidt2015(const std::filesystem::path& fsh_filepath) -> FSHTwoBodyPotential<FP>
+auto read_schmidt2015_table(const std::filesystem::path& fsh_filepath) -> PotentialTable<FP>
 {
-    /*
-        The two-body pair potential for two parahydrogen molecules. Taken from the paper
-        `J. Phys. Chem. A 199, 12551 (2015).
-
-        The potential takes inputs in the form of the pair distance squared, in units of
-        Angstroms, and returns outputs in the form of the interaction energy, in units of
-        wavenumbers.
-    */
     auto instream = std::ifstream {fsh_filepath, std::ios::in};
 
     if (!instream.is_open()) {
@@ -159,7 +159,34 @@ auto two_body_schmidt2015(const std::filesystem::path& fsh_filepath) -> FSHTwoBo
     const auto [r2_max, energy_last] = read_one_distance_squared_and_energy<FP>(instream);
     energies.push_back(energy_last);
 
-    return FSHTwoBodyPotential<FP> {std::move(energies), r2_min, r2_max};
+    return PotentialTable<FP> {{energies.size()}, {r2_min, r2_max}, std::move(energies)};
+}
+
+template <std::floating_point FP>
+auto two_body_schmidt2015(
+    const std::filesystem::path& fsh_filepath,
+    TableCacheStatus cache_status = TableCacheStatus::OFF
+) -> FSHTwoBodyPotential<FP>
+{
+    /*
+        The two-body pair potential for two parahydrogen molecules. Taken from the paper
+        `J. Phys. Chem. A 199, 12551 (2015).
+
+        The potential takes inputs in the form of the pair distance squared, in units of
+        Angstroms, and returns outputs in the form of the interaction energy, in units of
+        wavenumbers.
+
+        With the cache turned on, the table is loaded from its binary image (see `table_cache.hpp`); the
+        interpolator derives its own table of slopes anyway, so a shared table is copied.
+    */
+    auto table = load_potential_table<FP>(fsh_filepath, cache_status, [&]() {
+        return read_schmidt2015_table<FP>(fsh_filepath);
+    });
+
+    const auto r2_min = table.limits.at(0);
+    const auto r2_max = table.limits.at(1);
+
+    return FSHTwoBodyPotential<FP> {table.release_values(), r2_min, r2_max};
 }
 
 }  // namespace interact
@@ -3,8 +3,10 @@
 #include <concepts>
 #include <cstddef>
 
+#include <common/memory_usage.hpp>
 #include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
+#include <interactions/interaction_counters.hpp>
 #include <interactions/two_body/potential_concepts.hpp>
 
 namespace interact
@@ -23,9 +25,15 @@ public:
 
     constexpr auto operator()(const Point& p0, const Point& p1) const noexcept -> FP
     {
+        count_interaction(InteractionCounter::PAIR_EVALUATIONS);
         return pot_(coord::distance(p0, p1));
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::memory_usage(pot_);
+    }
+
 private:
     Potential pot_;
 };
@@ -46,6 +54,7 @@ public:
 
     constexpr auto operator()(const Point& p0, const Point& p1) const noexcept -> FP
     {
+        count_interaction(InteractionCounter::PAIR_EVALUATIONS);
         return pot_(coord::distance_periodic(p0, p1, box_));
     }
 
@@ -54,6 +63,7 @@ public:
         const auto distance = coord::distance_periodic(p0, p1, box_);
 
         if (distance < cutoff_distance_) {
+            count_interaction(InteractionCounter::PAIR_EVALUATIONS);
             return pot_(distance);
         }
         else {
@@ -61,6 +71,11 @@ public:
         }
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::memory_usage(pot_);
+    }
+
 private:
     FP cutoff_distance_;
     Potential pot_;
@@ -83,6 +98,7 @@ public:
 
     constexpr auto operator()(const Point& p0, const Point& p1) const noexcept -> FP
     {
+        count_interaction(InteractionCounter::PAIR_EVALUATIONS);
         return pot_(coord::distance_squared_periodic(p0, p1, box_));
     }
 
@@ -91,6 +107,7 @@ public:
         const auto distance_squared = coord::distance_squared_periodic(p0, p1, box_);
 
         if (distance_squared < cutoff_distance_squared_) {
+            count_interaction(InteractionCounter::PAIR_EVALUATIONS);
             return pot_(distance_squared);
         }
         else {
@@ -98,6 +115,11 @@ public:
         }
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::memory_usage(pot_);
+    }
+
 private:
     FP cutoff_distance_squared_;
     Potential pot_;
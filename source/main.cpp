@@ -1,16 +1,28 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdlib>
 #include <filesystem>
+#include <iomanip>
+#include <ios>
 #include <iostream>
 #include <optional>
 #include <random>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <tomlplusplus/toml.hpp>
 // #include <torch/script.h>
 
 #include <argparser.hpp>
+#include <common/async_writer.hpp>
+#include <common/memory_usage.hpp>
+#include <common/thread_pool.hpp>
+#include <common/trace_events.hpp>
 #include <constants/constants.hpp>
+#include <coordinates/cell_list.hpp>
 #include <coordinates/coordinates.hpp>
 #include <environment/environment.hpp>
 #include <estimators/pimc/centroid.hpp>
@@ -20,6 +32,7 @@
 #include <estimators/pimc/radial_distribution_function.hpp>
 #include <estimators/pimc/three_body_potential.hpp>
 #include <estimators/pimc/two_body_potential.hpp>
+#include <estimators/statistics.hpp>
 #include <estimators/writers/default_writers.hpp>
 #include <geometries/bravais.hpp>
 #include <geometries/lattice.hpp>
@@ -30,10 +43,12 @@
 #include <interactions/handlers/full_interaction_handler.hpp>
 #include <interactions/handlers/interaction_handler_concepts.hpp>
 #include <interactions/handlers/nearest_neighbour_interaction_handler.hpp>
+#include <interactions/interaction_counters.hpp>
 #include <mathtools/grid/grid3d.hpp>
 #include <mathtools/histogram/histogram.hpp>
 #include <mathtools/interpolate/trilinear_interp.hpp>
 #include <mathtools/io/histogram.hpp>
+#include <mathtools/statistics/blocking.hpp>
 #include <pimc/adjusters/adjusters.hpp>
 #include <pimc/bisection_multibead_position_move_performer.hpp>
 #include <pimc/centre_of_mass_move.hpp>
@@ -45,6 +60,10 @@
 #include <rng/prng_state.hpp>
 #include <simulation/box_sides_writer.hpp>
 #include <simulation/continue.hpp>
+#include <simulation/hardware_counters.hpp>
+#include <simulation/memory_report.hpp>
+#include <simulation/phase_timer.hpp>
+#include <simulation/stopping.hpp>
 #include <simulation/timer.hpp>
 #include <worldline/worldline.hpp>
 #include <worldline/writers/delete_worldlines.hpp>
@@ -73,6 +92,9 @@ auto main(int argc, char** argv) -> int
         std::exit(EXIT_FAILURE);
     }
 
+    // the budget covers the whole run, including the time taken to set it up
+    auto wall_clock_budget = sim::WallClockBudget {parser.wall_clock_budget_seconds};
+
     const auto output_dirpath = parser.abs_output_dirpath;
 
     auto continue_file_manager = sim::ContinueFileManager {output_dirpath};
@@ -80,6 +102,12 @@ auto main(int argc, char** argv) -> int
         continue_file_manager.deserialize();
     }
 
+    // the checkpoint holds the complete state of the simulation, so it takes precedence over the other files
+    auto checkpoint = std::optional<sim::SimulationCheckpoint<double, NDIM>> {std::nullopt};
+    if (continue_file_manager.checkpoint_exists()) {
+        checkpoint = continue_file_manager.read_checkpoint<double, NDIM>();
+    }
+
     const auto temperature = parser.temperature;
     const auto n_timeslices = parser.n_timeslices;
     const auto com_step_size = parser.centre_of_mass_step_size;
@@ -87,7 +115,7 @@ auto main(int argc, char** argv) -> int
 
     // clang-format off
     const auto last_block_index = parser.last_block_index;
-    const auto first_block_index = read_simulation_first_block_index(continue_file_manager, parser);
+    const auto first_block_index = checkpoint ? checkpoint->info.most_recent_block_index + 1 : read_simulation_first_block_index(continue_file_manager, parser);
 
     const auto [n_particles, minimage_box, lattice_site_positions] = build_hcp_lattice_structure(parser.density, parser.n_unit_cells);
 
@@ -96,8 +124,8 @@ auto main(int argc, char** argv) -> int
     // clang-format on
 
     /* create the worldlines and worldline writer*/
-    auto worldline_writer = worldline::WorldlineWriter<double, NDIM> {output_dirpath};
-    auto worldlines = read_simulation_worldlines(continue_file_manager, worldline_writer, n_timeslices, lattice_site_positions);
+    auto worldline_writer = worldline::WorldlineWriter<double, NDIM> {output_dirpath, "worldline", ".dat", parser.worldline_file_format};
+    auto worldlines = checkpoint ? std::move(checkpoint->worldlines) : read_simulation_worldlines(continue_file_manager, worldline_writer, n_timeslices, lattice_site_positions);
 
     sim::write_box_sides(output_dirpath / "box_sides.dat", minimage_box);
 
@@ -136,14 +164,54 @@ auto main(int argc, char** argv) -> int
         worldlines, periodic_distance_squared_calculator, interaction_handler.adjacency_matrix<1>(), triplet_cutoff_distance
     );
 
+    /* create the thread pool used by the estimators */
+    auto estimator_pool = common::ThreadPool {parser.n_estimator_threads};
+
+    // clang-format off
+    // the cell list triplet estimator truncates the three-body interaction; it is only worth it if the cell list prunes
+    const auto triplet_estimator_cutoff = parser.triplet_estimator_cutoff.value_or(coord::box_cutoff_distance(minimage_box));
+    if (parser.triplet_estimator_method == estim::TripletEstimatorMethod::CELL_LIST && !coord::is_cell_list_pruning_every_dimension(minimage_box, triplet_estimator_cutoff)) {
+        std::cout << "ERROR: the 'triplet_estimator_cutoff' must fit at least three cells along every side of the box\n";
+        std::cout << "Found: " << triplet_estimator_cutoff << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+
+    // the adjacency matrix of the triplet interaction handler is built once from the centroids, at the start of the run
+    const auto total_triplet_potential_energy_estimate = [&](const auto& threebody_pot) {
+        using TEM = estim::TripletEstimatorMethod;
+
+        switch (parser.triplet_estimator_method) {
+            case TEM::ADJACENCY_MATRIX : {
+                return estim::total_triplet_potential_energy_periodic(worldlines, threebody_pot.point_potential(), interaction_handler.adjacency_matrix<1>(), estimator_pool);
+            }
+            case TEM::ALL_TRIPLETS : {
+                return estim::total_triplet_potential_energy_periodic(worldlines, threebody_pot.point_potential(), estimator_pool);
+            }
+            case TEM::CELL_LIST : {
+                return estim::total_triplet_potential_energy_periodic(worldlines, threebody_pot.point_potential(), minimage_box, triplet_estimator_cutoff, estimator_pool);
+            }
+            default : {
+                throw std::logic_error {"impossible triplet estimator method"};
+            }
+        }
+    };
+    // clang-format on
+
     /* create the PRNG; save the seed (or set it?) */
     const auto prng_state_filepath = rng::default_prng_state_filepath(output_dirpath);
     auto prngw = create_prngw(prng_state_filepath, parser.initial_seed_state);
+    if (checkpoint) {
+        prngw.prng() = checkpoint->prng;
+    }
 
     /* create the move performers */
     auto com_mover = pimc::CentreOfMassMovePerformer<double, NDIM> {n_timeslices, com_step_size};
     auto single_bead_mover = pimc::SingleBeadPositionMovePerformer<double, NDIM> {n_timeslices};
     auto multi_bead_mover = pimc::BisectionMultibeadPositionMovePerformer<double, NDIM> {bisect_move_info};
+    if (checkpoint) {
+        com_mover.update_step_size(checkpoint->centre_of_mass_step_size);
+        multi_bead_mover.update_bisection_level_move_info(checkpoint->bisection_move_info);
+    }
 
     /* create the move adjusters */
     const auto com_move_adjuster = create_com_move_adjuster<double>(0.3, 0.4);
@@ -170,6 +238,58 @@ auto main(int argc, char** argv) -> int
     auto rms_centroid_writer = estim::default_rms_centroid_distance_writer<double>(output_dirpath);
     auto abs_centroid_writer = estim::default_absolute_centroid_distance_writer<double>(output_dirpath);
 
+    /* keep a running blocking analysis of each estimator, for its error and effective sample size */
+    // clang-format off
+    auto kinetic_statistics = estim::default_estimator_statistics<double>("kinetic", estim::writers::DEFAULT_KINETIC_OUTPUT_FILENAME, output_dirpath);
+    auto pair_potential_statistics = estim::default_estimator_statistics<double>("pair", estim::writers::DEFAULT_PAIR_POTENTIAL_OUTPUT_FILENAME, output_dirpath);
+    auto triplet_potential_statistics = estim::default_estimator_statistics<double>("triplet", estim::writers::DEFAULT_TRIPLET_POTENTIAL_OUTPUT_FILENAME, output_dirpath);
+    auto rms_centroid_statistics = estim::default_estimator_statistics<double>("rms_centroid", estim::writers::DEFAULT_RMS_CENTROID_DISTANCE_OUTPUT_FILENAME, output_dirpath);
+    auto abs_centroid_statistics = estim::default_estimator_statistics<double>("absolute_centroid", estim::writers::DEFAULT_ABSOLUTE_CENTROID_DISTANCE_OUTPUT_FILENAME, output_dirpath);
+    // clang-format on
+
+    // the analyses are stored in the checkpoint in this order
+    const auto estimator_statistics = std::array {
+        &kinetic_statistics,
+        &pair_potential_statistics,
+        &triplet_potential_statistics,
+        &rms_centroid_statistics,
+        &abs_centroid_statistics
+    };
+
+    if (checkpoint && checkpoint->estimator_statistics.size() == estimator_statistics.size()) {
+        for (std::size_t i_stats {0}; i_stats < estimator_statistics.size(); ++i_stats) {
+            estimator_statistics[i_stats]->restore(checkpoint->estimator_statistics[i_stats]);
+        }
+    }
+
+    /* the run stops early once every estimator with a target relative error has reached it */
+    auto error_targets = std::vector<std::pair<const estim::EstimatorStatistics<double>*, double>> {};
+    for (const auto& [name, target] : parser.target_relative_errors) {
+        const auto is_named = [&](const auto* statistics) { return statistics->name() == name; };
+        const auto it = std::find_if(estimator_statistics.begin(), estimator_statistics.end(), is_named);
+
+        if (it == estimator_statistics.end()) {
+            std::cout << "ERROR: 'target_relative_error' names an unknown estimator: '" << name << "'\n";
+            std::cout << "The estimators are:";
+            for (const auto* statistics : estimator_statistics) {
+                std::cout << ' ' << statistics->name();
+            }
+            std::cout << '\n';
+            std::exit(EXIT_FAILURE);
+        }
+
+        error_targets.emplace_back(*it, target);
+    }
+
+    const auto are_error_targets_met = [&]() {
+        const auto is_target_met = [](const auto& error_target) {
+            const auto& [statistics, target] = error_target;
+            return sim::is_relative_error_target_met(statistics->estimate(), target);
+        };
+
+        return !error_targets.empty() && std::all_of(error_targets.begin(), error_targets.end(), is_target_met);
+    };
+
     /* create the histogram and the histogram writers */
     const auto radial_dist_histo_filepath = output_dirpath / "radial_dist_histo.dat";
     auto radial_dist_histo = create_histogram(radial_dist_histo_filepath, continue_file_manager, minimage_box);
@@ -177,70 +297,238 @@ auto main(int argc, char** argv) -> int
     const auto centroid_dist_histo_filepath = output_dirpath / "centroid_radial_dist_histo.dat";
     auto centroid_dist_histo = create_histogram(centroid_dist_histo_filepath, continue_file_manager, minimage_box);
 
+    if (checkpoint) {
+        radial_dist_histo = checkpoint->histograms.at(0);
+        centroid_dist_histo = checkpoint->histograms.at(1);
+    }
+
     /* create the timer and the corresponding writer to keep track of how long each block takes */
     auto timer = sim::Timer {};
     auto timer_writer = sim::default_timer_writer(output_dirpath);
 
+    /* split the time for each block between the phases of the loop */
+    auto phase_timer = sim::DefaultPhaseTimer {};
+    auto timing_breakdown_writer = sim::default_timing_breakdown_writer(output_dirpath);
+
+    /* count the interactions evaluated in each block */
+    auto interaction_counts_writer = interact::default_interaction_counts_writer(output_dirpath);
+
+    /* read the hardware performance counters around the moves, estimators, and I/O of the main thread */
+    auto hardware_counters = sim::HardwareCounterPhases {parser.record_hardware_counters};
+    auto hardware_counters_writer = sim::default_hardware_counters_writer(output_dirpath);
+    if (parser.record_hardware_counters && !hardware_counters.is_available()) {
+        std::cout << "NOTE: the hardware performance counters are unavailable, and will not be recorded.\n";
+    }
+
+    /* record a timeline of the scopes in a chosen range of blocks */
+    const auto is_block_traced = [&](std::size_t i_block) {
+        if (!parser.traced_block_indices) {
+            return false;
+        }
+
+        const auto [first_traced, last_traced] = parser.traced_block_indices.value();
+        return i_block >= first_traced && i_block < last_traced;
+    };
+
+    const auto write_trace = [&]() {
+        common::trace::set_recording(false);
+        const auto summary = common::trace::write_trace_events(output_dirpath / "trace_events.json");
+        std::cout << "Wrote " << summary.n_events << " trace events";
+        if (summary.n_overwritten_events != 0) {
+            std::cout << " (the " << summary.n_overwritten_events << " oldest events were overwritten)";
+        }
+        std::cout << '\n';
+    };
+
+    if (parser.traced_block_indices && !common::trace::IS_TRACING_ENABLED) {
+        std::cout << "NOTE: trace events were not compiled in, and the traced blocks will not be recorded.\n";
+    }
+
     auto i_most_recent_saved_worldline = std::optional<std::size_t> {std::nullopt};
+    if (checkpoint && checkpoint->info.is_at_least_one_worldline_index_saved) {
+        i_most_recent_saved_worldline = checkpoint->info.most_recent_saved_worldline_index;
+    }
+
+    /* the files are written on a background thread, from snapshots of the data taken at the batch boundary */
+    auto writer_service = common::writers::AsyncWriterService {};
+
+    const auto submit_write = [&](auto& writer) {
+        writer_service.submit([&writer, data = writer.take_buffered_data()]() { writer.write_data(data); });
+    };
 
     const auto write_estimates = [&]() {
-        kinetic_writer.write_and_clear();
-        pair_potential_writer.write_and_clear();
-        triplet_potential_writer.write_and_clear();
-        rms_centroid_writer.write_and_clear();
-        abs_centroid_writer.write_and_clear();
+        submit_write(kinetic_writer);
+        submit_write(pair_potential_writer);
+        submit_write(triplet_potential_writer);
+        submit_write(rms_centroid_writer);
+        submit_write(abs_centroid_writer);
+        for (auto* statistics : estimator_statistics) {
+            submit_write(statistics->writer());
+        }
+    };
+
+    // an effective sample size from a blocking analysis that hasn't found a plateau yet is only an upper bound
+    const auto print_estimator_statistics = [&](std::size_t i_block) {
+        std::cout << "block " << i_block << ", effective sample sizes:";
+        for (const auto* statistics : estimator_statistics) {
+            const auto estimate = statistics->estimate();
+            std::cout << ' ' << statistics->name() << (estimate.is_converged ? " = " : " <= ");
+            std::cout << std::fixed << std::setprecision(1) << estimate.effective_sample_size;
+        }
+        std::cout << '\n';
+
+        if (!error_targets.empty()) {
+            std::cout << "block " << i_block << ", relative errors:";
+            for (const auto& [statistics, target] : error_targets) {
+                const auto error = sim::relative_error(statistics->estimate());
+                std::cout << ' ' << statistics->name() << " = " << std::scientific << std::setprecision(2) << error;
+                std::cout << " (target " << target << ')';
+            }
+            std::cout << '\n';
+        }
     };
 
     const auto write_moves = [&]() {
-        com_move_writer.write_and_clear();
-        single_bead_move_writer.write_and_clear();
-        multi_bead_move_writer.write_and_clear();
-        com_step_size_writer.write_and_clear();
-        multi_bead_move_info_writer.write_and_clear();
+        submit_write(com_move_writer);
+        submit_write(single_bead_move_writer);
+        submit_write(multi_bead_move_writer);
+        submit_write(com_step_size_writer);
+        submit_write(multi_bead_move_info_writer);
     };
 
     const auto write_timer = [&]() {
-        timer_writer.write_and_clear();
+        submit_write(timer_writer);
+        if constexpr (sim::IS_PHASE_TIMING_ENABLED) {
+            submit_write(timing_breakdown_writer);
+        }
+        if constexpr (interact::IS_INTERACTION_COUNTING_ENABLED) {
+            submit_write(interaction_counts_writer);
+        }
+        if (hardware_counters.is_available()) {
+            submit_write(hardware_counters_writer);
+        }
     };
 
     const auto write_histograms = [&]() {
-        mathtools::io::write_histogram(radial_dist_histo_filepath, radial_dist_histo);
-        mathtools::io::write_histogram(centroid_dist_histo_filepath, centroid_dist_histo);
+        writer_service.submit([&, histo = radial_dist_histo]() { mathtools::io::write_histogram(radial_dist_histo_filepath, histo); });
+        writer_service.submit([&, histo = centroid_dist_histo]() { mathtools::io::write_histogram(centroid_dist_histo_filepath, histo); });
     };
 
-    const auto write_continue_and_prng = [&](std::size_t i_block) {
-        /* create or update the continue file */
+    // the tasks run in order, so the checkpoint is only updated once everything before it is written
+    const auto write_checkpoint = [&](std::size_t i_block) {
+        /* create or update the checkpoint, and the continue file */
+        const auto is_equilibration_complete = i_block >= parser.n_equilibrium_blocks;
+        auto continue_info = sim::SimulationContinueInfo {i_block, 0, false, is_equilibration_complete};
         if (i_most_recent_saved_worldline) {
-            const auto worldline_index = i_most_recent_saved_worldline.value();
-            continue_file_manager.set_info_and_serialize({i_block, worldline_index, true, i_block >= parser.n_equilibrium_blocks});
-        } else {
-            continue_file_manager.set_info_and_serialize({i_block, 0, false, i_block >= parser.n_equilibrium_blocks});
+            continue_info.most_recent_saved_worldline_index = i_most_recent_saved_worldline.value();
+            continue_info.is_at_least_one_worldline_index_saved = true;
         }
 
-        rng::save_prng_state(prngw.prng(), prng_state_filepath);
+        auto statistics_analyses = std::vector<mathtools::StreamingBlockingAnalysis<double>> {};
+        for (const auto* statistics : estimator_statistics) {
+            statistics_analyses.push_back(statistics->analysis());
+        }
+
+        auto block_checkpoint = sim::SimulationCheckpoint<double, NDIM> {
+            continue_info,
+            worldlines,
+            prngw.prng(),
+            {radial_dist_histo, centroid_dist_histo},
+            com_mover.step_size(),
+            multi_bead_mover.bisection_level_move_info(),
+            std::move(statistics_analyses)
+        };
+
+        writer_service.submit([&, block_checkpoint = std::move(block_checkpoint)]() {
+            continue_file_manager.write_checkpoint(block_checkpoint);
+            continue_file_manager.set_info_and_serialize(block_checkpoint.info);
+            rng::save_prng_state(block_checkpoint.prng, prng_state_filepath);
+        });
+    };
+
+    /* report the memory held by the large objects; printed now, and again whenever SIGUSR1 is received */
+    const auto writers_memory_usage = [](const auto&... writers) { return (writers.memory_usage() + ...); };
+
+    // clang-format off
+    const auto print_memory_report = [&]() {
+        auto report = sim::MemoryReport {};
+        report.add("worldlines", worldlines.memory_usage());
+        report.add("pair adjacency matrix", interaction_handler.adjacency_matrix<0>().memory_usage());
+        report.add("triplet adjacency matrix", interaction_handler.adjacency_matrix<1>().memory_usage());
+        report.add("pair potentials", common::memory_usage(pot) + common::memory_usage(interaction_handler.get<0>().point_potential()));
+        report.add("three-body potential", common::memory_usage(interaction_handler.get<1>().point_potential()));
+        report.add("histograms", radial_dist_histo.memory_usage() + centroid_dist_histo.memory_usage());
+        report.add("estimator writer buffers", writers_memory_usage(kinetic_writer, pair_potential_writer, triplet_potential_writer, rms_centroid_writer, abs_centroid_writer));
+        report.add("move writer buffers", writers_memory_usage(com_move_writer, single_bead_move_writer, multi_bead_move_writer, com_step_size_writer, multi_bead_move_info_writer));
+        report.add("timing writer buffers", writers_memory_usage(timer_writer, timing_breakdown_writer, interaction_counts_writer, hardware_counters_writer));
+        report.add("estimator statistics", writers_memory_usage(kinetic_statistics, pair_potential_statistics, triplet_potential_statistics, rms_centroid_statistics, abs_centroid_statistics));
+        report.add("trace buffers", common::trace::memory_usage());
+
+        sim::print_memory_report(std::cout, report, sim::read_resident_set_size());
     };
+    // clang-format on
+
+    print_memory_report();
+    sim::install_memory_report_signal_handler();
+
+    auto i_last_completed_block = std::optional<std::size_t> {std::nullopt};
 
     /* perform the simulation loop */
     for (std::size_t i_block {first_block_index}; i_block < last_block_index; ++i_block) {
-        timer.start();
-        /* the number of passes is chosen such that the autocorrelation time between blocks is passed */
-        for (std::size_t i_pass {0}; i_pass < parser.n_passes; ++i_pass) {
-            /* perform COM move for each particle */
-            for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
-                com_mover(i_part, worldlines, prngw, interaction_handler, environment, &com_tracker);
-
-                for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
-                    /* perform bead move on timeslice `i_tslice` of each particle */
-                    single_bead_mover(
-                        i_part, i_tslice, worldlines, prngw, interaction_handler, environment, &single_bead_tracker
-                    );
-                }
+        // the events of the previous block are complete once its scopes have closed
+        if (common::trace::is_recording() && !is_block_traced(i_block)) {
+            write_trace();
+        }
+        common::trace::set_recording(is_block_traced(i_block));
+        const auto block_trace = common::trace::TraceScope {"block", "i_block", static_cast<std::int64_t>(i_block)};
 
-                for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
-                    /* perform bead move on timeslice `i_tslice` of each particle */
-                    multi_bead_mover(
-                        i_part, i_tslice, worldlines, prngw, interaction_handler, environment, &multi_bead_tracker
-                    );
+        timer.start();
+        wall_clock_budget.start_block();
+        {
+            const auto counter_scope = hardware_counters.scope(sim::HardwareCounterPhase::MOVES);
+
+            /* the number of passes is chosen such that the autocorrelation time between blocks is passed */
+            for (std::size_t i_pass {0}; i_pass < parser.n_passes; ++i_pass) {
+                const auto pass_trace = common::trace::TraceScope {"pass", "i_pass", static_cast<std::int64_t>(i_pass)};
+
+                /* perform COM move for each particle */
+                for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+                    {
+                        const auto phase_scope = phase_timer.scope(sim::SimulationPhase::CENTRE_OF_MASS_MOVES);
+                        com_mover(i_part, worldlines, prngw, interaction_handler, environment, &com_tracker);
+                    }
+
+                    {
+                        const auto phase_scope = phase_timer.scope(sim::SimulationPhase::SINGLE_BEAD_MOVES);
+                        for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+                            /* perform bead move on timeslice `i_tslice` of each particle */
+                            single_bead_mover(
+                                i_part,
+                                i_tslice,
+                                worldlines,
+                                prngw,
+                                interaction_handler,
+                                environment,
+                                &single_bead_tracker
+                            );
+                        }
+                    }
+
+                    {
+                        const auto phase_scope = phase_timer.scope(sim::SimulationPhase::BISECTION_MOVES);
+                        for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+                            /* perform bead move on timeslice `i_tslice` of each particle */
+                            multi_bead_mover(
+                                i_part,
+                                i_tslice,
+                                worldlines,
+                                prngw,
+                                interaction_handler,
+                                environment,
+                                &multi_bead_tracker
+                            );
+                        }
+                    }
                 }
             }
         }
@@ -259,26 +547,47 @@ auto main(int argc, char** argv) -> int
         if (i_block >= parser.n_equilibrium_blocks) {
             const auto& threebody_pot = interaction_handler.get<1>();
 
-            /* run estimators */
-            const auto total_kinetic_energy = estim::total_primitive_kinetic_energy(worldlines, environment);
-            const auto total_pair_potential_energy = estim::total_pair_potential_energy_periodic(worldlines, pot);
-            const auto total_triplet_potential_energy = estim::total_triplet_potential_energy_periodic(worldlines, threebody_pot.point_potential());
-            const auto rms_centroid_dist = estim::rms_centroid_distance(worldlines);
-            const auto abs_centroid_dist = estim::absolute_centroid_distance(worldlines);
-
-            /* accumulate estimators */
-            kinetic_writer.accumulate({i_block, total_kinetic_energy});
-            pair_potential_writer.accumulate({i_block, total_pair_potential_energy});
-            triplet_potential_writer.accumulate({i_block, total_triplet_potential_energy});
-            rms_centroid_writer.accumulate({i_block, rms_centroid_dist});
-            abs_centroid_writer.accumulate({i_block, abs_centroid_dist});
+            {
+                const auto phase_scope = phase_timer.scope(sim::SimulationPhase::ESTIMATORS);
+                const auto trace = common::trace::TraceScope {"estimators"};
+                const auto counter_scope = hardware_counters.scope(sim::HardwareCounterPhase::ESTIMATORS);
+
+                /* run estimators */
+                const auto total_kinetic_energy = estim::total_primitive_kinetic_energy(worldlines, environment);
+                const auto total_pair_potential_energy = estim::total_pair_potential_energy_periodic(worldlines, pot, estimator_pool);
+                const auto total_triplet_potential_energy = total_triplet_potential_energy_estimate(threebody_pot);
+                const auto rms_centroid_dist = estim::rms_centroid_distance(worldlines);
+                const auto abs_centroid_dist = estim::absolute_centroid_distance(worldlines);
+
+                /* accumulate estimators */
+                kinetic_writer.accumulate({i_block, total_kinetic_energy});
+                pair_potential_writer.accumulate({i_block, total_pair_potential_energy});
+                triplet_potential_writer.accumulate({i_block, total_triplet_potential_energy});
+                rms_centroid_writer.accumulate({i_block, rms_centroid_dist});
+                abs_centroid_writer.accumulate({i_block, abs_centroid_dist});
+
+                /* update the running statistics */
+                kinetic_statistics.add(i_block, total_kinetic_energy);
+                pair_potential_statistics.add(i_block, total_pair_potential_energy);
+                triplet_potential_statistics.add(i_block, total_triplet_potential_energy);
+                rms_centroid_statistics.add(i_block, rms_centroid_dist);
+                abs_centroid_statistics.add(i_block, abs_centroid_dist);
+            }
 
             /* update radial distribution function histogram */
-            estim::update_radial_distribution_function_histogram(radial_dist_histo, periodic_distance_calculator, worldlines);
-            estim::update_centroid_radial_distribution_function_histogram(centroid_dist_histo, periodic_distance_calculator, worldlines);
+            {
+                const auto phase_scope = phase_timer.scope(sim::SimulationPhase::RADIAL_DISTRIBUTION_FUNCTIONS);
+                const auto trace = common::trace::TraceScope {"radial_distribution_functions"};
+                const auto counter_scope = hardware_counters.scope(sim::HardwareCounterPhase::ESTIMATORS);
+                estim::update_radial_distribution_function_histogram(radial_dist_histo, periodic_distance_calculator, worldlines, estimator_pool);
+                estim::update_centroid_radial_distribution_function_histogram(centroid_dist_histo, periodic_distance_calculator, worldlines);
+            }
 
             /* save the worldlines */
             if (parser.save_worldlines && ((i_block % parser.n_save_worldlines_every) == 0)) {
+                const auto phase_scope = phase_timer.scope(sim::SimulationPhase::WORLDLINE_SAVES);
+                const auto trace = common::trace::TraceScope {"worldline_save"};
+                const auto counter_scope = hardware_counters.scope(sim::HardwareCounterPhase::INPUT_OUTPUT);
                 worldline_writer.write(i_block, worldlines);
                 i_most_recent_saved_worldline = i_block;
             }
@@ -307,19 +616,73 @@ auto main(int argc, char** argv) -> int
 
         /* write out the batch of estimates and update the histogram files */
         if ((i_block % parser.writer_batch_size) == 0) {
+            const auto phase_scope = phase_timer.scope(sim::SimulationPhase::WRITER_FLUSHES);
+            const auto trace = common::trace::TraceScope {"writer_flush"};
+            const auto counter_scope = hardware_counters.scope(sim::HardwareCounterPhase::INPUT_OUTPUT);
             write_estimates();
             write_moves();
             write_histograms();
             write_timer();
-            write_continue_and_prng(i_block);
+            write_checkpoint(i_block);
+
+            if (kinetic_statistics.analysis().n_samples() >= 2) {
+                print_estimator_statistics(i_block);
+            }
+        }
+
+        // the flush above belongs to this block, so its breakdown is recorded after it
+        if constexpr (sim::IS_PHASE_TIMING_ENABLED) {
+            timing_breakdown_writer.accumulate(phase_timer.block_data(i_block));
+            phase_timer.reset();
+        }
+
+        // no interactions are evaluated between blocks, so the counts all belong to this block
+        if constexpr (interact::IS_INTERACTION_COUNTING_ENABLED) {
+            const auto counts = interact::collect_interaction_counts();
+            interaction_counts_writer.accumulate(interact::interaction_counts_block_data(i_block, counts));
+        }
+
+        if (hardware_counters.is_available()) {
+            hardware_counters_writer.accumulate(hardware_counters.block_data(i_block));
+            hardware_counters.reset();
         }
+
+        if (sim::is_memory_report_requested()) {
+            print_memory_report();
+        }
+
+        wall_clock_budget.end_block();
+        i_last_completed_block = i_block;
+
+        /* stop at this block boundary if running any longer is unnecessary, or can't be afforded */
+        if (i_block + 1 < last_block_index) {
+            if (are_error_targets_met()) {
+                std::cout << "Stopping after block " << i_block << ": every target relative error has been reached.\n";
+                break;
+            }
+
+            if (wall_clock_budget.is_nearly_exhausted()) {
+                std::cout << "Stopping after block " << i_block << ": the wall-clock budget would run out during ";
+                std::cout << "the next block.\n";
+                break;
+            }
+        }
+    }
+
+    if (common::trace::is_recording()) {
+        write_trace();
     }
 
     write_estimates();
     write_moves();
     write_histograms();
     write_timer();
-    write_continue_and_prng(last_block_index);
+    // the checkpoint records the last block that was completed
+    if (i_last_completed_block) {
+        write_checkpoint(i_last_completed_block.value());
+    }
+
+    writer_service.fence();
 
     return 0;
 }
@@ -7,6 +7,7 @@
 #include <type_traits>
 #include <vector>
 
+#include <common/memory_usage.hpp>
 #include <mathtools/grid/grid_iterator.hpp>
 #include <mathtools/mathtools_utils.hpp>
 
@@ -101,6 +102,11 @@ public:
         return {begin, end};
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::vector_memory_usage(data_);
+    }
+
 private:
     std::size_t n_rows_;
     std::size_t n_cols_;
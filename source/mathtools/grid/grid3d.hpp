@@ -2,12 +2,16 @@
 
 #include <concepts>
 #include <cstddef>
+#include <memory>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <common/common_utils.hpp>
+#include <common/memory_usage.hpp>
 #include <mathtools/mathtools_utils.hpp>
 
 namespace mathtools
@@ -28,6 +32,13 @@ struct Index3D
     std::size_t idx2;
 };
 
+/*
+    A Grid3D either owns its values, or is a read-only view of values owned by someone else, such as a
+    memory-mapped file whose pages are shared by every process that maps it. The `shared_data` pointer
+    keeps the owner of a viewed block alive for as long as any grid refers to it.
+
+    `set()` may only be called on grids that own their values.
+*/
 template <common::Numeric Number>
 class Grid3D
 {
@@ -41,6 +52,7 @@ public:
         mathtools_utils::ctr_check_positive(shape_.size2, "size2");
 
         data_.resize(shape_.size0 * shape_.size1 * shape_.size2);
+        values_ = data_.data();
     }
 
     Grid3D(std::vector<Number> data, Shape3D shape)
@@ -59,12 +71,54 @@ public:
             err_msg << shape_.size0 << ", " << shape_.size1 << ", " << shape_.size2 << '\n';
             throw std::runtime_error {err_msg.str()};
         }
+
+        values_ = data_.data();
+    }
+
+    // the block pointed to by `shared_data` must hold `size0 * size1 * size2` values
+    Grid3D(std::shared_ptr<const Number> shared_data, Shape3D shape)
+        : shape_ {shape}
+        , data_ {}
+        , shared_data_ {std::move(shared_data)}
+        , values_ {shared_data_.get()}
+    {
+        mathtools_utils::ctr_check_positive(shape_.size0, "size0");
+        mathtools_utils::ctr_check_positive(shape_.size1, "size1");
+        mathtools_utils::ctr_check_positive(shape_.size2, "size2");
+
+        if (!shared_data_) {
+            throw std::runtime_error {"Attempting to create a Grid3D instance that views a null block of data.\n"};
+        }
     }
 
+    Grid3D(const Grid3D& other)
+        : shape_ {other.shape_}
+        , data_ {other.data_}
+        , shared_data_ {other.shared_data_}
+        , values_ {other.shared_data_ ? other.values_ : data_.data()}
+    {}
+
+    auto operator=(const Grid3D& other) -> Grid3D&
+    {
+        if (this != &other) {
+            shape_ = other.shape_;
+            data_ = other.data_;
+            shared_data_ = other.shared_data_;
+            values_ = shared_data_ ? other.values_ : data_.data();
+        }
+
+        return *this;
+    }
+
+    // moving a std::vector keeps its buffer, so `values_` stays valid
+    Grid3D(Grid3D&&) noexcept = default;
+    auto operator=(Grid3D&&) noexcept -> Grid3D& = default;
+    ~Grid3D() = default;
+
     constexpr auto get(std::size_t i0, std::size_t i1, std::size_t i2) const noexcept -> Number
     {
         const auto index = i2 + shape_.size2 * i1 + shape_.size2 * shape_.size1 * i0;
-        return data_[index];
+        return values_[index];
     }
 
     constexpr void set(std::size_t i0, std::size_t i1, std::size_t i2, Number value) noexcept
@@ -73,9 +127,9 @@ public:
         data_[index] = value;
     }
 
-    constexpr auto data() const noexcept -> const std::vector<Number>&
+    constexpr auto data() const noexcept -> std::span<const Number>
     {
-        return data_;
+        return {values_, shape_.size0 * shape_.size1 * shape_.size2};
     }
 
     constexpr auto shape() const noexcept -> Shape3D
@@ -83,9 +137,26 @@ public:
         return shape_;
     }
 
+    constexpr auto is_shared() const noexcept -> bool
+    {
+        return static_cast<bool>(shared_data_);
+    }
+
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        auto usage = common::vector_memory_usage(data_);
+        if (shared_data_) {
+            usage.shared_bytes += shape_.size0 * shape_.size1 * shape_.size2 * sizeof(Number);
+        }
+
+        return usage;
+    }
+
 private:
     Shape3D shape_;
     std::vector<Number> data_;
+    std::shared_ptr<const Number> shared_data_ {};
+    const Number* values_ {nullptr};
 };
 
 }  // namespace mathtools
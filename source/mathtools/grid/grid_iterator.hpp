@@ -65,14 +65,12 @@ public:
         return temp;
     }
 
-    template <typename U>
-    friend constexpr auto operator==(const GridIterator<U>& left, const GridIterator<U>& right) noexcept -> bool
+    friend constexpr auto operator==(const GridIterator& left, const GridIterator& right) noexcept -> bool
     {
         return left.ptr_ == right.ptr_;
     }
 
-    template <typename U>
-    friend constexpr auto operator!=(const GridIterator<U>& left, const GridIterator<U>& right) noexcept -> bool
+    friend constexpr auto operator!=(const GridIterator& left, const GridIterator& right) noexcept -> bool
     {
         return !(left == right);
     }
@@ -162,16 +160,12 @@ public:
         return temp;
     }
 
-    template <typename U>
-    friend constexpr auto operator==(const ConstGridIterator<U>& left, const ConstGridIterator<U>& right) noexcept
-        -> bool
+    friend constexpr auto operator==(const ConstGridIterator& left, const ConstGridIterator& right) noexcept -> bool
     {
         return left.ptr_ == right.ptr_;
     }
 
-    template <typename U>
-    friend constexpr auto operator!=(const ConstGridIterator<U>& left, const ConstGridIterator<U>& right) noexcept
-        -> bool
+    friend constexpr auto operator!=(const ConstGridIterator& left, const ConstGridIterator& right) noexcept -> bool
     {
         return !(left == right);
     }
@@ -4,7 +4,9 @@
 #include <span>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
+#include <common/memory_usage.hpp>
 #include <mathtools/grid/grid2d.hpp>
 #include <mathtools/mathtools_utils.hpp>
 
@@ -72,6 +74,11 @@ public:
         return {neighbours_start, neighbours_end};
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return index_grid_.memory_usage() + common::vector_memory_usage(sizes_);
+    }
+
 private:
     std::size_t n_particles_;
     Grid2D<std::size_t> index_grid_;
@@ -1,14 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <iomanip>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
 
+#include <common/memory_usage.hpp>
+
 namespace mathtools
 {
 
@@ -27,6 +32,7 @@ public:
         , min_ {min}
         , max_ {max}
         , step_size_ {calculate_step_size_(min, max, n_bins)}
+        , inverse_step_size_ {FP {1.0} / step_size_}
         , policy_ {policy}
     {}
 
@@ -35,6 +41,7 @@ public:
         , min_ {min}
         , max_ {max}
         , step_size_ {calculate_step_size_(min, max, bins_.size())}
+        , inverse_step_size_ {FP {1.0} / step_size_}
         , policy_ {policy}
     {}
 
@@ -71,27 +78,50 @@ public:
 
     auto add(FP value, std::uint64_t count = 1) -> bool
     {
-        if (policy_ == OutOfRangePolicy::THROW) {
-            auto err_msg = std::stringstream {};
-            err_msg << "Received an entry outside of the bounds of the histogram!\n";
-            err_msg << std::scientific << std::setprecision(8);
-            err_msg << "Found: " << value << '\n';
-            err_msg << "min bound = " << min_ << '\n';
-            err_msg << "max bound = " << max_ << '\n';
+        // written so that NaN is also out of range, as it is in `add_many()`
+        if (!(value >= min_ && value < max_)) {
+            if (policy_ == OutOfRangePolicy::THROW) {
+                throw_out_of_range_(value);
+            }
 
-            throw std::runtime_error {err_msg.str()};
+            return false;
         }
 
-        if (value < min_ || value >= max_) {
-            return false;
+        bins_[bin_index_(value)] += count;
+
+        return true;
+    }
+
+    /*
+        Add every value in `values` to the histogram, and return how many of them were in range; this gives
+        the same bins as calling `add()` on each value, but the bin indices of each chunk of values are
+        calculated together in a branch-free loop that the compiler can vectorize.
+    */
+    auto add_many(std::span<const FP> values) -> std::size_t
+    {
+        auto n_added = std::size_t {0};
+
+        for (std::size_t i_start {0}; i_start < values.size(); i_start += CHUNK_SIZE_) {
+            const auto chunk = values.subspan(i_start, std::min(CHUNK_SIZE_, values.size() - i_start));
+            n_added += add_chunk_(chunk);
         }
 
-        const auto fp_index = std::floor((value - min_) / step_size_);
-        const auto index = static_cast<std::uint64_t>(fp_index);
+        return n_added;
+    }
 
-        bins_[index] += count;
+    /*
+        Add the counts of another histogram with the same bounds and number of bins to this one; this
+        is how histograms filled separately (for example, on different threads) are combined.
+    */
+    void merge(const Histogram<FP>& other)
+    {
+        if (other.min_ != min_ || other.max_ != max_ || other.bins_.size() != bins_.size()) {
+            throw std::runtime_error {"Cannot merge histograms with different bounds or numbers of bins.\n"};
+        }
 
-        return true;
+        for (std::size_t i {0}; i < bins_.size(); ++i) {
+            bins_[i] += other.bins_[i];
+        }
     }
 
     constexpr void set_policy(OutOfRangePolicy policy) noexcept
@@ -99,13 +129,72 @@ public:
         policy_ = policy;
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::vector_memory_usage(bins_);
+    }
+
 private:
+    constexpr static auto CHUNK_SIZE_ = std::size_t {256};
+
     std::vector<std::uint64_t> bins_;
     FP min_;
     FP max_;
     FP step_size_;
+    FP inverse_step_size_;
     OutOfRangePolicy policy_;
 
+    // the clamp guards against a value just below `max_` being rounded up into a bin past the end
+    constexpr auto bin_index_(FP value) const noexcept -> std::size_t
+    {
+        const auto max_index = static_cast<FP>(bins_.size() - 1);
+        const auto fp_index = std::min(std::floor((value - min_) * inverse_step_size_), max_index);
+
+        return static_cast<std::size_t>(fp_index);
+    }
+
+    auto add_chunk_(std::span<const FP> chunk) -> std::size_t
+    {
+        auto indices = std::array<std::size_t, CHUNK_SIZE_> {};
+        auto is_in_range = std::array<bool, CHUNK_SIZE_> {};
+        const auto max_index = static_cast<FP>(bins_.size() - 1);
+
+        // out-of-range values (including NaN) are clamped into the histogram here, and skipped below
+        for (std::size_t i {0}; i < chunk.size(); ++i) {
+            const auto value = chunk[i];
+            const auto fp_index = std::floor((value - min_) * inverse_step_size_);
+            is_in_range[i] = (value >= min_) & (value < max_);
+            indices[i] = static_cast<std::size_t>(std::max(FP {0.0}, std::min(fp_index, max_index)));
+        }
+
+        auto n_added = std::size_t {0};
+        for (std::size_t i {0}; i < chunk.size(); ++i) {
+            if (!is_in_range[i]) {
+                if (policy_ == OutOfRangePolicy::THROW) {
+                    throw_out_of_range_(chunk[i]);
+                }
+                continue;
+            }
+
+            ++bins_[indices[i]];
+            ++n_added;
+        }
+
+        return n_added;
+    }
+
+    void throw_out_of_range_(FP value) const
+    {
+        auto err_msg = std::stringstream {};
+        err_msg << "Received an entry outside of the bounds of the histogram!\n";
+        err_msg << std::scientific << std::setprecision(8);
+        err_msg << "Found: " << value << '\n';
+        err_msg << "min bound = " << min_ << '\n';
+        err_msg << "max bound = " << max_ << '\n';
+
+        throw std::runtime_error {err_msg.str()};
+    }
+
     auto calculate_step_size_(FP min, FP max, std::size_t n_bins) const -> FP
     {
         if (n_bins < 1) {
@@ -6,6 +6,7 @@
 #include <utility>
 #include <vector>
 
+#include <common/memory_usage.hpp>
 #include <mathtools/mathtools_utils.hpp>
 
 namespace mathtools
@@ -53,6 +54,11 @@ public:
         return this->operator()(x);
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::vector_memory_usage(ydata_) + common::vector_memory_usage(slopes_);
+    }
+
 private:
     std::vector<FP> ydata_;
     FP xmin_;
@@ -2,6 +2,7 @@
 
 #include <concepts>
 
+#include <common/memory_usage.hpp>
 #include <mathtools/grid/grid3d.hpp>
 #include <mathtools/mathtools_utils.hpp>
 
@@ -79,6 +80,11 @@ public:
         return limits2_;
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return grid_.memory_usage();
+    }
+
 private:
     Grid3D<FP> grid_;
     mathtools_utils::AxisLimits<FP> limits0_;
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <common/memory_usage.hpp>
+
+/*
+    A streaming version of the blocking analysis of Flyvbjerg and Petersen (J. Chem. Phys. 91, 461 (1989)),
+    for estimating the statistical error of the mean of a correlated sequence of values, like the
+    estimates from the blocks of a Markov chain.
+
+    The values are repeatedly averaged in neighbouring pairs; level 0 holds the values themselves, level 1
+    holds the averages of pairs of values, level 2 the averages of pairs of those averages, and so on. Each
+    level only keeps the running mean and sum of squared deviations of its values, and at most one value
+    waiting for its partner, so adding a value costs O(log N) time and the whole analysis O(log N) memory.
+
+    The naive standard error of the mean, calculated from the values of a level, grows with the level
+    until the averaged values are far enough apart to be uncorrelated, and then stays on a plateau; the
+    error on the plateau is the true standard error. The integrated autocorrelation time follows from how
+    much the plateau error exceeds the naive error of the level 0 values:
+
+        tau = (error on plateau / error at level 0)^2
+
+    This is the same convention as `pimc_simpy.statistics.autocorrelation` (tau = 1 + 2 sum_t rho(t)), so
+    uncorrelated values have tau = 1, and the effective number of independent samples is N / tau.
+*/
+
+namespace mathtools
+{
+
+// levels with fewer values than this give errors that are too noisy to be trusted
+constexpr inline auto MINIMUM_BLOCKING_LEVEL_SIZE = std::size_t {16};
+
+// the number of later trusted levels that must agree with a level for it to be the start of the plateau
+constexpr inline auto MINIMUM_PLATEAU_CONFIRMING_LEVELS = std::size_t {2};
+
+template <std::floating_point FP>
+struct BlockingLevel
+{
+    std::size_t n_values {0};
+    FP mean {0.0};
+    FP sum_squared_deviations {0.0};
+    bool has_unpaired_value {false};
+    FP unpaired_value {0.0};
+};
+
+/*
+    If no plateau is found, the standard error is the largest one among the levels with enough values to
+    be trusted, and `is_converged` is false; the true error (and the autocorrelation time) may be larger.
+*/
+template <std::floating_point FP>
+struct BlockingEstimate
+{
+    std::size_t n_samples {0};
+    FP mean {std::numeric_limits<FP>::quiet_NaN()};
+    FP standard_error {std::numeric_limits<FP>::quiet_NaN()};
+    FP autocorrelation_time {std::numeric_limits<FP>::quiet_NaN()};
+    FP effective_sample_size {std::numeric_limits<FP>::quiet_NaN()};
+    bool is_converged {false};
+};
+
+template <std::floating_point FP>
+class StreamingBlockingAnalysis
+{
+public:
+    StreamingBlockingAnalysis() = default;
+
+    // continue an analysis from the levels of an earlier one (for example, one read from a checkpoint)
+    explicit StreamingBlockingAnalysis(std::vector<BlockingLevel<FP>> levels)
+        : levels_ {std::move(levels)}
+    {}
+
+    void add(FP value)
+    {
+        for (std::size_t i_level {0};; ++i_level) {
+            if (i_level == levels_.size()) {
+                levels_.emplace_back();
+            }
+
+            auto& level = levels_[i_level];
+            add_to_level_(level, value);
+
+            if (!level.has_unpaired_value) {
+                level.has_unpaired_value = true;
+                level.unpaired_value = value;
+                return;
+            }
+
+            value = FP {0.5} * (level.unpaired_value + value);
+            level.has_unpaired_value = false;
+        }
+    }
+
+    auto n_samples() const noexcept -> std::size_t
+    {
+        return levels_.empty() ? 0 : levels_[0].n_values;
+    }
+
+    auto levels() const noexcept -> const std::vector<BlockingLevel<FP>>&
+    {
+        return levels_;
+    }
+
+    // the naive standard error of the mean, treating the values of the level as uncorrelated
+    auto level_standard_error(std::size_t i_level) const -> FP
+    {
+        const auto& level = levels_.at(i_level);
+        if (level.n_values < 2) {
+            return std::numeric_limits<FP>::quiet_NaN();
+        }
+
+        const auto n_values = static_cast<FP>(level.n_values);
+        const auto variance = level.sum_squared_deviations / (n_values - FP {1.0});
+
+        return std::sqrt(variance / n_values);
+    }
+
+    /*
+        The plateau starts at the first level that satisfies both of the following:
+          - its error is not exceeded, by more than their own statistical uncertainties, by the errors of
+            the later levels with enough values to be trusted; there must be at least
+            `MINIMUM_PLATEAU_CONFIRMING_LEVELS` of those
+          - its blocks are long compared to the autocorrelation time that its error implies, following
+            Lee, Kent, and Needs (Phys. Rev. B 84, 245117 (2011)):
+
+                (block size)^3 > 2 N tau^2
+
+        With few values, the errors of the levels are too noisy to tell a plateau apart from a slow rise,
+        and the first condition alone accepts plateaus that underestimate the error.
+    */
+    auto estimate() const -> BlockingEstimate<FP>
+    {
+        auto output = BlockingEstimate<FP> {};
+        output.n_samples = n_samples();
+        if (output.n_samples < 2) {
+            if (output.n_samples == 1) {
+                output.mean = levels_[0].mean;
+            }
+            return output;
+        }
+
+        output.mean = levels_[0].mean;
+
+        const auto naive_error = level_standard_error(0);
+        if (naive_error == FP {0.0}) {
+            output.standard_error = FP {0.0};
+            output.autocorrelation_time = FP {1.0};
+            output.effective_sample_size = static_cast<FP>(output.n_samples);
+            output.is_converged = true;
+            return output;
+        }
+
+        const auto n_trusted_levels = n_trusted_levels_();
+        const auto i_plateau = plateau_level_(n_trusted_levels);
+
+        if (i_plateau) {
+            output.standard_error = level_standard_error(*i_plateau);
+            output.is_converged = true;
+        }
+        else {
+            output.standard_error = naive_error;
+            for (std::size_t i_level {1}; i_level < n_trusted_levels; ++i_level) {
+                output.standard_error = std::max(output.standard_error, level_standard_error(i_level));
+            }
+        }
+
+        const auto error_ratio = output.standard_error / naive_error;
+        output.autocorrelation_time = error_ratio * error_ratio;
+        output.effective_sample_size = static_cast<FP>(output.n_samples) / output.autocorrelation_time;
+
+        return output;
+    }
+
+    auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return common::vector_memory_usage(levels_);
+    }
+
+private:
+    std::vector<BlockingLevel<FP>> levels_ {};
+
+    // Welford's update, which stays accurate when the fluctuations are small compared to the mean
+    static void add_to_level_(BlockingLevel<FP>& level, FP value) noexcept
+    {
+        ++level.n_values;
+        const auto delta = value - level.mean;
+        level.mean += delta / static_cast<FP>(level.n_values);
+        level.sum_squared_deviations += delta * (value - level.mean);
+    }
+
+    // the statistical uncertainty of the standard error itself, for normally distributed values
+    auto level_standard_error_uncertainty_(std::size_t i_level) const -> FP
+    {
+        const auto n_values = static_cast<FP>(levels_[i_level].n_values);
+        return level_standard_error(i_level) / std::sqrt(FP {2.0} * (n_values - FP {1.0}));
+    }
+
+    // the number of values halves with each level, so the trusted levels are the first few
+    auto n_trusted_levels_() const noexcept -> std::size_t
+    {
+        auto n_trusted = std::size_t {0};
+        while (n_trusted < levels_.size() && levels_[n_trusted].n_values >= MINIMUM_BLOCKING_LEVEL_SIZE) {
+            ++n_trusted;
+        }
+
+        return n_trusted;
+    }
+
+    // the block size criterion of Lee, Kent, and Needs, described above `estimate()`
+    auto is_block_size_long_enough_(std::size_t i_level) const -> bool
+    {
+        const auto error_ratio = level_standard_error(i_level) / level_standard_error(0);
+        const auto autocorrelation_time = error_ratio * error_ratio;
+
+        const auto block_size = std::ldexp(FP {1.0}, static_cast<int>(i_level));
+        const auto block_size_cubed = block_size * block_size * block_size;
+        const auto n_samples = static_cast<FP>(this->n_samples());
+
+        return block_size_cubed > FP {2.0} * n_samples * autocorrelation_time * autocorrelation_time;
+    }
+
+    auto plateau_level_(std::size_t n_trusted_levels) const -> std::optional<std::size_t>
+    {
+        for (std::size_t i_level {0}; i_level + MINIMUM_PLATEAU_CONFIRMING_LEVELS < n_trusted_levels; ++i_level) {
+            if (!is_block_size_long_enough_(i_level)) {
+                continue;
+            }
+
+            const auto error = level_standard_error(i_level);
+
+            auto is_plateau = bool {true};
+            for (std::size_t i_later {i_level + 1}; i_later < n_trusted_levels; ++i_later) {
+                if (level_standard_error(i_later) - error > level_standard_error_uncertainty_(i_later)) {
+                    is_plateau = false;
+                    break;
+                }
+            }
+
+            if (is_plateau) {
+                return i_level;
+            }
+        }
+
+        return std::nullopt;
+    }
+};
+
+}  // namespace mathtools
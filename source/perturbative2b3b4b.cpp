@@ -10,6 +10,7 @@
 #include <torch/script.h>
 
 #include <argparser.hpp>
+#include <common/memory_usage.hpp>
 #include <constants/constants.hpp>
 #include <coordinates/coordinates.hpp>
 #include <environment/environment.hpp>
@@ -30,6 +31,7 @@
 #include <interactions/handlers/full_interaction_handler.hpp>
 #include <interactions/handlers/interaction_handler_concepts.hpp>
 #include <interactions/handlers/nearest_neighbour_interaction_handler.hpp>
+#include <interactions/interaction_counters.hpp>
 #include <mathtools/grid/grid3d.hpp>
 #include <mathtools/histogram/histogram.hpp>
 #include <mathtools/interpolate/trilinear_interp.hpp>
@@ -45,6 +47,7 @@
 #include <rng/prng_state.hpp>
 #include <simulation/box_sides_writer.hpp>
 #include <simulation/continue.hpp>
+#include <simulation/memory_report.hpp>
 #include <simulation/timer.hpp>
 #include <worldline/worldline.hpp>
 #include <worldline/writers/delete_worldlines.hpp>
@@ -191,6 +194,9 @@ auto main(int argc, char** argv) -> int
     auto timer = sim::Timer {};
     auto timer_writer = sim::default_timer_writer(output_dirpath);
 
+    /* count the interactions evaluated in each block */
+    auto interaction_counts_writer = interact::default_interaction_counts_writer(output_dirpath);
+
     auto i_most_recent_saved_worldline = std::optional<std::size_t> {std::nullopt};
 
     const auto write_estimates = [&]() {
@@ -212,6 +218,9 @@ auto main(int argc, char** argv) -> int
 
     const auto write_timer = [&]() {
         timer_writer.write_and_clear();
+        if constexpr (interact::IS_INTERACTION_COUNTING_ENABLED) {
+            interaction_counts_writer.write_and_clear();
+        }
     };
 
     const auto write_histograms = [&]() {
@@ -231,6 +240,31 @@ auto main(int argc, char** argv) -> int
         rng::save_prng_state(prngw.prng(), prng_state_filepath);
     };
 
+    /* report the memory held by the large objects; printed now, and again whenever SIGUSR1 is received */
+    const auto writers_memory_usage = [](const auto&... writers) { return (writers.memory_usage() + ...); };
+
+    // clang-format off
+    const auto print_memory_report = [&]() {
+        auto report = sim::MemoryReport {};
+        report.add("worldlines", worldlines.memory_usage());
+        report.add("pair adjacency matrix", interaction_handler.adjacency_matrix<0>().memory_usage());
+        report.add("triplet adjacency matrix", interaction_handler.adjacency_matrix<1>().memory_usage());
+        report.add("quadruplet adjacency matrix", interaction_handler.adjacency_matrix<2>().memory_usage());
+        report.add("pair potentials", common::memory_usage(pot) + common::memory_usage(interaction_handler.get<0>().point_potential()));
+        report.add("three-body potential", common::memory_usage(interaction_handler.get<1>().point_potential()));
+        report.add("four-body potential", common::memory_usage(interaction_handler.get<2>().point_potential()));
+        report.add("histograms", radial_dist_histo.memory_usage() + centroid_dist_histo.memory_usage());
+        report.add("estimator writer buffers", writers_memory_usage(kinetic_writer, pair_potential_writer, triplet_potential_writer, rms_centroid_writer, abs_centroid_writer));
+        report.add("move writer buffers", writers_memory_usage(com_move_writer, single_bead_move_writer, multi_bead_move_writer, com_step_size_writer, multi_bead_move_info_writer));
+        report.add("timing writer buffers", writers_memory_usage(timer_writer, interaction_counts_writer));
+
+        sim::print_memory_report(std::cout, report, sim::read_resident_set_size());
+    };
+    // clang-format on
+
+    print_memory_report();
+    sim::install_memory_report_signal_handler();
+
     /* perform the simulation loop */
     for (std::size_t i_block {first_block_index}; i_block < last_block_index; ++i_block) {
         timer.start();
@@ -321,6 +355,11 @@ auto main(int argc, char** argv) -> int
         const auto duration = timer.duration_since_last_start();
         timer_writer.accumulate({i_block, duration.seconds, duration.milliseconds, duration.microseconds});
 
+        if constexpr (interact::IS_INTERACTION_COUNTING_ENABLED) {
+            const auto counts = interact::collect_interaction_counts();
+            interaction_counts_writer.accumulate(interact::interaction_counts_block_data(i_block, counts));
+        }
+
         /* write out the batch of estimates and update the histogram files */
         if ((i_block % parser.writer_batch_size) == 0) {
             write_estimates();
@@ -329,6 +368,10 @@ auto main(int argc, char** argv) -> int
             write_timer();
             write_continue_and_prng(i_block);
         }
+
+        if (sim::is_memory_report_requested()) {
+            print_memory_report();
+        }
     }
 
     write_estimates();
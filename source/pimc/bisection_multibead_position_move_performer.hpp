@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <vector>
 
+#include <common/trace_events.hpp>
 #include <coordinates/box_sides.hpp>
 #include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
@@ -78,6 +79,7 @@ public:
         MoveSuccessTracker* move_tracker = nullptr
     )
     {
+        const auto trace = common::trace::TraceScope {"bisection_move"};
         const auto level = choose_bisection_level_(prngw);
         const auto bisection_level_manager = BisectionLevelManager {level, i_timeslice, environment.n_timeslices()};
         const auto original_position_cache = create_original_position_cache(i_timeslice, i_particle, level, worldlines);
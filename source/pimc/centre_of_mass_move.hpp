@@ -6,9 +6,11 @@
 #include <iomanip>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <common/trace_events.hpp>
 #include <coordinates/box_sides.hpp>
 #include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
@@ -60,12 +62,23 @@ public:
         MoveSuccessTracker* move_tracker = nullptr
     ) noexcept
     {
+        const auto trace = common::trace::TraceScope {"centre_of_mass_move"};
         const auto step = generate_step_(prngw);
 
+        using Handler = std::remove_cvref_t<decltype(interact_handler)>;
+        constexpr auto is_batched = interact::BatchedInteractionHandler<Handler, FP, NDIM>;
+
         // calculate energy for the current configuration
+        // - a batched handler subtracts it from the energy of the new configuration, so that the energies
+        //   of all the timeslices before and after the move can be evaluated together
         auto pot_energy_before = FP {};
-        for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
-            pot_energy_before += interact_handler(i_timeslice, i_particle, worldlines);
+        if constexpr (is_batched) {
+            interact_handler.add_worldline_energy(i_particle, worldlines, FP {-1.0});
+        }
+        else {
+            for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
+                pot_energy_before += interact_handler(i_timeslice, i_particle, worldlines);
+            }
         }
 
         // save the current positions, and set the new ones
@@ -79,8 +92,14 @@ public:
 
         // calculate energy for the new configuration
         auto pot_energy_after = FP {};
-        for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
-            pot_energy_after += interact_handler(i_timeslice, i_particle, worldlines);
+        if constexpr (is_batched) {
+            interact_handler.add_worldline_energy(i_particle, worldlines, FP {1.0});
+            pot_energy_after = interact_handler.extract_energy();
+        }
+        else {
+            for (std::size_t i_timeslice {0}; i_timeslice < worldlines.n_timeslices(); ++i_timeslice) {
+                pot_energy_after += interact_handler(i_timeslice, i_particle, worldlines);
+            }
         }
 
         const auto pot_energy_diff = pot_energy_after - pot_energy_before;
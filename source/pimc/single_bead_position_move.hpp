@@ -7,6 +7,7 @@
 #include <utility>
 #include <vector>
 
+#include <common/trace_events.hpp>
 #include <coordinates/box_sides.hpp>
 #include <coordinates/cartesian.hpp>
 #include <coordinates/measure.hpp>
@@ -42,6 +43,7 @@ public:
         MoveSuccessTracker* move_tracker = nullptr
     ) noexcept
     {
+        const auto trace = common::trace::TraceScope {"single_bead_move"};
         const auto proposed_bead_mean = proposed_bead_position_mean_(i_timeslice, i_particle, worldlines);
         const auto step = generate_step_(environment, prngw);
         const auto proposed_bead = proposed_bead_mean + step;
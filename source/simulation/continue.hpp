@@ -1,15 +1,30 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <random>
+#include <span>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <vector>
 
+#include <common/binary_io.hpp>
+#include <common/durable_io.hpp>
 #include <common/io_utils.hpp>
 #include <common/toml_utils.hpp>
+#include <mathtools/histogram/histogram.hpp>
+#include <mathtools/statistics/blocking.hpp>
+#include <pimc/bisection_level_move_info.hpp>
+#include <worldline/worldline.hpp>
+#include <worldline/writers/binary_worldlines.hpp>
 
 #include <../extern/tomlplusplus/toml.hpp>
 
@@ -24,12 +39,49 @@ struct SimulationContinueInfo
     bool is_equilibration_complete;
 };
 
+/*
+    Everything needed to continue a simulation exactly where it stopped: the bead positions, the state of
+    the PRNG, the histograms accumulated so far, the current move step sizes (which may have been
+    adjusted during equilibration), and the running blocking analyses of the estimators.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+struct SimulationCheckpoint
+{
+    SimulationContinueInfo info;
+    worldline::Worldlines<FP, NDIM> worldlines;
+    std::mt19937 prng;
+    std::vector<mathtools::Histogram<FP>> histograms;
+    FP centre_of_mass_step_size;
+    pimc::BisectionLevelMoveInfo<FP> bisection_move_info;
+    std::vector<mathtools::StreamingBlockingAnalysis<FP>> estimator_statistics;
+};
+
 }  // namespace sim
 
 namespace impl_continue_sim
 {
 
 constexpr auto DEFAULT_CONTINUE_FILENAME = std::string_view {"continue.toml"};
+constexpr auto DEFAULT_CHECKPOINT_FILENAME = std::string_view {"checkpoint.bin"};
+
+/*
+    The checkpoint file is made of a header, followed by the payload:
+      - [8 bytes] the magic sequence "PIMCCKPT"
+      - [uint32]  the version of the format
+      - [uint32]  the width of each floating-point value in bytes
+      - [uint64]  the size of the payload in bytes
+      - [uint64]  the FNV-1a checksum of the payload
+
+    The payload holds, in order: the continue info, the move step sizes, the PRNG state (as the text the
+    standard library writes for it), the histograms, the worldlines (as a binary worldline file), and
+    the levels of the blocking analyses of the estimators.
+
+    Version 1 checkpoints, written before the blocking analyses were added, are still read; their
+    blocking analyses start out empty.
+*/
+constexpr auto CHECKPOINT_MAGIC = std::array<char, 8> {'P', 'I', 'M', 'C', 'C', 'K', 'P', 'T'};
+constexpr auto CHECKPOINT_VERSION = std::uint32_t {2};
+constexpr auto OLDEST_READABLE_CHECKPOINT_VERSION = std::uint32_t {1};
 
 constexpr auto continue_file_header_() noexcept -> std::string
 {
@@ -85,19 +137,221 @@ private:
     std::string_view is_equilibration_complete_name_ {"is_equilibration_complete"};
 };
 
+template <std::floating_point FP, std::size_t NDIM>
+void serialize_checkpoint_payload_(std::ostream& stream, const sim::SimulationCheckpoint<FP, NDIM>& checkpoint)
+{
+    using common::io::write_binary;
+
+    const auto& info = checkpoint.info;
+    write_binary(stream, static_cast<std::uint64_t>(info.most_recent_block_index));
+    write_binary(stream, static_cast<std::uint64_t>(info.most_recent_saved_worldline_index));
+    write_binary(stream, static_cast<std::uint8_t>(info.is_at_least_one_worldline_index_saved));
+    write_binary(stream, static_cast<std::uint8_t>(info.is_equilibration_complete));
+
+    write_binary(stream, checkpoint.centre_of_mass_step_size);
+    write_binary(stream, checkpoint.bisection_move_info.upper_level_frac);
+    write_binary(stream, static_cast<std::uint64_t>(checkpoint.bisection_move_info.lower_level));
+
+    auto prng_stream = std::stringstream {};
+    prng_stream << checkpoint.prng;
+    const auto prng_state = prng_stream.str();
+    write_binary(stream, static_cast<std::uint64_t>(prng_state.size()));
+    stream << prng_state;
+
+    write_binary(stream, static_cast<std::uint64_t>(checkpoint.histograms.size()));
+    for (const auto& histogram : checkpoint.histograms) {
+        write_binary(stream, histogram.min());
+        write_binary(stream, histogram.max());
+        write_binary(stream, static_cast<std::uint32_t>(histogram.policy()));
+        write_binary(stream, static_cast<std::uint64_t>(histogram.size()));
+        write_binary(stream, std::span<const std::uint64_t> {histogram.bins()});
+    }
+
+    auto worldline_stream = std::stringstream {};
+    worldline::write_binary_worldlines(worldline_stream, info.most_recent_block_index, checkpoint.worldlines);
+    const auto worldline_bytes = worldline_stream.str();
+    write_binary(stream, static_cast<std::uint64_t>(worldline_bytes.size()));
+    stream << worldline_bytes;
+
+    write_binary(stream, static_cast<std::uint64_t>(checkpoint.estimator_statistics.size()));
+    for (const auto& analysis : checkpoint.estimator_statistics) {
+        write_binary(stream, static_cast<std::uint64_t>(analysis.levels().size()));
+        for (const auto& level : analysis.levels()) {
+            write_binary(stream, static_cast<std::uint64_t>(level.n_values));
+            write_binary(stream, level.mean);
+            write_binary(stream, level.sum_squared_deviations);
+            write_binary(stream, static_cast<std::uint8_t>(level.has_unpaired_value));
+            write_binary(stream, level.unpaired_value);
+        }
+    }
+}
+
+inline auto deserialize_out_of_range_policy_(std::uint32_t value) -> mathtools::OutOfRangePolicy
+{
+    using ORP = mathtools::OutOfRangePolicy;
+
+    if (value != static_cast<std::uint32_t>(ORP::DO_NOTHING) && value != static_cast<std::uint32_t>(ORP::THROW)) {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: unknown out-of-range policy for a histogram in the checkpoint.\n";
+        err_msg << "Found: " << value << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+
+    return static_cast<ORP>(value);
+}
+
+template <std::floating_point FP>
+auto deserialize_blocking_analysis_(common::io::BinaryReader& reader) -> mathtools::StreamingBlockingAnalysis<FP>
+{
+    const auto n_levels = reader.read<std::uint64_t>();
+
+    auto levels = std::vector<mathtools::BlockingLevel<FP>> {};
+    for (std::uint64_t i_level {0}; i_level < n_levels; ++i_level) {
+        auto level = mathtools::BlockingLevel<FP> {};
+        level.n_values = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        level.mean = reader.read<FP>();
+        level.sum_squared_deviations = reader.read<FP>();
+        level.has_unpaired_value = reader.read<std::uint8_t>() != 0;
+        level.unpaired_value = reader.read<FP>();
+        levels.push_back(level);
+    }
+
+    return mathtools::StreamingBlockingAnalysis<FP> {std::move(levels)};
+}
+
+template <std::floating_point FP, std::size_t NDIM>
+auto deserialize_checkpoint_payload_(std::span<const char> payload, std::uint32_t version)
+    -> sim::SimulationCheckpoint<FP, NDIM>
+{
+    auto reader = common::io::BinaryReader {payload};
+
+    auto info = sim::SimulationContinueInfo {};
+    info.most_recent_block_index = static_cast<std::size_t>(reader.read<std::uint64_t>());
+    info.most_recent_saved_worldline_index = static_cast<std::size_t>(reader.read<std::uint64_t>());
+    info.is_at_least_one_worldline_index_saved = reader.read<std::uint8_t>() != 0;
+    info.is_equilibration_complete = reader.read<std::uint8_t>() != 0;
+
+    const auto centre_of_mass_step_size = reader.read<FP>();
+    const auto upper_level_frac = reader.read<FP>();
+    const auto lower_level = static_cast<std::size_t>(reader.read<std::uint64_t>());
+
+    const auto prng_state = reader.read_bytes(reader.read<std::uint64_t>());
+    auto prng_stream = std::stringstream {std::string {prng_state.begin(), prng_state.end()}};
+    auto prng = std::mt19937 {};
+    prng_stream >> prng;
+    if (prng_stream.fail()) {
+        throw std::runtime_error {"ERROR: the PRNG state in the checkpoint could not be read.\n"};
+    }
+
+    const auto n_histograms = reader.read<std::uint64_t>();
+    auto histograms = std::vector<mathtools::Histogram<FP>> {};
+    for (std::uint64_t i_histo {0}; i_histo < n_histograms; ++i_histo) {
+        const auto min = reader.read<FP>();
+        const auto max = reader.read<FP>();
+        const auto policy = deserialize_out_of_range_policy_(reader.read<std::uint32_t>());
+        const auto n_bins = reader.read<std::uint64_t>();
+
+        // checked before the bins are allocated, and so that the size of the bins cannot overflow
+        if (n_bins > reader.n_remaining() / sizeof(std::uint64_t)) {
+            throw std::runtime_error {"ERROR: the checkpoint ends before all the histogram bins were read.\n"};
+        }
+
+        auto bins = std::vector<std::uint64_t>(n_bins);
+        const auto bin_bytes = reader.read_bytes(n_bins * sizeof(std::uint64_t));
+        std::memcpy(bins.data(), bin_bytes.data(), bin_bytes.size());
+
+        histograms.emplace_back(min, max, std::move(bins), policy);
+    }
+
+    const auto worldline_bytes = reader.read_bytes(reader.read<std::uint64_t>());
+    auto worldlines = worldline::read_binary_worldlines<FP, NDIM>(worldline_bytes);
+
+    auto estimator_statistics = std::vector<mathtools::StreamingBlockingAnalysis<FP>> {};
+    if (version >= 2) {
+        const auto n_statistics = reader.read<std::uint64_t>();
+        for (std::uint64_t i_stats {0}; i_stats < n_statistics; ++i_stats) {
+            estimator_statistics.push_back(deserialize_blocking_analysis_<FP>(reader));
+        }
+    }
+
+    return sim::SimulationCheckpoint<FP, NDIM> {
+        info,
+        std::move(worldlines),
+        prng,
+        std::move(histograms),
+        centre_of_mass_step_size,
+        pimc::BisectionLevelMoveInfo<FP> {upper_level_frac, lower_level},
+        std::move(estimator_statistics)
+    };
+}
+
 }  // namespace impl_continue_sim
 
 namespace sim
 {
 
+template <std::floating_point FP, std::size_t NDIM>
+void serialize_checkpoint(std::ostream& stream, const SimulationCheckpoint<FP, NDIM>& checkpoint)
+{
+    using common::io::write_binary;
+
+    auto payload_stream = std::stringstream {};
+    impl_continue_sim::serialize_checkpoint_payload_(payload_stream, checkpoint);
+    const auto payload = payload_stream.str();
+
+    stream.write(impl_continue_sim::CHECKPOINT_MAGIC.data(), impl_continue_sim::CHECKPOINT_MAGIC.size());
+    write_binary(stream, impl_continue_sim::CHECKPOINT_VERSION);
+    write_binary(stream, static_cast<std::uint32_t>(sizeof(FP)));
+    write_binary(stream, static_cast<std::uint64_t>(payload.size()));
+    write_binary(stream, common::io::fnv1a_64(std::span<const char> {payload}));
+    stream << payload;
+}
+
+template <std::floating_point FP, std::size_t NDIM>
+auto deserialize_checkpoint(std::span<const char> bytes) -> SimulationCheckpoint<FP, NDIM>
+{
+    auto reader = common::io::BinaryReader {bytes};
+
+    const auto magic = reader.read_bytes(impl_continue_sim::CHECKPOINT_MAGIC.size());
+    if (!std::equal(magic.begin(), magic.end(), impl_continue_sim::CHECKPOINT_MAGIC.begin())) {
+        throw std::runtime_error {"ERROR: the data does not start with a checkpoint header.\n"};
+    }
+
+    const auto version = reader.read<std::uint32_t>();
+    const auto fp_width = reader.read<std::uint32_t>();
+    const auto is_version_readable = version >= impl_continue_sim::OLDEST_READABLE_CHECKPOINT_VERSION
+                                  && version <= impl_continue_sim::CHECKPOINT_VERSION;
+    if (!is_version_readable || fp_width != sizeof(FP)) {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: the checkpoint cannot be read by this simulation.\n";
+        err_msg << "Supported: version = " << impl_continue_sim::OLDEST_READABLE_CHECKPOINT_VERSION;
+        err_msg << " to " << impl_continue_sim::CHECKPOINT_VERSION;
+        err_msg << ", fp_width = " << sizeof(FP) << '\n';
+        err_msg << "Found: version = " << version << ", fp_width = " << fp_width << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+
+    const auto payload_size = reader.read<std::uint64_t>();
+    const auto checksum = reader.read<std::uint64_t>();
+    const auto payload = reader.read_bytes(payload_size);
+
+    if (common::io::fnv1a_64(payload) != checksum) {
+        throw std::runtime_error {"ERROR: the checksum of the checkpoint does not match its contents.\n"};
+    }
+
+    return impl_continue_sim::deserialize_checkpoint_payload_<FP, NDIM>(payload, version);
+}
+
 class ContinueFileManager
 {
 public:
     ContinueFileManager(
         const std::filesystem::path& continue_dirpath,
-        std::string_view continue_filename = impl_continue_sim::DEFAULT_CONTINUE_FILENAME
+        std::string_view continue_filename = impl_continue_sim::DEFAULT_CONTINUE_FILENAME,
+        std::string_view checkpoint_filename = impl_continue_sim::DEFAULT_CHECKPOINT_FILENAME
     )
         : continue_filepath_ {continue_dirpath / continue_filename}
+        , checkpoint_filepath_ {continue_dirpath / checkpoint_filename}
     {}
 
     auto file_exists() const noexcept -> bool
@@ -105,10 +359,14 @@ public:
         return std::filesystem::exists(continue_filepath_);
     }
 
+    auto checkpoint_exists() const noexcept -> bool
+    {
+        return std::filesystem::exists(checkpoint_filepath_);
+    }
+
     auto is_continued() const noexcept -> bool
     {
-        // for now, the continue file's existence is the only thing that determines if the simulation is being continued
-        return file_exists();
+        return file_exists() || checkpoint_exists();
     }
 
     void deserialize()
@@ -143,8 +401,49 @@ public:
         serialize();
     }
 
+    /*
+        The checkpoint is written to a temporary file and renamed over the previous one, so the checkpoint
+        file always holds a complete checkpoint, even if the simulation is stopped while writing it.
+    */
+    template <std::floating_point FP, std::size_t NDIM>
+    void write_checkpoint(const SimulationCheckpoint<FP, NDIM>& checkpoint)
+    {
+        auto out_stream = std::stringstream {};
+        serialize_checkpoint(out_stream, checkpoint);
+        common::io::replace_durably(checkpoint_filepath_, out_stream.str());
+
+        set_info(checkpoint.info);
+    }
+
+    template <std::floating_point FP, std::size_t NDIM>
+    auto read_checkpoint() -> SimulationCheckpoint<FP, NDIM>
+    {
+        auto in_stream = std::ifstream {checkpoint_filepath_, std::ios::binary};
+        if (!in_stream.is_open()) {
+            auto err_msg = std::stringstream {};
+            err_msg << "Failed to open the checkpoint file: " << checkpoint_filepath_.string() << '\n';
+            throw std::ios_base::failure {err_msg.str()};
+        }
+
+        // the entire checkpoint is read at once, and then parsed from memory
+        auto contents = std::string {};
+        contents.resize(static_cast<std::size_t>(std::filesystem::file_size(checkpoint_filepath_)));
+        in_stream.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+        auto checkpoint = deserialize_checkpoint<FP, NDIM>(std::span<const char> {contents});
+        set_info(checkpoint.info);
+
+        return checkpoint;
+    }
+
+    auto checkpoint_filepath() const -> const std::filesystem::path&
+    {
+        return checkpoint_filepath_;
+    }
+
 private:
     std::filesystem::path continue_filepath_;
+    std::filesystem::path checkpoint_filepath_;
     impl_continue_sim::ContinueFileManagerImpl_ impl_;
     sim::SimulationContinueInfo info_;
 };
@@ -0,0 +1,418 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <common/buffered_writers/buffered_writer.hpp>
+
+/*
+    Hardware performance counters (cycles, instructions, cache and branch misses) for the phases of each
+    block, read through the Linux `perf_event_open()` interface.
+
+    The counters are opened as a single group, so that they are all scheduled onto the hardware together
+    and the ratios between them stay meaningful even when the kernel multiplexes them. Only the calling
+    thread is counted; work done by the estimator thread pool doesn't appear in the counts.
+
+    The counters are often unavailable (on other operating systems, in containers, or when the kernel's
+    `perf_event_paranoid` setting forbids them); an event that cannot be opened is left out, and a metric
+    that depends on a missing event is written as NaN. If not even the cycle counter can be opened, the
+    whole group is unavailable and nothing is counted.
+*/
+
+namespace sim
+{
+
+enum class HardwareEvent : std::size_t
+{
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_READ_ACCESSES,
+    L1D_READ_MISSES,
+    LLC_REFERENCES,
+    LLC_MISSES,
+    BRANCH_INSTRUCTIONS,
+    BRANCH_MISSES
+};
+
+constexpr inline auto N_HARDWARE_EVENTS = std::size_t {8};
+
+using HardwareCounts = std::array<std::optional<std::uint64_t>, N_HARDWARE_EVENTS>;
+
+// the phases are coarser than those of the `PhaseTimer`, since each scope costs a system call or two
+enum class HardwareCounterPhase : std::size_t
+{
+    MOVES,
+    ESTIMATORS,
+    INPUT_OUTPUT
+};
+
+constexpr inline auto N_HARDWARE_COUNTER_PHASES = std::size_t {3};
+
+constexpr inline auto HARDWARE_COUNTER_PHASE_NAMES = std::array<std::string_view, N_HARDWARE_COUNTER_PHASES> {
+    "moves",
+    "estimators",
+    "input_output"
+};
+
+// the metrics derived from the counts, written for each phase
+constexpr inline auto N_HARDWARE_METRICS = std::size_t {4};
+
+constexpr inline auto HARDWARE_METRIC_NAMES = std::array<std::string_view, N_HARDWARE_METRICS> {
+    "instructions_per_cycle",
+    "l1d_read_miss_rate",
+    "llc_miss_rate",
+    "branch_miss_rate"
+};
+
+}  // namespace sim
+
+namespace impl_hardware_counters_sim
+{
+
+constexpr inline auto DEFAULT_HARDWARE_COUNTERS_FILENAME = std::string_view {"hardware_counters.dat"};
+
+#if defined(__linux__)
+
+inline auto cache_event_config(std::uint64_t cache, std::uint64_t operation, std::uint64_t result) -> std::uint64_t
+{
+    return cache | (operation << 8) | (result << 16);
+}
+
+// the `perf_event_attr` type and config for each `HardwareEvent`, in the same order
+inline auto hardware_event_type_and_config(sim::HardwareEvent event) -> std::pair<std::uint32_t, std::uint64_t>
+{
+    using HE = sim::HardwareEvent;
+
+    const auto l1d_read = [](std::uint64_t result) {
+        return cache_event_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, result);
+    };
+
+    switch (event) {
+        case HE::CYCLES :
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+        case HE::INSTRUCTIONS :
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+        case HE::L1D_READ_ACCESSES :
+            return {PERF_TYPE_HW_CACHE, l1d_read(PERF_COUNT_HW_CACHE_RESULT_ACCESS)};
+        case HE::L1D_READ_MISSES :
+            return {PERF_TYPE_HW_CACHE, l1d_read(PERF_COUNT_HW_CACHE_RESULT_MISS)};
+        case HE::LLC_REFERENCES :
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES};
+        case HE::LLC_MISSES :
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+        case HE::BRANCH_INSTRUCTIONS :
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS};
+        case HE::BRANCH_MISSES :
+            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+    }
+
+    return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+}
+
+// returns -1 if the event cannot be opened
+inline auto open_hardware_event(sim::HardwareEvent event, int group_fd) noexcept -> int
+{
+    const auto [type, config] = hardware_event_type_and_config(event);
+    const auto is_leader = group_fd == -1;
+
+    auto attr = perf_event_attr {};
+    attr.size = sizeof(perf_event_attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = is_leader ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    // count the calling thread, on whichever CPU it runs
+    const auto fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+
+    return static_cast<int>(fd);
+}
+
+#endif
+
+template <std::size_t Index>
+using MetricColumn = double;
+
+template <std::size_t... Indices>
+auto hardware_counters_writer_type(std::index_sequence<Indices...>)
+    -> common::writers::BlockValueWriter<MetricColumn<Indices>...>;
+
+inline auto hardware_counters_file_header() -> std::string
+{
+    auto message = std::stringstream {};
+
+    message << "# this file contains hardware performance counter metrics for each phase of each block\n";
+    message << "# the first column is the number label for the block\n";
+    message << "# each phase has the following columns, in order:\n";
+    for (const auto name : sim::HARDWARE_METRIC_NAMES) {
+        message << "#   " << name << '\n';
+    }
+    message << "# and the phases are, in order:\n";
+    for (const auto name : sim::HARDWARE_COUNTER_PHASE_NAMES) {
+        message << "#   " << name << '\n';
+    }
+    message << "# a metric is 'nan' if the counters it needs are unavailable, or if nothing was counted\n";
+
+    return message.str();
+}
+
+}  // namespace impl_hardware_counters_sim
+
+namespace sim
+{
+
+using HardwareCountersWriter = decltype(impl_hardware_counters_sim::hardware_counters_writer_type(
+    std::make_index_sequence<N_HARDWARE_METRICS * N_HARDWARE_COUNTER_PHASES> {}
+));
+
+/*
+    The group of counters, opened and started on construction unless `is_requested` is false; the counters
+    run continuously, and the counts for a stretch of code are found from the difference of two calls to
+    `read()`.
+*/
+class HardwareCounterGroup
+{
+public:
+    explicit HardwareCounterGroup(bool is_requested = true)
+    {
+        fds_.fill(-1);
+        if (is_requested) {
+            open_();
+        }
+    }
+
+    HardwareCounterGroup(const HardwareCounterGroup&) = delete;
+    auto operator=(const HardwareCounterGroup&) -> HardwareCounterGroup& = delete;
+
+    ~HardwareCounterGroup()
+    {
+        close_();
+    }
+
+    auto is_available() const noexcept -> bool
+    {
+        return leader_fd_() != -1;
+    }
+
+    auto is_event_available(HardwareEvent event) const noexcept -> bool
+    {
+        return fds_[static_cast<std::size_t>(event)] != -1;
+    }
+
+    auto read() const noexcept -> HardwareCounts
+    {
+        auto counts = HardwareCounts {};
+
+#if defined(__linux__)
+        if (!is_available()) {
+            return counts;
+        }
+
+        // the layout for `PERF_FORMAT_GROUP`: the number of events, then the value of each event
+        auto buffer = std::array<std::uint64_t, 1 + N_HARDWARE_EVENTS> {};
+        const auto n_bytes = ::read(leader_fd_(), buffer.data(), sizeof(buffer));
+        if (n_bytes < static_cast<long>(sizeof(std::uint64_t))) {
+            return counts;
+        }
+
+        // the values come in the order that the events were added to the group
+        auto i_value = std::size_t {1};
+        for (std::size_t i_event {0}; i_event < N_HARDWARE_EVENTS; ++i_event) {
+            if (fds_[i_event] != -1 && i_value <= buffer[0]) {
+                counts[i_event] = buffer[i_value];
+                ++i_value;
+            }
+        }
+#endif
+
+        return counts;
+    }
+
+private:
+    std::array<int, N_HARDWARE_EVENTS> fds_ {};
+
+    auto leader_fd_() const noexcept -> int
+    {
+        return fds_[static_cast<std::size_t>(HardwareEvent::CYCLES)];
+    }
+
+    void open_() noexcept
+    {
+#if defined(__linux__)
+        namespace impl = impl_hardware_counters_sim;
+
+        const auto leader_fd = impl::open_hardware_event(HardwareEvent::CYCLES, -1);
+        if (leader_fd == -1) {
+            return;
+        }
+        fds_[static_cast<std::size_t>(HardwareEvent::CYCLES)] = leader_fd;
+
+        for (std::size_t i_event {1}; i_event < N_HARDWARE_EVENTS; ++i_event) {
+            fds_[i_event] = impl::open_hardware_event(static_cast<HardwareEvent>(i_event), leader_fd);
+        }
+
+        ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void close_() noexcept
+    {
+#if defined(__linux__)
+        for (auto& fd : fds_) {
+            if (fd != -1) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+#endif
+    }
+};
+
+class HardwareCounterPhases;
+
+/*
+    Adds the counts between its construction and destruction to one phase of a `HardwareCounterPhases`.
+*/
+class ScopedHardwareCounters
+{
+public:
+    ScopedHardwareCounters(HardwareCounterPhases& phases, HardwareCounterPhase phase);
+
+    ScopedHardwareCounters(const ScopedHardwareCounters&) = delete;
+    auto operator=(const ScopedHardwareCounters&) -> ScopedHardwareCounters& = delete;
+
+    ~ScopedHardwareCounters();
+
+private:
+    HardwareCounterPhases& phases_;
+    HardwareCounterPhase phase_;
+    HardwareCounts start_counts_;
+};
+
+/*
+    Accumulates the counts for each phase over one block; `reset()` is called once the metrics for the
+    block have been recorded.
+*/
+class HardwareCounterPhases
+{
+public:
+    explicit HardwareCounterPhases(bool is_requested = true)
+        : group_ {is_requested}
+    {}
+
+    auto is_available() const noexcept -> bool
+    {
+        return group_.is_available();
+    }
+
+    auto scope(HardwareCounterPhase phase) -> ScopedHardwareCounters
+    {
+        return ScopedHardwareCounters {*this, phase};
+    }
+
+    auto read() const noexcept -> HardwareCounts
+    {
+        return group_.read();
+    }
+
+    void add(HardwareCounterPhase phase, const HardwareCounts& start, const HardwareCounts& end) noexcept
+    {
+        auto& totals = totals_[static_cast<std::size_t>(phase)];
+        for (std::size_t i_event {0}; i_event < N_HARDWARE_EVENTS; ++i_event) {
+            if (start[i_event] && end[i_event]) {
+                totals[i_event] = totals[i_event].value_or(0) + (*end[i_event] - *start[i_event]);
+            }
+        }
+    }
+
+    auto totals(HardwareCounterPhase phase) const noexcept -> const HardwareCounts&
+    {
+        return totals_[static_cast<std::size_t>(phase)];
+    }
+
+    void reset() noexcept
+    {
+        totals_.fill(HardwareCounts {});
+    }
+
+    auto block_data(std::size_t i_block) const -> HardwareCountersWriter::Data
+    {
+        auto metrics = std::array<double, N_HARDWARE_METRICS * N_HARDWARE_COUNTER_PHASES> {};
+        for (std::size_t i_phase {0}; i_phase < N_HARDWARE_COUNTER_PHASES; ++i_phase) {
+            const auto phase_metrics = derived_metrics(totals_[i_phase]);
+            for (std::size_t i_metric {0}; i_metric < N_HARDWARE_METRICS; ++i_metric) {
+                metrics[i_phase * N_HARDWARE_METRICS + i_metric] = phase_metrics[i_metric];
+            }
+        }
+
+        const auto metrics_tuple = std::apply([](auto... metric) { return std::tuple {metric...}; }, metrics);
+        return std::tuple_cat(std::tuple {i_block}, metrics_tuple);
+    }
+
+    // the metrics in the order of `HARDWARE_METRIC_NAMES`
+    static auto derived_metrics(const HardwareCounts& counts) noexcept -> std::array<double, N_HARDWARE_METRICS>
+    {
+        using HE = HardwareEvent;
+
+        const auto ratio = [&](HE numerator, HE denominator) {
+            const auto& num = counts[static_cast<std::size_t>(numerator)];
+            const auto& den = counts[static_cast<std::size_t>(denominator)];
+            if (!num || !den || *den == 0) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+
+            return static_cast<double>(*num) / static_cast<double>(*den);
+        };
+
+        return {
+            ratio(HE::INSTRUCTIONS, HE::CYCLES),
+            ratio(HE::L1D_READ_MISSES, HE::L1D_READ_ACCESSES),
+            ratio(HE::LLC_MISSES, HE::LLC_REFERENCES),
+            ratio(HE::BRANCH_MISSES, HE::BRANCH_INSTRUCTIONS)
+        };
+    }
+
+private:
+    HardwareCounterGroup group_ {};
+    std::array<HardwareCounts, N_HARDWARE_COUNTER_PHASES> totals_ {};
+};
+
+inline ScopedHardwareCounters::ScopedHardwareCounters(HardwareCounterPhases& phases, HardwareCounterPhase phase)
+    : phases_ {phases}
+    , phase_ {phase}
+    , start_counts_ {phases.read()}
+{}
+
+inline ScopedHardwareCounters::~ScopedHardwareCounters()
+{
+    phases_.add(phase_, start_counts_, phases_.read());
+}
+
+inline auto default_hardware_counters_writer(const std::filesystem::path& output_dirpath) -> HardwareCountersWriter
+{
+    const auto filepath = output_dirpath / impl_hardware_counters_sim::DEFAULT_HARDWARE_COUNTERS_FILENAME;
+    const auto header = impl_hardware_counters_sim::hardware_counters_file_header();
+
+    return HardwareCountersWriter {filepath, header};
+}
+
+}  // namespace sim
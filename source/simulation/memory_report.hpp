@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <ios>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <common/memory_usage.hpp>
+
+/*
+    A report of the memory held by the large objects of a simulation (the worldlines, the adjacency
+    matrices, the potential tables, the histograms, the writer buffers, ...), alongside the resident set
+    size of the process, so that the number of simulations that fit on a node can be worked out before
+    they are submitted.
+
+    The accounted bytes cover only the buffers the objects hold directly; the difference between their
+    total and the resident set size is the memory used by everything else (the code, the stacks of the
+    threads, the allocator, the torch runtime, ...).
+
+    A running simulation prints the report again when it receives `SIGUSR1`.
+*/
+
+namespace sim
+{
+
+struct MemoryReportEntry
+{
+    std::string name;
+    common::MemoryUsage usage;
+};
+
+// the sizes reported by the kernel, in bytes; a field missing from the status file is left empty
+struct ResidentSetSize
+{
+    std::optional<std::size_t> current_bytes {std::nullopt};
+    std::optional<std::size_t> peak_bytes {std::nullopt};
+};
+
+class MemoryReport
+{
+public:
+    void add(std::string name, const common::MemoryUsage& usage)
+    {
+        entries_.push_back({std::move(name), usage});
+    }
+
+    auto entries() const noexcept -> const std::vector<MemoryReportEntry>&
+    {
+        return entries_;
+    }
+
+    auto total() const noexcept -> common::MemoryUsage
+    {
+        auto total_usage = common::MemoryUsage {};
+        for (const auto& entry : entries_) {
+            total_usage += entry.usage;
+        }
+
+        return total_usage;
+    }
+
+private:
+    std::vector<MemoryReportEntry> entries_ {};
+};
+
+}  // namespace sim
+
+namespace impl_memory_report_sim
+{
+
+constexpr inline auto DEFAULT_PROC_STATUS_FILEPATH = std::string_view {"/proc/self/status"};
+constexpr inline auto NAME_COLUMN_WIDTH = int {32};
+constexpr inline auto BYTES_COLUMN_WIDTH = int {14};
+
+/*
+    The flag is set from inside a signal handler, so it must be initialized before the program starts (rather
+    than on first use, like a function-local static), and must be a lock-free atomic.
+*/
+inline constinit auto g_is_memory_report_requested = std::atomic<bool> {false};
+
+inline void request_memory_report(int /* signal */)
+{
+    g_is_memory_report_requested.store(true, std::memory_order_relaxed);
+}
+
+// the status file gives the sizes in kibibytes, in lines like "VmRSS:     123456 kB"
+inline auto parse_status_kibibytes(const std::string& line) -> std::optional<std::size_t>
+{
+    auto line_stream = std::istringstream {line};
+    auto field = std::string {};
+    auto kibibytes = std::size_t {};
+    auto unit = std::string {};
+
+    if (!(line_stream >> field >> kibibytes >> unit) || unit != "kB") {
+        return std::nullopt;
+    }
+
+    return kibibytes * 1024;
+}
+
+inline auto format_mebibytes(std::size_t n_bytes) -> std::string
+{
+    constexpr auto bytes_per_mebibyte = double {1024.0 * 1024.0};
+
+    auto formatted = std::stringstream {};
+    formatted << std::fixed << std::setprecision(3) << static_cast<double>(n_bytes) / bytes_per_mebibyte << " MiB";
+
+    return formatted.str();
+}
+
+inline void print_row(std::ostream& out_stream, std::string_view name, const common::MemoryUsage& usage)
+{
+    out_stream << "  " << std::left << std::setw(NAME_COLUMN_WIDTH) << name << std::right;
+    out_stream << std::setw(BYTES_COLUMN_WIDTH) << format_mebibytes(usage.owned_bytes);
+    if (usage.shared_bytes != 0) {
+        out_stream << "  (+ " << format_mebibytes(usage.shared_bytes) << " shared)";
+    }
+    out_stream << '\n';
+}
+
+}  // namespace impl_memory_report_sim
+
+namespace sim
+{
+
+inline auto read_resident_set_size(std::istream& status_stream) -> ResidentSetSize
+{
+    auto rss = ResidentSetSize {};
+
+    auto line = std::string {};
+    while (std::getline(status_stream, line)) {
+        if (line.starts_with("VmRSS:")) {
+            rss.current_bytes = impl_memory_report_sim::parse_status_kibibytes(line);
+        }
+        else if (line.starts_with("VmHWM:")) {
+            rss.peak_bytes = impl_memory_report_sim::parse_status_kibibytes(line);
+        }
+    }
+
+    return rss;
+}
+
+// on systems without a `/proc` filesystem, both sizes are left empty
+inline auto read_resident_set_size(
+    const std::filesystem::path& status_filepath = impl_memory_report_sim::DEFAULT_PROC_STATUS_FILEPATH
+) -> ResidentSetSize
+{
+    auto status_stream = std::ifstream {status_filepath};
+    if (!status_stream.is_open()) {
+        return ResidentSetSize {};
+    }
+
+    return read_resident_set_size(status_stream);
+}
+
+inline void print_memory_report(std::ostream& out_stream, const MemoryReport& report, const ResidentSetSize& rss)
+{
+    out_stream << "Memory footprint:\n";
+    for (const auto& entry : report.entries()) {
+        impl_memory_report_sim::print_row(out_stream, entry.name, entry.usage);
+    }
+    impl_memory_report_sim::print_row(out_stream, "total accounted", report.total());
+
+    const auto print_rss = [&](std::string_view name, const std::optional<std::size_t>& n_bytes) {
+        out_stream << "  " << std::left << std::setw(impl_memory_report_sim::NAME_COLUMN_WIDTH) << name << std::right;
+        out_stream << std::setw(impl_memory_report_sim::BYTES_COLUMN_WIDTH);
+        if (n_bytes) {
+            out_stream << impl_memory_report_sim::format_mebibytes(n_bytes.value()) << '\n';
+        }
+        else {
+            out_stream << "unavailable" << '\n';
+        }
+    };
+
+    print_rss("resident set size", rss.current_bytes);
+    print_rss("peak resident set size", rss.peak_bytes);
+}
+
+/*
+    After this is called, sending `SIGUSR1` to the process makes the next call to
+    `is_memory_report_requested()` return true; the handler does nothing else, so the report is printed
+    wherever the simulation next checks for the request.
+*/
+inline void install_memory_report_signal_handler()
+{
+    static_assert(std::atomic<bool>::is_always_lock_free);
+    std::signal(SIGUSR1, impl_memory_report_sim::request_memory_report);
+}
+
+// returns true at most once per signal received
+inline auto is_memory_report_requested() noexcept -> bool
+{
+    return impl_memory_report_sim::g_is_memory_report_requested.exchange(false, std::memory_order_relaxed);
+}
+
+}  // namespace sim
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <common/buffered_writers/buffered_writer.hpp>
+
+/*
+    The phase timer splits the time spent on each block between the phases of the simulation loop (the
+    three kinds of moves, the estimators, the worldline saves, and so on).
+
+    Without `PIMC_SIM_PHASE_TIMING`, only the calls to the clock are compiled away; `PhaseTimer<false>`
+    still holds its per-phase arrays, and `ScopedPhaseTimer<false>` its timer, phase and start time.
+*/
+
+namespace sim
+{
+
+#if defined(PIMC_SIM_PHASE_TIMING)
+constexpr inline auto IS_PHASE_TIMING_ENABLED = bool {true};
+#else
+constexpr inline auto IS_PHASE_TIMING_ENABLED = bool {false};
+#endif
+
+enum class SimulationPhase : std::size_t
+{
+    CENTRE_OF_MASS_MOVES,
+    SINGLE_BEAD_MOVES,
+    BISECTION_MOVES,
+    ESTIMATORS,
+    RADIAL_DISTRIBUTION_FUNCTIONS,
+    WORLDLINE_SAVES,
+    WRITER_FLUSHES
+};
+
+constexpr inline auto N_SIMULATION_PHASES = std::size_t {7};
+
+// the names of the phases, in the order of the `SimulationPhase` enum
+constexpr inline auto SIMULATION_PHASE_NAMES = std::array<std::string_view, N_SIMULATION_PHASES> {
+    "centre_of_mass_moves",
+    "single_bead_moves",
+    "bisection_moves",
+    "estimators",
+    "radial_distribution_functions",
+    "worldline_saves",
+    "writer_flushes"
+};
+
+}  // namespace sim
+
+namespace impl_phase_timer_sim
+{
+
+constexpr inline auto DEFAULT_TIMING_BREAKDOWN_FILENAME = std::string_view {"timing_breakdown.dat"};
+
+// each phase gets two columns: the total time in seconds, and the number of times the phase was entered
+template <std::size_t... Indices>
+auto phase_timing_writer_type(std::index_sequence<Indices...>)
+    -> common::writers::BlockValueWriter<std::conditional_t<Indices % 2 == 0, double, std::size_t>...>;
+
+inline auto timing_breakdown_file_header() -> std::string
+{
+    auto message = std::stringstream {};
+
+    message << "# this file contains information about how the time spent on each block is split between phases\n";
+    message << "# the first column is the number label for the block\n";
+    message << "# each phase has two columns: the total time spent on it in seconds, and the number of calls\n";
+    message << "# the phases are, in order:\n";
+    for (const auto name : sim::SIMULATION_PHASE_NAMES) {
+        message << "#   " << name << '\n';
+    }
+
+    return message.str();
+}
+
+}  // namespace impl_phase_timer_sim
+
+namespace sim
+{
+
+using PhaseTimingWriter = decltype(impl_phase_timer_sim::phase_timing_writer_type(
+    std::make_index_sequence<2 * N_SIMULATION_PHASES> {}
+));
+
+template <bool IsEnabled>
+class PhaseTimer;
+
+/*
+    Adds the time between its construction and destruction to one phase of a `PhaseTimer`.
+*/
+template <bool IsEnabled>
+class ScopedPhaseTimer
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    ScopedPhaseTimer(PhaseTimer<IsEnabled>& timer, SimulationPhase phase)
+        : timer_ {timer}
+        , phase_ {phase}
+    {
+        if constexpr (IsEnabled) {
+            start_time_point_ = clock::now();
+        }
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    auto operator=(const ScopedPhaseTimer&) -> ScopedPhaseTimer& = delete;
+
+    ~ScopedPhaseTimer()
+    {
+        if constexpr (IsEnabled) {
+            timer_.add(phase_, clock::now() - start_time_point_);
+        }
+    }
+
+private:
+    PhaseTimer<IsEnabled>& timer_;
+    SimulationPhase phase_;
+    clock::time_point start_time_point_ {};
+};
+
+/*
+    Accumulates the total time and the number of calls for each phase, over one block; `reset()` is called
+    once the totals for the block have been recorded.
+*/
+template <bool IsEnabled>
+class PhaseTimer
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    auto scope(SimulationPhase phase) -> ScopedPhaseTimer<IsEnabled>
+    {
+        return ScopedPhaseTimer<IsEnabled> {*this, phase};
+    }
+
+    void add(SimulationPhase phase, clock::duration duration) noexcept
+    {
+        if constexpr (IsEnabled) {
+            const auto index = static_cast<std::size_t>(phase);
+            durations_[index] += duration;
+            n_calls_[index] += 1;
+        }
+    }
+
+    auto seconds(SimulationPhase phase) const noexcept -> double
+    {
+        const auto index = static_cast<std::size_t>(phase);
+        return std::chrono::duration<double> {durations_[index]}.count();
+    }
+
+    auto n_calls(SimulationPhase phase) const noexcept -> std::size_t
+    {
+        return n_calls_[static_cast<std::size_t>(phase)];
+    }
+
+    void reset() noexcept
+    {
+        durations_.fill(clock::duration::zero());
+        n_calls_.fill(0);
+    }
+
+    auto block_data(std::size_t i_block) const -> PhaseTimingWriter::Data
+    {
+        return block_data_(i_block, std::make_index_sequence<N_SIMULATION_PHASES> {});
+    }
+
+private:
+    std::array<clock::duration, N_SIMULATION_PHASES> durations_ {};
+    std::array<std::size_t, N_SIMULATION_PHASES> n_calls_ {};
+
+    template <std::size_t... Indices>
+    auto block_data_(std::size_t i_block, std::index_sequence<Indices...>) const -> PhaseTimingWriter::Data
+    {
+        return std::tuple_cat(
+            std::tuple {i_block},
+            std::tuple {seconds(static_cast<SimulationPhase>(Indices)), n_calls_[Indices]}...
+        );
+    }
+};
+
+using DefaultPhaseTimer = PhaseTimer<IS_PHASE_TIMING_ENABLED>;
+
+inline auto default_timing_breakdown_writer(const std::filesystem::path& output_dirpath) -> PhaseTimingWriter
+{
+    const auto filepath = output_dirpath / impl_phase_timer_sim::DEFAULT_TIMING_BREAKDOWN_FILENAME;
+    const auto header = impl_phase_timer_sim::timing_breakdown_file_header();
+
+    return PhaseTimingWriter {filepath, header};
+}
+
+}  // namespace sim
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+
+#include <mathtools/statistics/blocking.hpp>
+
+/*
+    The conditions under which a simulation stops before reaching its last block: the estimators being
+    precise enough, or the time allowed for the run being about to run out. Both are checked between
+    blocks, so that the run always ends on a complete, checkpointed block.
+*/
+
+namespace sim
+{
+
+// enough values for the blocking analysis to have five levels it can trust
+constexpr inline auto MINIMUM_N_SAMPLES_FOR_ERROR_TARGET = std::size_t {mathtools::MINIMUM_BLOCKING_LEVEL_SIZE << 4};
+
+// the standard error relative to the size of the mean; NaN until the analysis can estimate an error
+template <std::floating_point FP>
+auto relative_error(const mathtools::BlockingEstimate<FP>& estimate) -> FP
+{
+    return estimate.standard_error / std::abs(estimate.mean);
+}
+
+/*
+    An error from a blocking analysis that hasn't found a plateau yet may be an underestimate, so a target
+    is only met once the analysis has converged. Stopping a run early on an error that is too small cannot
+    be undone, so a target is also never met before the analysis has `MINIMUM_N_SAMPLES_FOR_ERROR_TARGET`
+    values, whatever the analysis says.
+*/
+template <std::floating_point FP>
+auto is_relative_error_target_met(const mathtools::BlockingEstimate<FP>& estimate, FP target_relative_error)
+    -> bool
+{
+    if (!estimate.is_converged || estimate.n_samples < MINIMUM_N_SAMPLES_FOR_ERROR_TARGET) {
+        return false;
+    }
+
+    return relative_error(estimate) <= target_relative_error;
+}
+
+/*
+    Keeps track of how long the blocks take, to decide whether there is time left for another one. The
+    next block is assumed to take as long as the longest block so far, so that a block which also writes
+    out files or saves the worldlines doesn't push the run past its budget.
+
+    Without a budget, the time never runs out.
+*/
+class WallClockBudget
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit WallClockBudget(std::optional<double> budget_seconds, clock::time_point start = clock::now())
+        : budget_seconds_ {budget_seconds}
+        , start_ {start}
+        , block_start_ {start}
+    {}
+
+    void start_block(clock::time_point now = clock::now()) noexcept
+    {
+        block_start_ = now;
+    }
+
+    void end_block(clock::time_point now = clock::now()) noexcept
+    {
+        longest_block_ = std::max(longest_block_, now - block_start_);
+    }
+
+    auto is_nearly_exhausted(clock::time_point now = clock::now()) const noexcept -> bool
+    {
+        if (!budget_seconds_) {
+            return false;
+        }
+
+        const auto projected_end = std::chrono::duration<double> {(now - start_) + longest_block_};
+        return projected_end.count() > budget_seconds_.value();
+    }
+
+    auto budget_seconds() const noexcept -> std::optional<double>
+    {
+        return budget_seconds_;
+    }
+
+private:
+    std::optional<double> budget_seconds_;
+    clock::time_point start_;
+    clock::time_point block_start_;
+    clock::duration longest_block_ {clock::duration::zero()};
+};
+
+}  // namespace sim
@@ -5,6 +5,7 @@
 #include <span>
 #include <vector>
 
+#include <common/memory_usage.hpp>
 #include <coordinates/coordinates.hpp>
 #include <mathtools/grid/grid2d.hpp>
 #include <mathtools/grid/grid_iterator.hpp>
@@ -75,6 +76,11 @@ public:
         return coordinates_.iterator_along_col(i_worldline);
     }
 
+    constexpr auto memory_usage() const noexcept -> common::MemoryUsage
+    {
+        return coordinates_.memory_usage();
+    }
+
 private:
     mathtools::Grid2D<Point> coordinates_ {};
 };
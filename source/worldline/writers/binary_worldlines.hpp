@@ -0,0 +1,419 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <common/binary_io.hpp>
+#include <common/mapped_file.hpp>
+#include <coordinates/cartesian.hpp>
+#include <worldline/worldline.hpp>
+#include <worldline/writers/worldline_codec.hpp>
+
+/*
+    The binary worldline format stores a fixed-size header, followed by the raw bead coordinates.
+
+    The header is made of the following fields, in order, all stored in little-endian byte order:
+      - [8 bytes] the magic sequence "PIMCWLDB", which marks the file as a binary worldline file
+      - [uint32]  the version of the format
+      - [uint32]  NDIM: the number of dimensions the simulation was performed in
+      - [uint32]  the width of each floating-point coordinate in bytes (4 or 8)
+      - [uint32]  the codec used to store the coordinates (see `WorldlineCodec`)
+      - [uint64]  the block index of the simulation this snapshot is taken at
+      - [uint64]  n_particles: total number of particles
+      - [uint64]  n_timeslices: total number of timeslices
+
+    The coordinates are laid out in the same order as in memory: all the beads of the 0th timeslice, then
+    all the beads of the 1st timeslice, and so on, with the `NDIM` coordinates of each bead next to each other.
+    With the RAW codec they are stored as they are; with the DELTA_BITPACK codec they are compressed losslessly
+    (see `worldline_codec.hpp`), in the same order.
+
+    The header is 48 bytes long, so the raw coordinates of a memory-mapped file are suitably aligned to be
+    used in place.
+*/
+
+static_assert(std::endian::native == std::endian::little, "The binary worldline format assumes a little-endian host.");
+
+namespace impl_worldline
+{
+
+constexpr auto BINARY_WORLDLINE_MAGIC = std::array<char, 8> {'P', 'I', 'M', 'C', 'W', 'L', 'D', 'B'};
+constexpr auto BINARY_WORLDLINE_VERSION = std::uint32_t {1};
+constexpr auto BINARY_WORLDLINE_HEADER_SIZE = std::size_t {48};
+
+// the product of the factors, or nothing if it does not fit in 64 bits
+inline auto checked_product_(std::initializer_list<std::uint64_t> factors) noexcept -> std::optional<std::uint64_t>
+{
+    auto product = std::uint64_t {1};
+    for (const auto factor : factors) {
+        if (factor != 0 && product > std::numeric_limits<std::uint64_t>::max() / factor) {
+            return std::nullopt;
+        }
+        product *= factor;
+    }
+
+    return product;
+}
+
+inline auto is_binary_worldline_magic_(std::span<const char> bytes) -> bool
+{
+    return bytes.size() >= BINARY_WORLDLINE_MAGIC.size()
+        && std::equal(BINARY_WORLDLINE_MAGIC.begin(), BINARY_WORLDLINE_MAGIC.end(), bytes.begin());
+}
+
+template <std::floating_point FPFile, std::floating_point FP, std::size_t NDIM>
+void store_timeslice_values_(
+    std::span<const FPFile> values,
+    worldline::Worldlines<FP, NDIM>& worldlines,
+    std::size_t i_tslice
+)
+{
+    auto timeslice = worldlines.timeslice(i_tslice);
+    for (std::size_t i_part {0}; i_part < timeslice.size(); ++i_part) {
+        auto coordinates = std::array<FP, NDIM> {};
+        for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+            coordinates[i_dim] = static_cast<FP>(values[i_part * NDIM + i_dim]);
+        }
+
+        timeslice[i_part] = coord::Cartesian<FP, NDIM> {coordinates};
+    }
+}
+
+template <std::floating_point FP, std::size_t NDIM>
+void load_timeslice_values_(
+    const worldline::Worldlines<FP, NDIM>& worldlines,
+    std::size_t i_tslice,
+    std::vector<FP>& values
+)
+{
+    const auto timeslice = worldlines.timeslice(i_tslice);
+    for (std::size_t i_part {0}; i_part < timeslice.size(); ++i_part) {
+        for (std::size_t i_dim {0}; i_dim < NDIM; ++i_dim) {
+            values[i_part * NDIM + i_dim] = timeslice[i_part][i_dim];
+        }
+    }
+}
+
+template <std::floating_point FPFile, std::floating_point FP, std::size_t NDIM>
+void copy_raw_coordinates_(std::span<const char> bytes, worldline::Worldlines<FP, NDIM>& worldlines)
+{
+    const auto n_values_per_timeslice = worldlines.n_worldlines() * NDIM;
+    const auto n_bytes_per_timeslice = n_values_per_timeslice * sizeof(FPFile);
+
+    if (bytes.size() < worldlines.n_timeslices() * n_bytes_per_timeslice) {
+        throw std::runtime_error {"ERROR: the binary worldline file ends before all the coordinates were read.\n"};
+    }
+
+    auto values = std::vector<FPFile>(n_values_per_timeslice);
+
+    for (std::size_t i_tslice {0}; i_tslice < worldlines.n_timeslices(); ++i_tslice) {
+        std::memcpy(values.data(), bytes.data() + i_tslice * n_bytes_per_timeslice, n_bytes_per_timeslice);
+        store_timeslice_values_<FPFile>(values, worldlines, i_tslice);
+    }
+}
+
+template <std::floating_point FPFile, std::floating_point FP, std::size_t NDIM>
+void decode_delta_bitpack_coordinates_(std::span<const char> bytes, worldline::Worldlines<FP, NDIM>& worldlines)
+{
+    const auto n_values_per_timeslice = worldlines.n_worldlines() * NDIM;
+
+    auto decoder = worldline::DeltaBitpackDecoder<FPFile> {n_values_per_timeslice, bytes};
+    auto values = std::vector<FPFile>(n_values_per_timeslice);
+
+    for (std::size_t i_tslice {0}; i_tslice < worldlines.n_timeslices(); ++i_tslice) {
+        decoder.decode_timeslice(values);
+        store_timeslice_values_<FPFile>(values, worldlines, i_tslice);
+    }
+}
+
+}  // namespace impl_worldline
+
+namespace worldline
+{
+
+struct BinaryWorldlineHeader
+{
+    std::uint32_t version {impl_worldline::BINARY_WORLDLINE_VERSION};
+    std::uint32_t ndim {};
+    std::uint32_t fp_width {};
+    std::uint32_t codec {0};
+    std::uint64_t block_index {};
+    std::uint64_t n_particles {};
+    std::uint64_t n_timeslices {};
+
+    // the size of the uncompressed coordinates; only safe to call on a header from `parse_binary_worldline_header()`
+    constexpr auto n_coordinate_bytes() const noexcept -> std::uint64_t
+    {
+        return n_timeslices * n_particles * ndim * fp_width;
+    }
+};
+
+/*
+    Check whether the first bytes of a file mark it as a binary worldline file.
+*/
+inline auto is_binary_worldline_file(const std::filesystem::path& filepath) -> bool
+{
+    auto stream = std::ifstream {filepath, std::ios::binary};
+    if (!stream.is_open()) {
+        return false;
+    }
+
+    auto magic = std::array<char, impl_worldline::BINARY_WORLDLINE_MAGIC.size()> {};
+    stream.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    if (stream.gcount() != static_cast<std::streamsize>(magic.size())) {
+        return false;
+    }
+
+    return impl_worldline::is_binary_worldline_magic_(magic);
+}
+
+/*
+    Parse and validate the header at the start of `bytes`, which holds the entire contents of a file.
+*/
+inline auto parse_binary_worldline_header(std::span<const char> bytes) -> BinaryWorldlineHeader
+{
+    const auto is_long_enough = bytes.size() >= impl_worldline::BINARY_WORLDLINE_HEADER_SIZE;
+    if (!is_long_enough || !impl_worldline::is_binary_worldline_magic_(bytes)) {
+        throw std::runtime_error {"ERROR: the data does not start with a binary worldline header.\n"};
+    }
+
+    auto reader = common::io::BinaryReader {bytes};
+    reader.read_bytes(impl_worldline::BINARY_WORLDLINE_MAGIC.size());
+
+    auto header = BinaryWorldlineHeader {};
+    header.version = reader.read<std::uint32_t>();
+    header.ndim = reader.read<std::uint32_t>();
+    header.fp_width = reader.read<std::uint32_t>();
+    header.codec = reader.read<std::uint32_t>();
+    header.block_index = reader.read<std::uint64_t>();
+    header.n_particles = reader.read<std::uint64_t>();
+    header.n_timeslices = reader.read<std::uint64_t>();
+
+    if (header.version != impl_worldline::BINARY_WORLDLINE_VERSION) {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: unsupported version of the binary worldline format.\n";
+        err_msg << "Supported: " << impl_worldline::BINARY_WORLDLINE_VERSION << '\n';
+        err_msg << "Found: " << header.version << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+
+    if (header.fp_width != sizeof(float) && header.fp_width != sizeof(double)) {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: the floating-point width in the binary worldline header must be 4 or 8 bytes.\n";
+        err_msg << "Found: " << header.fp_width << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+
+    if (header.codec != static_cast<std::uint32_t>(WorldlineCodec::RAW)
+        && header.codec != static_cast<std::uint32_t>(WorldlineCodec::DELTA_BITPACK)) {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: unsupported codec in the binary worldline file.\n";
+        err_msg << "Found: " << header.codec << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+
+    /*
+        The sizes in the header decide how much memory the reader allocates, so they are checked against the
+        size of the file first; the uncompressed coordinates take up `fp_width` bytes each, and the compressed
+        coordinates at least one bit each.
+    */
+    const auto n_values = impl_worldline::checked_product_({header.n_timeslices, header.n_particles, header.ndim});
+    const auto n_raw_bytes = n_values ? impl_worldline::checked_product_({*n_values, header.fp_width}) : std::nullopt;
+    if (!n_raw_bytes) {
+        throw std::runtime_error {"ERROR: the sizes in the binary worldline header are too large.\n"};
+    }
+
+    const auto is_raw = header.codec == static_cast<std::uint32_t>(WorldlineCodec::RAW);
+    const auto n_minimum_bytes = is_raw ? *n_raw_bytes : (*n_values / 8) + ((*n_values % 8) != 0 ? 1 : 0);
+    if (bytes.size() - impl_worldline::BINARY_WORLDLINE_HEADER_SIZE < n_minimum_bytes) {
+        throw std::runtime_error {"ERROR: the binary worldline file ends before all the coordinates were read.\n"};
+    }
+
+    return header;
+}
+
+/*
+    Write the worldlines in the binary worldline format, with the coordinates stored at the precision
+    of the simulation, using the given codec.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+void write_binary_worldlines(
+    std::ostream& stream,
+    std::size_t i_block,
+    const Worldlines<FP, NDIM>& worldlines,
+    WorldlineCodec codec = WorldlineCodec::RAW
+)
+{
+    using common::io::write_binary;
+
+    stream.write(impl_worldline::BINARY_WORLDLINE_MAGIC.data(), impl_worldline::BINARY_WORLDLINE_MAGIC.size());
+    write_binary(stream, impl_worldline::BINARY_WORLDLINE_VERSION);
+    write_binary(stream, static_cast<std::uint32_t>(NDIM));
+    write_binary(stream, static_cast<std::uint32_t>(sizeof(FP)));
+    write_binary(stream, static_cast<std::uint32_t>(codec));
+    write_binary(stream, static_cast<std::uint64_t>(i_block));
+    write_binary(stream, static_cast<std::uint64_t>(worldlines.n_worldlines()));
+    write_binary(stream, static_cast<std::uint64_t>(worldlines.n_timeslices()));
+
+    const auto n_values_per_timeslice = worldlines.n_worldlines() * NDIM;
+    auto values = std::vector<FP>(n_values_per_timeslice);
+
+    if (codec == WorldlineCodec::DELTA_BITPACK) {
+        auto encoder = DeltaBitpackEncoder<FP> {n_values_per_timeslice, stream};
+        for (std::size_t i_tslice {0}; i_tslice < worldlines.n_timeslices(); ++i_tslice) {
+            impl_worldline::load_timeslice_values_(worldlines, i_tslice, values);
+            encoder.encode_timeslice(values);
+        }
+        encoder.finish();
+
+        return;
+    }
+
+    for (std::size_t i_tslice {0}; i_tslice < worldlines.n_timeslices(); ++i_tslice) {
+        impl_worldline::load_timeslice_values_(worldlines, i_tslice, values);
+        write_binary(stream, std::span<const FP> {values});
+    }
+}
+
+/*
+    Read worldlines from the entire contents of a binary worldline file. Coordinates stored at a different
+    precision than `FP` are converted.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+auto read_binary_worldlines(std::span<const char> bytes) -> Worldlines<FP, NDIM>
+{
+    const auto header = parse_binary_worldline_header(bytes);
+
+    if (header.ndim != NDIM) {
+        auto err_msg = std::stringstream {};
+        err_msg
+            << "The number of dimensions for this simulation does not match the number of dimensions in the file.\n";
+        err_msg << "In simulation: NDIM = " << NDIM << '\n';
+        err_msg << "In file: ndim = " << header.ndim << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+
+    auto worldlines = Worldlines<FP, NDIM> {header.n_timeslices, header.n_particles};
+    const auto coordinate_bytes = bytes.subspan(impl_worldline::BINARY_WORLDLINE_HEADER_SIZE);
+    const auto is_float = header.fp_width == sizeof(float);
+
+    if (header.codec == static_cast<std::uint32_t>(WorldlineCodec::DELTA_BITPACK)) {
+        if (is_float) {
+            impl_worldline::decode_delta_bitpack_coordinates_<float>(coordinate_bytes, worldlines);
+        }
+        else {
+            impl_worldline::decode_delta_bitpack_coordinates_<double>(coordinate_bytes, worldlines);
+        }
+    }
+    else {
+        if (is_float) {
+            impl_worldline::copy_raw_coordinates_<float>(coordinate_bytes, worldlines);
+        }
+        else {
+            impl_worldline::copy_raw_coordinates_<double>(coordinate_bytes, worldlines);
+        }
+    }
+
+    return worldlines;
+}
+
+template <std::floating_point FP, std::size_t NDIM>
+auto read_binary_worldlines(const std::filesystem::path& filepath) -> Worldlines<FP, NDIM>
+{
+    const auto file = common::io::MappedFile {filepath};
+    return read_binary_worldlines<FP, NDIM>(file.bytes());
+}
+
+/*
+    The MappedWorldlines class memory-maps a binary worldline file, and gives read-only access to the
+    beads of each timeslice without copying them out of the file.
+
+    The coordinates in the file must be stored uncompressed, at the same precision as `FP`, and the file
+    must not be modified while it is mapped.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+class MappedWorldlines
+{
+public:
+    using Point = coord::Cartesian<FP, NDIM>;
+
+    // the beads in the file are viewed in place as `Point` instances, so they must have the same layout
+    static_assert(sizeof(Point) == NDIM * sizeof(FP));
+    static_assert(std::is_trivially_copyable_v<Point> && std::is_standard_layout_v<Point>);
+
+    explicit MappedWorldlines(const std::filesystem::path& filepath)
+        : file_ {filepath}
+        , header_ {parse_binary_worldline_header(file_.bytes())}
+    {
+        ctr_check_header_matches_(header_);
+    }
+
+    constexpr auto block_index() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(header_.block_index);
+    }
+
+    constexpr auto n_worldlines() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(header_.n_particles);
+    }
+
+    constexpr auto n_timeslices() const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(header_.n_timeslices);
+    }
+
+    auto timeslice(std::size_t i_timeslice) const noexcept -> std::span<const Point>
+    {
+        const auto* coordinates = file_.bytes().data() + impl_worldline::BINARY_WORLDLINE_HEADER_SIZE;
+        const auto* points = reinterpret_cast<const Point*>(coordinates);
+
+        return {points + i_timeslice * n_worldlines(), n_worldlines()};
+    }
+
+    auto to_worldlines() const -> Worldlines<FP, NDIM>
+    {
+        return read_binary_worldlines<FP, NDIM>(file_.bytes());
+    }
+
+private:
+    common::io::MappedFile file_;
+    BinaryWorldlineHeader header_;
+
+    void ctr_check_header_matches_(const BinaryWorldlineHeader& header) const
+    {
+        const auto raw_codec = static_cast<std::uint32_t>(WorldlineCodec::RAW);
+        if (header.ndim != NDIM || header.fp_width != sizeof(FP) || header.codec != raw_codec) {
+            auto err_msg = std::stringstream {};
+            err_msg << "ERROR: the binary worldline file cannot be viewed in place by this simulation.\n";
+            err_msg << "In simulation: NDIM = " << NDIM << ", fp_width = " << sizeof(FP) << ", codec = 0\n";
+            err_msg << "In file: ndim = " << header.ndim << ", fp_width = " << header.fp_width;
+            err_msg << ", codec = " << header.codec << '\n';
+            throw std::runtime_error {err_msg.str()};
+        }
+
+        if (file_.bytes().size() - impl_worldline::BINARY_WORLDLINE_HEADER_SIZE < header.n_coordinate_bytes()) {
+            throw std::runtime_error {"ERROR: the binary worldline file ends before all the coordinates were read.\n"};
+        }
+    }
+};
+
+}  // namespace worldline
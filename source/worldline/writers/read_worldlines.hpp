@@ -9,9 +9,11 @@
 #include <utility>
 #include <vector>
 
+#include <common/io_utils.hpp>
 #include <common/writer_utils.hpp>
 #include <coordinates/cartesian.hpp>
 #include <worldline/worldline.hpp>
+#include <worldline/writers/binary_worldlines.hpp>
 #include <worldline/writers/worldline_writer.hpp>
 
 namespace worldline
@@ -29,14 +31,16 @@ auto read_cartesian(std::istream& stream) -> coord::Cartesian<FP, NDIM>
 }
 
 template <std::floating_point FP, std::size_t NDIM>
-auto read_worldlines(std::istream& stream) -> Worldlines<FP, NDIM>
+auto read_worldlines(std::istream& stream, std::size_t* i_block = nullptr) -> Worldlines<FP, NDIM>
 {
     common::writers::skip_lines_starting_with(stream, '#');
 
-    // the first non-comment line is the block index; we don't really need it
-    // not enough lines for std::istream::ignore to be worth it
-    auto dummy = std::string {};
-    std::getline(stream, dummy);
+    // the first non-comment line is the block index; only some callers need it
+    auto block_index = std::size_t {};
+    stream >> block_index;
+    if (i_block != nullptr) {
+        *i_block = block_index;
+    }
 
     // get the number of dimensions; might as well do a verification
     auto ndim = std::size_t {};
@@ -68,9 +72,17 @@ auto read_worldlines(std::istream& stream) -> Worldlines<FP, NDIM>
     return worldlines;
 }
 
+/*
+    Read the worldlines from either a text worldline file or a binary worldline file; the format is
+    recognized from the start of the file.
+*/
 template <std::floating_point FP, std::size_t NDIM>
 auto read_worldlines(const std::filesystem::path& filepath) -> Worldlines<FP, NDIM>
 {
+    if (is_binary_worldline_file(filepath)) {
+        return read_binary_worldlines<FP, NDIM>(filepath);
+    }
+
     auto stream = std::ifstream {filepath};
     if (!stream.is_open()) {
         auto err_msg = std::stringstream {};
@@ -81,4 +93,40 @@ auto read_worldlines(const std::filesystem::path& filepath) -> Worldlines<FP, ND
     return read_worldlines<FP, NDIM>(stream);
 }
 
+/*
+    Convert a text worldline file into a binary worldline file, with the coordinates stored as `FP`
+    using the given codec.
+
+    The binary file is written next to its destination first, and renamed into place once it is complete,
+    so `binary_filepath` may be the same as `text_filepath`.
+*/
+template <std::floating_point FP, std::size_t NDIM>
+void convert_text_worldlines_to_binary(
+    const std::filesystem::path& text_filepath,
+    const std::filesystem::path& binary_filepath,
+    WorldlineCodec codec = WorldlineCodec::RAW
+)
+{
+    auto in_stream = std::ifstream {text_filepath};
+    if (!in_stream.is_open()) {
+        auto err_msg = std::stringstream {};
+        err_msg << "Error: Unable to open file: '" << text_filepath << "'\n";
+        throw std::ios_base::failure {err_msg.str()};
+    }
+
+    auto i_block = std::size_t {};
+    const auto worldlines = read_worldlines<FP, NDIM>(in_stream, &i_block);
+    in_stream.close();
+
+    auto temp_filepath = binary_filepath;
+    temp_filepath += common::writers::DEFAULT_TEMPORARY_SUFFIX;
+
+    {
+        auto out_stream = common::io::open_output_filestream_checked(temp_filepath);
+        write_binary_worldlines(out_stream, i_block, worldlines, codec);
+    }
+
+    std::filesystem::rename(temp_filepath, binary_filepath);
+}
+
 }  // namespace worldline
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/*
+    A lossless codec for the bead coordinates of a worldline snapshot, which needs no external libraries.
+
+    Neighbouring beads on the same worldline are close to each other, so the IEEE bits of their coordinates
+    usually share the sign, the exponent, and the leading bits of the mantissa. Each coordinate is therefore
+    stored as the difference between its bits and the bits of the same coordinate of the same particle on
+    the previous timeslice (taken as integers, and zigzag-encoded so that small negative differences are
+    also small). The differences have many leading zero bits, and only the bits after them are stored,
+    packed together without any padding:
+      - '0'   the difference fits in the width used last time for this coordinate, and follows with that width
+      - '1'   a new width follows, and then the difference with that width
+
+    A difference that is much narrower than the current width also starts a new width, so that the width
+    follows the size of the steps along each worldline.
+
+    The coordinates are processed one timeslice at a time, so that both the encoder and the decoder only
+    keep the previous timeslice around, and the encoded bits are written out as they are produced.
+*/
+
+namespace impl_worldline
+{
+
+template <std::floating_point FP>
+using ieee_bits_t = std::conditional_t<sizeof(FP) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+
+template <std::floating_point FP>
+constexpr auto N_IEEE_BITS = static_cast<int>(8 * sizeof(FP));
+
+// enough bits to hold any width from 0 to `N_IEEE_BITS` inclusive
+template <std::floating_point FP>
+constexpr auto N_WIDTH_FIELD_BITS = static_cast<int>(std::bit_width(static_cast<unsigned int>(N_IEEE_BITS<FP>)));
+
+template <std::floating_point FP>
+constexpr auto zigzag_difference_(ieee_bits_t<FP> bits, ieee_bits_t<FP> previous) noexcept -> ieee_bits_t<FP>
+{
+    using Bits = ieee_bits_t<FP>;
+    using SignedBits = std::make_signed_t<Bits>;
+
+    const auto difference = static_cast<SignedBits>(static_cast<Bits>(bits - previous));
+    const auto sign_mask = static_cast<Bits>(difference >> (N_IEEE_BITS<FP> - 1));
+
+    return static_cast<Bits>(static_cast<Bits>(difference) << 1) ^ sign_mask;
+}
+
+template <std::floating_point FP>
+constexpr auto undo_zigzag_difference_(ieee_bits_t<FP> zigzag, ieee_bits_t<FP> previous) noexcept -> ieee_bits_t<FP>
+{
+    using Bits = ieee_bits_t<FP>;
+
+    const auto difference = static_cast<Bits>((zigzag >> 1) ^ static_cast<Bits>(Bits {0} - (zigzag & Bits {1})));
+    return static_cast<Bits>(previous + difference);
+}
+
+/*
+    Writes bits to a stream, most significant bit first; the bits are gathered in a buffer of bytes, which
+    is written out whenever it fills up, and by `flush()`.
+*/
+class BitWriter
+{
+public:
+    explicit BitWriter(std::ostream& stream)
+        : stream_ {stream}
+    {
+        bytes_.reserve(N_BYTES_PER_WRITE_);
+    }
+
+    void write(std::uint64_t value, int n_bits)
+    {
+        // keeping each piece to 32 bits means the accumulator never holds more than 39 bits
+        if (n_bits > 32) {
+            write_at_most_32_(value >> 32, n_bits - 32);
+            write_at_most_32_(value & 0xffffffffu, 32);
+        }
+        else {
+            write_at_most_32_(value, n_bits);
+        }
+    }
+
+    // the last byte is padded with zero bits
+    void flush()
+    {
+        if (n_accumulated_ > 0) {
+            bytes_.push_back(static_cast<char>(accumulator_ << (8 - n_accumulated_)));
+            accumulator_ = 0;
+            n_accumulated_ = 0;
+        }
+
+        stream_.write(bytes_.data(), static_cast<std::streamsize>(bytes_.size()));
+        bytes_.clear();
+    }
+
+private:
+    static constexpr auto N_BYTES_PER_WRITE_ = std::size_t {1 << 16};
+
+    std::ostream& stream_;
+    std::vector<char> bytes_ {};
+    std::uint64_t accumulator_ {0};
+    int n_accumulated_ {0};
+
+    void write_at_most_32_(std::uint64_t value, int n_bits)
+    {
+        if (n_bits == 0) {
+            return;
+        }
+
+        accumulator_ = (accumulator_ << n_bits) | value;
+        n_accumulated_ += n_bits;
+
+        while (n_accumulated_ >= 8) {
+            n_accumulated_ -= 8;
+            bytes_.push_back(static_cast<char>(accumulator_ >> n_accumulated_));
+        }
+        accumulator_ &= (std::uint64_t {1} << n_accumulated_) - 1;
+
+        if (bytes_.size() >= N_BYTES_PER_WRITE_) {
+            stream_.write(bytes_.data(), static_cast<std::streamsize>(bytes_.size()));
+            bytes_.clear();
+        }
+    }
+};
+
+/*
+    Reads the bits written by the BitWriter, in the same order.
+*/
+class BitReader
+{
+public:
+    explicit BitReader(std::span<const char> bytes)
+        : bytes_ {bytes}
+    {}
+
+    auto read(int n_bits) -> std::uint64_t
+    {
+        if (n_bits > 32) {
+            const auto upper = read_at_most_32_(n_bits - 32);
+            return (upper << 32) | read_at_most_32_(32);
+        }
+
+        return read_at_most_32_(n_bits);
+    }
+
+    constexpr auto n_bytes_read() const noexcept -> std::size_t
+    {
+        return i_next_byte_;
+    }
+
+private:
+    std::span<const char> bytes_;
+    std::size_t i_next_byte_ {0};
+    std::uint64_t accumulator_ {0};
+    int n_accumulated_ {0};
+
+    auto read_at_most_32_(int n_bits) -> std::uint64_t
+    {
+        while (n_accumulated_ < n_bits) {
+            if (i_next_byte_ == bytes_.size()) {
+                throw std::runtime_error {"ERROR: the encoded worldline coordinates end unexpectedly.\n"};
+            }
+
+            const auto byte = static_cast<std::uint8_t>(bytes_[i_next_byte_++]);
+            accumulator_ = (accumulator_ << 8) | byte;
+            n_accumulated_ += 8;
+        }
+
+        n_accumulated_ -= n_bits;
+        const auto value = accumulator_ >> n_accumulated_;
+        accumulator_ &= (std::uint64_t {1} << n_accumulated_) - 1;
+
+        return value;
+    }
+};
+
+}  // namespace impl_worldline
+
+namespace worldline
+{
+
+/*
+    The codecs a binary worldline file can use to store its coordinates; the value is stored in the header.
+*/
+enum class WorldlineCodec : std::uint32_t
+{
+    RAW = 0,
+    DELTA_BITPACK = 1
+};
+
+/*
+    Encodes the coordinates of a worldline snapshot one timeslice at a time; every timeslice must have
+    `n_values_per_timeslice` coordinates, and `finish()` must be called after the last one.
+*/
+template <std::floating_point FP>
+class DeltaBitpackEncoder
+{
+public:
+    using Bits = impl_worldline::ieee_bits_t<FP>;
+
+    DeltaBitpackEncoder(std::size_t n_values_per_timeslice, std::ostream& stream)
+        : writer_ {stream}
+        , previous_(n_values_per_timeslice, Bits {0})
+        , widths_(n_values_per_timeslice, 0)
+    {}
+
+    void encode_timeslice(std::span<const FP> values)
+    {
+        constexpr auto n_field_bits = impl_worldline::N_WIDTH_FIELD_BITS<FP>;
+
+        check_n_values_(values.size());
+
+        for (std::size_t i_value {0}; i_value < values.size(); ++i_value) {
+            const auto bits = std::bit_cast<Bits>(values[i_value]);
+            const auto zigzag = impl_worldline::zigzag_difference_<FP>(bits, previous_[i_value]);
+            previous_[i_value] = bits;
+
+            const auto width = static_cast<int>(std::bit_width(zigzag));
+            auto& current_width = widths_[i_value];
+
+            // narrowing the width only pays off once it saves more bits than storing the new width costs
+            if (width <= current_width && current_width - width <= n_field_bits) {
+                writer_.write(0b0, 1);
+            }
+            else {
+                current_width = width;
+                writer_.write(0b1, 1);
+                writer_.write(static_cast<std::uint64_t>(current_width), n_field_bits);
+            }
+
+            writer_.write(zigzag, current_width);
+        }
+    }
+
+    void finish()
+    {
+        writer_.flush();
+    }
+
+private:
+    impl_worldline::BitWriter writer_;
+    std::vector<Bits> previous_;
+    std::vector<int> widths_;
+
+    void check_n_values_(std::size_t n_values) const
+    {
+        if (n_values != previous_.size()) {
+            auto err_msg = std::stringstream {};
+            err_msg << "ERROR: every timeslice given to the encoder must have the same number of coordinates.\n";
+            err_msg << "Expected: " << previous_.size() << '\n';
+            err_msg << "Found: " << n_values << '\n';
+            throw std::runtime_error {err_msg.str()};
+        }
+    }
+};
+
+/*
+    Decodes the coordinates written by the DeltaBitpackEncoder, one timeslice at a time.
+*/
+template <std::floating_point FP>
+class DeltaBitpackDecoder
+{
+public:
+    using Bits = impl_worldline::ieee_bits_t<FP>;
+
+    DeltaBitpackDecoder(std::size_t n_values_per_timeslice, std::span<const char> bytes)
+        : reader_ {bytes}
+        , previous_(n_values_per_timeslice, Bits {0})
+        , widths_(n_values_per_timeslice, 0)
+    {}
+
+    void decode_timeslice(std::span<FP> values)
+    {
+        constexpr auto n_ieee_bits = impl_worldline::N_IEEE_BITS<FP>;
+        constexpr auto n_field_bits = impl_worldline::N_WIDTH_FIELD_BITS<FP>;
+
+        for (std::size_t i_value {0}; i_value < values.size(); ++i_value) {
+            auto& current_width = widths_[i_value];
+
+            if (reader_.read(1) == 0b1) {
+                current_width = static_cast<int>(reader_.read(n_field_bits));
+                if (current_width > n_ieee_bits) {
+                    throw std::runtime_error {"ERROR: the encoded worldline coordinates are corrupted.\n"};
+                }
+            }
+
+            const auto zigzag = static_cast<Bits>(reader_.read(current_width));
+            previous_[i_value] = impl_worldline::undo_zigzag_difference_<FP>(zigzag, previous_[i_value]);
+
+            values[i_value] = std::bit_cast<FP>(previous_[i_value]);
+        }
+    }
+
+    constexpr auto n_bytes_read() const noexcept -> std::size_t
+    {
+        return reader_.n_bytes_read();
+    }
+
+private:
+    impl_worldline::BitReader reader_;
+    std::vector<Bits> previous_;
+    std::vector<int> widths_;
+};
+
+}  // namespace worldline
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace worldline
+{
+
+/*
+    The formats the WorldlineWriter can save the worldlines in:
+      - TEXT: human-readable text files
+      - BINARY: binary worldline files with the raw coordinates
+      - COMPRESSED_BINARY: binary worldline files with losslessly compressed coordinates
+*/
+enum class WorldlineFileFormat
+{
+    TEXT,
+    BINARY,
+    COMPRESSED_BINARY
+};
+
+constexpr auto WORLDLINE_FILE_FORMAT_OPTIONS = std::array<std::string_view, 3> {"text", "binary", "compressed"};
+
+inline auto map_worldline_file_format(std::string_view name) -> WorldlineFileFormat
+{
+    if (name == WORLDLINE_FILE_FORMAT_OPTIONS[0]) {
+        return WorldlineFileFormat::TEXT;
+    }
+    else if (name == WORLDLINE_FILE_FORMAT_OPTIONS[1]) {
+        return WorldlineFileFormat::BINARY;
+    }
+    else if (name == WORLDLINE_FILE_FORMAT_OPTIONS[2]) {
+        return WorldlineFileFormat::COMPRESSED_BINARY;
+    }
+    else {
+        auto err_msg = std::stringstream {};
+        err_msg << "ERROR: unknown worldline file format: '" << name << "'\n";
+        err_msg << "The options are: ";
+        for (const auto option : WORLDLINE_FILE_FORMAT_OPTIONS) {
+            err_msg << '"' << option << "\" ";
+        }
+        err_msg << '\n';
+        throw std::runtime_error {err_msg.str()};
+    }
+}
+
+}  // namespace worldline
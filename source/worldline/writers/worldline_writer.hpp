@@ -17,6 +17,8 @@
 #include <coordinates/cartesian.hpp>
 #include <environment/environment.hpp>
 #include <worldline/worldline.hpp>
+#include <worldline/writers/binary_worldlines.hpp>
+#include <worldline/writers/worldline_file_format.hpp>
 
 namespace impl_worldline
 {
@@ -86,15 +88,26 @@ public:
     explicit WorldlineWriter(
         std::filesystem::path output_dirpath,
         std::string prefix = std::string {"worldline"},
-        std::string suffix = std::string {".dat"}
+        std::string suffix = std::string {".dat"},
+        WorldlineFileFormat format = WorldlineFileFormat::TEXT
     )
         : output_dirpath_ {std::move(output_dirpath)}
         , prefix_ {std::move(prefix)}
         , suffix_ {std::move(suffix)}
+        , format_ {format}
     {}
 
     void write(std::size_t i_block, const Worldlines<FP, NDIM>& worldlines) const
     {
+        if (format_ != WorldlineFileFormat::TEXT) {
+            const auto codec =
+                format_ == WorldlineFileFormat::BINARY ? WorldlineCodec::RAW : WorldlineCodec::DELTA_BITPACK;
+
+            auto out_stream = common::io::open_output_filestream_checked(output_filepath(i_block));
+            write_binary_worldlines(out_stream, i_block, worldlines, codec);
+            return;
+        }
+
         const auto n_particles = worldlines.n_worldlines();
         const auto n_timeslices = worldlines.n_timeslices();
         const auto header = impl_worldline::worldline_file_header_<FP, NDIM>(n_particles, n_timeslices, i_block);
@@ -123,10 +136,16 @@ public:
         return output_dirpath_ / filename.str();
     }
 
+    constexpr auto format() const noexcept -> WorldlineFileFormat
+    {
+        return format_;
+    }
+
 private:
     std::filesystem::path output_dirpath_;
     std::string prefix_;
     std::string suffix_;
+    WorldlineFileFormat format_;
 };
 
 }  // namespace worldline
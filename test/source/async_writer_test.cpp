@@ -0,0 +1,86 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/async_writer.hpp"
+
+TEST_CASE("AsyncWriterService", "[AsyncWriterService]")
+{
+    namespace cw = common::writers;
+
+    SECTION("tasks run in the order they were submitted")
+    {
+        // a small queue, so that `submit()` has to wait for the background thread to catch up
+        auto service = cw::AsyncWriterService {2};
+
+        auto order = std::vector<std::size_t> {};
+        for (std::size_t i {0}; i < 50; ++i) {
+            service.submit([&order, i]() { order.push_back(i); });
+        }
+        service.fence();
+
+        REQUIRE(order.size() == 50);
+        for (std::size_t i {0}; i < order.size(); ++i) {
+            REQUIRE(order[i] == i);
+        }
+    }
+
+    SECTION("tasks own a snapshot of the data they write")
+    {
+        auto service = cw::AsyncWriterService {};
+
+        auto data = std::vector<int> {1, 2, 3};
+        auto written = std::vector<int> {};
+        service.submit([&written, snapshot = data]() { written = snapshot; });
+
+        data.push_back(4);
+        service.fence();
+
+        REQUIRE(written == std::vector<int> {1, 2, 3});
+    }
+
+    SECTION("exceptions are rethrown by the next fence")
+    {
+        auto service = cw::AsyncWriterService {};
+        auto n_completed = std::atomic<int> {0};
+        auto is_released = std::atomic<bool> {false};
+
+        // hold the failing task back until the second task is queued, since `submit()` also rethrows
+        service.submit([&is_released]() {
+            while (!is_released) {
+                std::this_thread::yield();
+            }
+            throw std::runtime_error {"failed write"};
+        });
+        service.submit([&n_completed]() { ++n_completed; });
+        is_released = true;
+
+        REQUIRE_THROWS_AS(service.fence(), std::runtime_error);
+        REQUIRE(n_completed == 1);
+
+        // the exception is only reported once
+        REQUIRE_NOTHROW(service.fence());
+    }
+
+    SECTION("the destructor runs the remaining tasks")
+    {
+        auto n_completed = std::atomic<int> {0};
+        {
+            auto service = cw::AsyncWriterService {};
+            for (int i {0}; i < 10; ++i) {
+                service.submit([&n_completed]() { ++n_completed; });
+            }
+        }
+
+        REQUIRE(n_completed == 10);
+    }
+
+    SECTION("invalid construction")
+    {
+        REQUIRE_THROWS_AS(cw::AsyncWriterService {0}, std::runtime_error);
+    }
+}
@@ -0,0 +1,360 @@
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "coordinates/cartesian.hpp"
+#include "worldline/worldline.hpp"
+#include "worldline/writers/binary_worldlines.hpp"
+#include "worldline/writers/read_worldlines.hpp"
+#include "worldline/writers/worldline_codec.hpp"
+#include "worldline/writers/worldline_writer.hpp"
+
+#include "../test_utils/test_utils.hpp"
+
+namespace
+{
+
+auto example_worldlines() -> worldline::Worldlines<double, 3>
+{
+    using Point = coord::Cartesian<double, 3>;
+
+    auto worldlines = worldline::Worldlines<double, 3> {3, 2};
+    worldlines.set(0, 0, Point {-2.43531882e-01, -1.82242452e-01, 2.46618159e-01});
+    worldlines.set(0, 1, Point {-1.38601913e-01, 3.30594232e+00, -1.91322270e-01});
+    worldlines.set(1, 0, Point {1.82466528e+00, 7.24260147e-01, 3.19777664e+00});
+    worldlines.set(1, 1, Point {-7.06441454e-01, 4.01323907e+00, 3.30114762e+00});
+    worldlines.set(2, 0, Point {3.97260972e+00, -1.85454391e-01, 3.76458239e-01});
+    worldlines.set(2, 1, Point {1.0 / 3.0, 2.0 / 7.0, 1.0e-300});
+
+    return worldlines;
+}
+
+auto exactly_equal(const worldline::Worldlines<double, 3>& lhs, const worldline::Worldlines<double, 3>& rhs) -> bool
+{
+    if (lhs.n_timeslices() != rhs.n_timeslices() || lhs.n_worldlines() != rhs.n_worldlines()) {
+        return false;
+    }
+
+    for (std::size_t i_tslice {0}; i_tslice < lhs.n_timeslices(); ++i_tslice) {
+        for (std::size_t i_part {0}; i_part < lhs.n_worldlines(); ++i_part) {
+            if (lhs.get(i_tslice, i_part).coordinates() != rhs.get(i_tslice, i_part).coordinates()) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// a random walk along imaginary time, like the beads of a worldline
+template <typename FP>
+auto random_walk_worldlines(std::size_t n_timeslices, std::size_t n_particles) -> worldline::Worldlines<FP, 3>
+{
+    auto prng = std::mt19937 {12345};
+    auto step = std::normal_distribution<FP> {FP {0.0}, static_cast<FP>(0.05)};
+    auto start = std::uniform_real_distribution<FP> {FP {0.0}, FP {10.0}};
+
+    auto worldlines = worldline::Worldlines<FP, 3> {n_timeslices, n_particles};
+    for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+        auto point = coord::Cartesian<FP, 3> {start(prng), start(prng), start(prng)};
+        for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+            point += coord::Cartesian<FP, 3> {step(prng), step(prng), step(prng)};
+            worldlines.set(i_tslice, i_part, point);
+        }
+    }
+
+    return worldlines;
+}
+
+template <typename FP>
+auto exactly_equal_bits(const worldline::Worldlines<FP, 3>& lhs, const worldline::Worldlines<FP, 3>& rhs) -> bool
+{
+    using Bits = impl_worldline::ieee_bits_t<FP>;
+
+    if (lhs.n_timeslices() != rhs.n_timeslices() || lhs.n_worldlines() != rhs.n_worldlines()) {
+        return false;
+    }
+
+    for (std::size_t i_tslice {0}; i_tslice < lhs.n_timeslices(); ++i_tslice) {
+        for (std::size_t i_part {0}; i_part < lhs.n_worldlines(); ++i_part) {
+            for (std::size_t i_dim {0}; i_dim < 3; ++i_dim) {
+                const auto lhs_bits = std::bit_cast<Bits>(lhs.get(i_tslice, i_part)[i_dim]);
+                const auto rhs_bits = std::bit_cast<Bits>(rhs.get(i_tslice, i_part)[i_dim]);
+                if (lhs_bits != rhs_bits) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+auto binary_worldlines_test_dirpath() -> std::filesystem::path
+{
+    namespace fs = std::filesystem;
+
+    const auto abs_dirpath = test_utils::resolve_project_path(fs::path {"test"} / "test_io");
+    const auto test_dirpath = abs_dirpath / "binary_worldlines";
+    if (!fs::exists(test_dirpath)) {
+        fs::create_directory(test_dirpath);
+    }
+
+    return test_dirpath;
+}
+
+}  // namespace
+
+TEST_CASE("binary worldlines round trip", "[BinaryWorldlines]")
+{
+    const auto worldlines = example_worldlines();
+
+    auto stream = std::stringstream {};
+    worldline::write_binary_worldlines(stream, 42, worldlines);
+    const auto contents = stream.str();
+
+    SECTION("header")
+    {
+        const auto header = worldline::parse_binary_worldline_header(contents);
+
+        REQUIRE(header.ndim == 3);
+        REQUIRE(header.fp_width == sizeof(double));
+        REQUIRE(header.codec == 0);
+        REQUIRE(header.block_index == 42);
+        REQUIRE(header.n_particles == 2);
+        REQUIRE(header.n_timeslices == 3);
+        REQUIRE(contents.size() == 48 + header.n_coordinate_bytes());
+    }
+
+    SECTION("coordinates are read back exactly")
+    {
+        const auto actual = worldline::read_binary_worldlines<double, 3>(std::span<const char> {contents});
+        REQUIRE(exactly_equal(worldlines, actual));
+    }
+
+    SECTION("truncated data is rejected")
+    {
+        const auto truncated = std::span<const char> {contents}.first(contents.size() - 1);
+        REQUIRE_THROWS_AS((worldline::read_binary_worldlines<double, 3>(truncated)), std::runtime_error);
+    }
+
+    SECTION("header sizes that overflow, or that the file is too small for, are rejected before reading")
+    {
+        // the number of particles is the little-endian uint64 at byte 32 of the header
+        const auto with_n_particles = [&](std::uint64_t n_particles) {
+            auto corrupted = contents;
+            for (std::size_t i_byte {0}; i_byte < 8; ++i_byte) {
+                corrupted[32 + i_byte] = static_cast<char>((n_particles >> (8 * i_byte)) & 0xff);
+            }
+            return corrupted;
+        };
+
+        const auto n_particles = GENERATE(std::uint64_t {3}, std::uint64_t {1} << 40, std::uint64_t {1} << 62);
+        const auto corrupted = with_n_particles(n_particles);
+
+        REQUIRE_THROWS_AS(worldline::parse_binary_worldline_header(corrupted), std::runtime_error);
+        const auto bytes = std::span<const char> {corrupted};
+        REQUIRE_THROWS_AS((worldline::read_binary_worldlines<double, 3>(bytes)), std::runtime_error);
+    }
+
+    SECTION("mismatched number of dimensions is rejected")
+    {
+        const auto bytes = std::span<const char> {contents};
+        REQUIRE_THROWS_AS((worldline::read_binary_worldlines<double, 2>(bytes)), std::runtime_error);
+    }
+
+    SECTION("text data is rejected")
+    {
+        const auto text = std::string {"# a comment in a text worldline file\n0\n3\n2\n3\n"};
+        REQUIRE_THROWS_AS(worldline::parse_binary_worldline_header(text), std::runtime_error);
+    }
+}
+
+TEST_CASE("binary worldline files", "[BinaryWorldlines]")
+{
+    namespace fs = std::filesystem;
+
+    const auto worldlines = example_worldlines();
+    const auto test_dirpath = binary_worldlines_test_dirpath();
+
+    SECTION("writer and reader recognize the format")
+    {
+        const auto writer = worldline::WorldlineWriter<double, 3> {
+            test_dirpath, "worldline", ".dat", worldline::WorldlineFileFormat::BINARY
+        };
+        writer.write(7, worldlines);
+
+        const auto filepath = writer.output_filepath(7);
+        REQUIRE(worldline::is_binary_worldline_file(filepath));
+        REQUIRE(exactly_equal(worldlines, worldline::read_worldlines<double, 3>(filepath)));
+
+        SECTION("mapped view")
+        {
+            const auto mapped = worldline::MappedWorldlines<double, 3> {filepath};
+            REQUIRE(mapped.block_index() == 7);
+            REQUIRE(mapped.n_timeslices() == 3);
+            REQUIRE(mapped.n_worldlines() == 2);
+
+            for (std::size_t i_tslice {0}; i_tslice < 3; ++i_tslice) {
+                const auto timeslice = mapped.timeslice(i_tslice);
+                REQUIRE(timeslice.size() == 2);
+                for (std::size_t i_part {0}; i_part < 2; ++i_part) {
+                    REQUIRE(timeslice[i_part].coordinates() == worldlines.get(i_tslice, i_part).coordinates());
+                }
+            }
+
+            REQUIRE(exactly_equal(worldlines, mapped.to_worldlines()));
+        }
+
+        SECTION("mapped view requires the same precision")
+        {
+            REQUIRE_THROWS_AS((worldline::MappedWorldlines<float, 3> {filepath}), std::runtime_error);
+            REQUIRE(worldline::read_worldlines<float, 3>(filepath).n_timeslices() == 3);
+        }
+
+        fs::remove(filepath);
+    }
+
+    SECTION("text files are converted in place")
+    {
+        const auto writer = worldline::WorldlineWriter<double, 3> {test_dirpath};
+        writer.write(3, worldlines);
+
+        const auto filepath = writer.output_filepath(3);
+        REQUIRE(!worldline::is_binary_worldline_file(filepath));
+        const auto from_text = worldline::read_worldlines<double, 3>(filepath);
+
+        worldline::convert_text_worldlines_to_binary<double, 3>(filepath, filepath);
+
+        REQUIRE(worldline::is_binary_worldline_file(filepath));
+        REQUIRE(worldline::MappedWorldlines<double, 3> {filepath}.block_index() == 3);
+        REQUIRE(exactly_equal(from_text, worldline::read_worldlines<double, 3>(filepath)));
+
+        fs::remove(filepath);
+    }
+}
+
+TEST_CASE("DeltaBitpack codec", "[BinaryWorldlines]")
+{
+    using Codec = worldline::WorldlineCodec;
+
+    SECTION("random walks round trip exactly, and compress")
+    {
+        const auto worldlines_double = random_walk_worldlines<double>(64, 32);
+        const auto worldlines_float = random_walk_worldlines<float>(64, 32);
+
+        auto raw_double = std::stringstream {};
+        auto encoded_double = std::stringstream {};
+        worldline::write_binary_worldlines(raw_double, 0, worldlines_double, Codec::RAW);
+        worldline::write_binary_worldlines(encoded_double, 0, worldlines_double, Codec::DELTA_BITPACK);
+
+        auto raw_float = std::stringstream {};
+        auto encoded_float = std::stringstream {};
+        worldline::write_binary_worldlines(raw_float, 0, worldlines_float, Codec::RAW);
+        worldline::write_binary_worldlines(encoded_float, 0, worldlines_float, Codec::DELTA_BITPACK);
+
+        const auto contents_double = encoded_double.str();
+        const auto contents_float = encoded_float.str();
+
+        REQUIRE(contents_double.size() < raw_double.str().size());
+        REQUIRE(contents_float.size() < raw_float.str().size());
+
+        const auto bytes_double = std::span<const char> {contents_double};
+        const auto bytes_float = std::span<const char> {contents_float};
+        const auto decoded_double = worldline::read_binary_worldlines<double, 3>(bytes_double);
+        const auto decoded_float = worldline::read_binary_worldlines<float, 3>(bytes_float);
+
+        REQUIRE(exactly_equal_bits(worldlines_double, decoded_double));
+        REQUIRE(exactly_equal_bits(worldlines_float, decoded_float));
+    }
+
+    SECTION("special values round trip exactly")
+    {
+        using Point = coord::Cartesian<double, 3>;
+        using limits = std::numeric_limits<double>;
+
+        auto worldlines = worldline::Worldlines<double, 3> {4, 2};
+        worldlines.set(0, 0, Point {0.0, -0.0, limits::denorm_min()});
+        worldlines.set(0, 1, Point {limits::infinity(), -limits::infinity(), limits::quiet_NaN()});
+        worldlines.set(1, 0, Point {limits::max(), limits::lowest(), limits::min()});
+        worldlines.set(1, 1, Point {limits::infinity(), -limits::infinity(), limits::quiet_NaN()});
+        worldlines.set(2, 0, Point {1.0, -1.0, 1.0});
+        worldlines.set(2, 1, Point {std::nextafter(1.0, 2.0), 1.0, -0.0});
+        worldlines.set(3, 0, Point {1.0, -1.0, 1.0});
+        worldlines.set(3, 1, Point {0.0, 0.0, 0.0});
+
+        auto stream = std::stringstream {};
+        worldline::write_binary_worldlines(stream, 0, worldlines, Codec::DELTA_BITPACK);
+        const auto contents = stream.str();
+
+        const auto decoded = worldline::read_binary_worldlines<double, 3>(std::span<const char> {contents});
+        REQUIRE(exactly_equal_bits(worldlines, decoded));
+    }
+
+    SECTION("streaming encoder and decoder")
+    {
+        const auto timeslices = std::vector<std::vector<double>> {
+            {1.0,  2.0, 3.0 },
+            {1.0,  2.5, 3.25},
+            {-1.0, 2.5, 3.0 },
+        };
+
+        auto stream = std::stringstream {};
+        auto encoder = worldline::DeltaBitpackEncoder<double> {3, stream};
+        for (const auto& timeslice : timeslices) {
+            encoder.encode_timeslice(timeslice);
+        }
+        encoder.finish();
+
+        REQUIRE_THROWS_AS(encoder.encode_timeslice(std::vector<double> {1.0, 2.0}), std::runtime_error);
+
+        const auto contents = stream.str();
+        auto decoder = worldline::DeltaBitpackDecoder<double> {3, std::span<const char> {contents}};
+        auto values = std::vector<double>(3);
+        for (const auto& timeslice : timeslices) {
+            decoder.decode_timeslice(values);
+            REQUIRE(values == timeslice);
+        }
+        REQUIRE(decoder.n_bytes_read() == contents.size());
+    }
+
+    SECTION("truncated data is rejected")
+    {
+        const auto worldlines = random_walk_worldlines<double>(8, 4);
+
+        auto stream = std::stringstream {};
+        worldline::write_binary_worldlines(stream, 0, worldlines, Codec::DELTA_BITPACK);
+        const auto contents = stream.str();
+
+        const auto truncated = std::span<const char> {contents}.first(contents.size() - 8);
+        REQUIRE_THROWS_AS((worldline::read_binary_worldlines<double, 3>(truncated)), std::runtime_error);
+    }
+
+    SECTION("compressed files are not viewed in place")
+    {
+        const auto writer = worldline::WorldlineWriter<double, 3> {
+            binary_worldlines_test_dirpath(), "worldline", ".dat", worldline::WorldlineFileFormat::COMPRESSED_BINARY
+        };
+        const auto worldlines = random_walk_worldlines<double>(8, 4);
+        writer.write(1, worldlines);
+
+        const auto filepath = writer.output_filepath(1);
+        REQUIRE(exactly_equal_bits(worldlines, worldline::read_worldlines<double, 3>(filepath)));
+        REQUIRE_THROWS_AS((worldline::MappedWorldlines<double, 3> {filepath}), std::runtime_error);
+
+        std::filesystem::remove(filepath);
+    }
+}
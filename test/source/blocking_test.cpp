@@ -0,0 +1,179 @@
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "mathtools/statistics/blocking.hpp"
+
+namespace
+{
+
+// values from an AR(1) process, whose autocorrelation time is (1 + phi) / (1 - phi)
+auto autoregressive_values(double phi, std::size_t n_values, unsigned int seed) -> std::vector<double>
+{
+    auto prng = std::mt19937 {seed};
+    auto normal = std::normal_distribution<double> {0.0, 1.0};
+
+    auto values = std::vector<double> {};
+    auto value = double {0.0};
+    for (std::size_t i {0}; i < n_values; ++i) {
+        value = phi * value + normal(prng);
+        values.push_back(100.0 + value);
+    }
+
+    return values;
+}
+
+auto naive_standard_error(const std::vector<double>& values) -> double
+{
+    auto mean = double {0.0};
+    for (const auto value : values) {
+        mean += value;
+    }
+    mean /= static_cast<double>(values.size());
+
+    auto sum_squared_deviations = double {0.0};
+    for (const auto value : values) {
+        sum_squared_deviations += (value - mean) * (value - mean);
+    }
+
+    const auto n_values = static_cast<double>(values.size());
+    return std::sqrt(sum_squared_deviations / (n_values - 1.0) / n_values);
+}
+
+}  // namespace
+
+TEST_CASE("StreamingBlockingAnalysis levels", "[StreamingBlockingAnalysis]")
+{
+    const auto values = autoregressive_values(0.5, 64, 7);
+
+    auto analysis = mathtools::StreamingBlockingAnalysis<double> {};
+    for (const auto value : values) {
+        analysis.add(value);
+    }
+
+    SECTION("each level holds half as many values as the one before")
+    {
+        REQUIRE(analysis.n_samples() == 64);
+        REQUIRE(analysis.levels().size() == 7);
+        for (std::size_t i_level {0}; i_level < analysis.levels().size(); ++i_level) {
+            REQUIRE(analysis.levels()[i_level].n_values == (std::size_t {64} >> i_level));
+        }
+    }
+
+    SECTION("the errors match those calculated from the pairwise averages directly")
+    {
+        auto blocked = values;
+        for (std::size_t i_level {0}; i_level < 4; ++i_level) {
+            const auto expected = naive_standard_error(blocked);
+            REQUIRE_THAT(analysis.level_standard_error(i_level), Catch::Matchers::WithinRel(expected, 1.0e-10));
+
+            auto next_blocked = std::vector<double> {};
+            for (std::size_t i {0}; i + 1 < blocked.size(); i += 2) {
+                next_blocked.push_back(0.5 * (blocked[i] + blocked[i + 1]));
+            }
+            blocked = next_blocked;
+        }
+    }
+
+    SECTION("an analysis restored from the levels continues the same way")
+    {
+        auto restored = mathtools::StreamingBlockingAnalysis<double> {analysis.levels()};
+
+        const auto more_values = autoregressive_values(0.5, 37, 8);
+        for (const auto value : more_values) {
+            analysis.add(value);
+            restored.add(value);
+        }
+
+        const auto original_estimate = analysis.estimate();
+        const auto restored_estimate = restored.estimate();
+        REQUIRE(restored_estimate.n_samples == original_estimate.n_samples);
+        REQUIRE(restored_estimate.mean == original_estimate.mean);
+        REQUIRE(restored_estimate.standard_error == original_estimate.standard_error);
+    }
+}
+
+TEST_CASE("StreamingBlockingAnalysis estimate", "[StreamingBlockingAnalysis]")
+{
+    const auto estimate_of = [](const std::vector<double>& values) {
+        auto analysis = mathtools::StreamingBlockingAnalysis<double> {};
+        for (const auto value : values) {
+            analysis.add(value);
+        }
+
+        return analysis.estimate();
+    };
+
+    SECTION("uncorrelated values have an autocorrelation time near 1")
+    {
+        const auto estimate = estimate_of(autoregressive_values(0.0, 1 << 14, 11));
+
+        REQUIRE(estimate.is_converged);
+        REQUIRE(estimate.autocorrelation_time > 0.7);
+        REQUIRE(estimate.autocorrelation_time < 1.5);
+        REQUIRE_THAT(estimate.mean, Catch::Matchers::WithinAbs(100.0, 0.05));
+    }
+
+    SECTION("correlated values have the autocorrelation time of the process")
+    {
+        const auto phi = 0.8;
+        const auto expected_autocorrelation_time = (1.0 + phi) / (1.0 - phi);
+        const auto n_values = std::size_t {1 << 16};
+
+        const auto estimate = estimate_of(autoregressive_values(phi, n_values, 13));
+
+        REQUIRE(estimate.is_converged);
+        REQUIRE(estimate.autocorrelation_time > 0.7 * expected_autocorrelation_time);
+        REQUIRE(estimate.autocorrelation_time < 1.3 * expected_autocorrelation_time);
+        REQUIRE_THAT(
+            estimate.effective_sample_size,
+            Catch::Matchers::WithinRel(static_cast<double>(n_values) / estimate.autocorrelation_time)
+        );
+    }
+
+    SECTION("too few values for a plateau are not converged")
+    {
+        const auto estimate = estimate_of(autoregressive_values(0.8, 20, 17));
+
+        REQUIRE(estimate.n_samples == 20);
+        REQUIRE(!estimate.is_converged);
+        REQUIRE(std::isfinite(estimate.standard_error));
+    }
+
+    SECTION("short correlated runs are not converged, even when their levels happen to look flat")
+    {
+        // with tau = 9, a few hundred values are too few to show the plateau, wherever the noise puts the levels
+        const auto n_values = GENERATE(std::size_t {128}, std::size_t {512});
+
+        for (unsigned int seed {0}; seed < 20; ++seed) {
+            const auto estimate = estimate_of(autoregressive_values(0.8, n_values, seed));
+
+            REQUIRE(estimate.n_samples == n_values);
+            REQUIRE(!estimate.is_converged);
+        }
+    }
+
+    SECTION("a single value has a mean but no error")
+    {
+        const auto estimate = estimate_of({3.0});
+
+        REQUIRE(estimate.mean == 3.0);
+        REQUIRE(std::isnan(estimate.standard_error));
+        REQUIRE(!estimate.is_converged);
+    }
+
+    SECTION("constant values have no error")
+    {
+        const auto estimate = estimate_of(std::vector<double>(100, 2.5));
+
+        REQUIRE(estimate.standard_error == 0.0);
+        REQUIRE(estimate.autocorrelation_time == 1.0);
+        REQUIRE(estimate.effective_sample_size == 100.0);
+        REQUIRE(estimate.is_converged);
+    }
+}
@@ -1,5 +1,6 @@
 #include <cstddef>
 #include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -324,10 +325,94 @@ TEST_CASE("BlockValueWriter")
         if (fs::exists(test_dirpath)) {
             try {
                 fs::remove(abs_filepath);
+                fs::remove(fs::path {abs_filepath} += cw::DEFAULT_COMMITTED_LENGTH_SUFFIX);
             } catch (const fs::filesystem_error& error) {
                 INFO("Failed to delete output file for 'single_value_example0'");
                 REQUIRE(false);
             }
         }
     }
+
+    SECTION("incomplete lines from an interrupted write are discarded")
+    {
+        const auto filename = "test_interrupted_write.txt";
+        const auto rel_dirpath = fs::path{"test"} / "test_io";
+        const auto abs_dirpath = test_utils::resolve_project_path(rel_dirpath);
+
+        const auto test_dirpath = abs_dirpath / "buffered_writer_interrupted_write";
+        if (!fs::exists(test_dirpath)) {
+            fs::create_directory(test_dirpath);
+        }
+
+        const auto abs_filepath = test_dirpath / filename;
+        const auto committed_length_filepath = fs::path {abs_filepath} += cw::DEFAULT_COMMITTED_LENGTH_SUFFIX;
+        const auto header = std::string {"# dummy header\n"};
+
+        {
+            auto writer = cw::BlockValueWriter<int> {abs_filepath, header, default_format_info1()};
+            writer.accumulate({0, 101});
+            writer.write_and_clear();
+        }
+
+        CHECK(fs::exists(committed_length_filepath));
+
+        // pretend that the program was stopped partway through appending a line
+        {
+            auto out_stream = std::ofstream {abs_filepath, std::ios::app};
+            out_stream << "00001   ";
+        }
+
+        // a new writer for the same file, as happens when a simulation is continued
+        auto writer = cw::BlockValueWriter<int> {abs_filepath, header, default_format_info1()};
+        writer.accumulate({1, 202});
+        writer.write_and_clear();
+
+        const auto expected_contents = std::vector<std::string> {
+            std::string{"# dummy header"},
+            std::string{"00000"} + "   " + "  101",
+            std::string{"00001"} + "   " + "  202"
+        };
+
+        check_file_contents(abs_filepath, expected_contents);
+
+        fs::remove(abs_filepath);
+        fs::remove(committed_length_filepath);
+    }
+
+    SECTION("existing files without a committed length are kept whole")
+    {
+        const auto filename = "test_existing_file.txt";
+        const auto rel_dirpath = fs::path{"test"} / "test_io";
+        const auto abs_dirpath = test_utils::resolve_project_path(rel_dirpath);
+
+        const auto test_dirpath = abs_dirpath / "buffered_writer_existing_file";
+        if (!fs::exists(test_dirpath)) {
+            fs::create_directory(test_dirpath);
+        }
+
+        const auto abs_filepath = test_dirpath / filename;
+        const auto committed_length_filepath = fs::path {abs_filepath} += cw::DEFAULT_COMMITTED_LENGTH_SUFFIX;
+
+        {
+            auto out_stream = std::ofstream {abs_filepath};
+            out_stream << "# dummy header\n";
+            out_stream << "00000   " << "  101\n";
+        }
+
+        auto writer = cw::BlockValueWriter<int> {abs_filepath, "# dummy header\n", default_format_info1()};
+        writer.accumulate({1, 202});
+        writer.write_and_clear();
+
+        const auto expected_contents = std::vector<std::string> {
+            std::string{"# dummy header"},
+            std::string{"00000"} + "   " + "  101",
+            std::string{"00001"} + "   " + "  202"
+        };
+
+        check_file_contents(abs_filepath, expected_contents);
+        CHECK(fs::exists(committed_length_filepath));
+
+        fs::remove(abs_filepath);
+        fs::remove(committed_length_filepath);
+    }
 }
@@ -4,9 +4,11 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
+#include "coordinates/attard/four_body.hpp"
 #include "coordinates/cartesian.hpp"
 #include "interactions/handlers/composite_interaction_handler.hpp"
 #include "interactions/handlers/full_interaction_handler.hpp"
+#include "interactions/handlers/nearest_neighbour_interaction_handler.hpp"
 #include "interactions/three_body/axilrod_teller_muto.hpp"
 #include "interactions/three_body/three_body_pointwise_wrapper.hpp"
 #include "interactions/two_body/two_body_pointwise.hpp"
@@ -128,3 +130,99 @@ TEST_CASE("test composite full handler : square", "CompositeFullInteractionHandl
     REQUIRE_THAT(actual, Catch::Matchers::WithinRel(expected_direct));
     REQUIRE_THAT(actual, Catch::Matchers::WithinRel(expected_sep_handlers));
 }
+
+/*
+    A stand-in for the buffered four-body potential, where the energy of a sample is the sum of its side
+    lengths; it also counts how many times the buffer is evaluated.
+*/
+struct SumOfSidesQuadrupletPotential
+{
+    void add_sample(const coord::FourBodySideLengths<float>& sides)
+    {
+        add_sample(sides, 1.0f);
+    }
+
+    void add_sample(const coord::FourBodySideLengths<float>& sides, float weight)
+    {
+        const auto energy = sides.dist01 + sides.dist02 + sides.dist03 + sides.dist12 + sides.dist13 + sides.dist23;
+        total_energy += weight * energy;
+    }
+
+    auto extract_energy() -> float
+    {
+        ++n_extractions;
+
+        const auto energy = total_energy;
+        total_energy = 0.0f;
+
+        return energy;
+    }
+
+    float total_energy {};
+    std::size_t n_extractions {};
+};
+
+TEST_CASE(
+    "test composite nearest neighbour handler : batched worldline energy",
+    "CompositeNearestNeighbourInteractionHandler"
+)
+{
+    const auto points = square_points(1.0f);
+    const auto n_timeslices = std::size_t {3};
+    const auto n_particles = points.size();
+    auto worldlines = worldline::worldlines_from_positions<float, 3>(points, n_timeslices);
+
+    auto pairpot = interact::LennardJonesPotential {1.0f, 2.0f};
+    auto pairpot_wrapper = interact::TwoBodyPointPotential<decltype(pairpot), float, 3> {pairpot};
+    using PairType = interact::NearestNeighbourPairInteractionHandler<decltype(pairpot_wrapper), float, 3>;
+    using QuadrupletPot = SumOfSidesQuadrupletPotential;
+    using QuadrupletType = interact::NearestNeighbourQuadrupletInteractionHandler<QuadrupletPot, float, 3>;
+
+    auto handler = interact::CompositeNearestNeighbourInteractionHandler<float, 3, PairType, QuadrupletType> {
+        PairType {pairpot_wrapper, n_particles},
+        QuadrupletType {QuadrupletPot {}, n_particles}
+    };
+
+    for (std::size_t ip0 {0}; ip0 < n_particles; ++ip0) {
+        for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles; ++ip1) {
+            handler.adjacency_matrix<0>().add_neighbour_both(ip0, ip1);
+            handler.adjacency_matrix<1>().add_neighbour_both(ip0, ip1);
+        }
+    }
+
+    auto expected = 0.0f;
+    for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+        expected += handler(i_tslice, 0, worldlines);
+    }
+
+    auto& quadruplet_pot = handler.get<1>().point_potential();
+    quadruplet_pot.n_extractions = 0;
+
+    SECTION("sum over all timeslices")
+    {
+        handler.add_worldline_energy(0, worldlines, 1.0f);
+        const auto actual = handler.extract_energy();
+
+        REQUIRE_THAT(actual, Catch::Matchers::WithinRel(expected, 1.0e-5f));
+        REQUIRE(quadruplet_pot.n_extractions == 1);
+    }
+
+    SECTION("difference between two configurations is evaluated together")
+    {
+        handler.add_worldline_energy(0, worldlines, -1.0f);
+        for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+            const auto point = worldlines.get(i_tslice, 0);
+            worldlines.set(i_tslice, 0, point + Point3D {0.1f, 0.0f, 0.0f});
+        }
+        handler.add_worldline_energy(0, worldlines, 1.0f);
+        const auto actual_diff = handler.extract_energy();
+
+        auto after = 0.0f;
+        for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+            after += handler(i_tslice, 0, worldlines);
+        }
+
+        REQUIRE_THAT(actual_diff, Catch::Matchers::WithinRel(after - expected, 1.0e-5f));
+        REQUIRE(quadruplet_pot.n_extractions == 1 + n_timeslices);
+    }
+}
@@ -1,8 +1,23 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <span>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "common/binary_io.hpp"
+#include "coordinates/cartesian.hpp"
+#include "mathtools/histogram/histogram.hpp"
+#include "mathtools/statistics/blocking.hpp"
+#include "pimc/bisection_level_move_info.hpp"
 #include "simulation/continue.hpp"
+#include "worldline/worldline.hpp"
 
 TEST_CASE("basic continue file manager", "[ContinueFileManager]")
 {
@@ -21,3 +36,205 @@ TEST_CASE("basic continue file manager", "[ContinueFileManager]")
     REQUIRE(recovered.is_at_least_one_worldline_index_saved == worldline_saved_state);
     REQUIRE(recovered.is_equilibration_complete == equilibration_state);
 }
+
+namespace
+{
+
+auto example_checkpoint() -> sim::SimulationCheckpoint<double, 3>
+{
+    using Point = coord::Cartesian<double, 3>;
+
+    auto worldlines = worldline::Worldlines<double, 3> {2, 2};
+    worldlines.set(0, 0, Point {0.1, 0.2, 0.3});
+    worldlines.set(0, 1, Point {1.1, 1.2, 1.3});
+    worldlines.set(1, 0, Point {0.15, 0.25, 0.35});
+    worldlines.set(1, 1, Point {1.0 / 3.0, 1.25, -1.35});
+
+    auto prng = std::mt19937 {42};
+    prng.discard(1000);
+
+    auto histogram = mathtools::Histogram<double> {0.0, 5.0, 4};
+    histogram.add(0.5);
+    histogram.add(4.5, 3);
+
+    const auto other_histogram =
+        mathtools::Histogram<double> {1.0, 2.0, std::vector<std::uint64_t> {7, 8}, mathtools::OutOfRangePolicy::THROW};
+
+    auto statistics = mathtools::StreamingBlockingAnalysis<double> {};
+    for (const auto value : {1.5, 2.5, 2.0, 1.0, 3.5}) {
+        statistics.add(value);
+    }
+
+    return sim::SimulationCheckpoint<double, 3> {
+        sim::SimulationContinueInfo {12, 10, true, true},
+        std::move(worldlines),
+        prng,
+        {histogram, other_histogram},
+        0.0625,
+        pimc::BisectionLevelMoveInfo<double> {0.375, 3},
+        {statistics, mathtools::StreamingBlockingAnalysis<double> {}}
+    };
+}
+
+/*
+    Overwrite a uint32 or uint64 field in the payload of a serialized checkpoint, and update the checksum
+    to match, so that the damage is only caught by the checks on the field itself.
+*/
+template <typename T>
+auto with_payload_field(std::string contents, std::size_t payload_offset, T value) -> std::string
+{
+    // the header is the magic sequence, the version, the width of the floating-point type, the size of the
+    // payload, and the checksum of the payload
+    constexpr auto checksum_offset = std::size_t {8 + 4 + 4 + 8};
+    constexpr auto payload_start = checksum_offset + 8;
+
+    std::memcpy(contents.data() + payload_start + payload_offset, &value, sizeof(T));
+
+    const auto payload = std::span<const char> {contents}.subspan(payload_start);
+    const auto checksum = common::io::fnv1a_64(payload);
+    std::memcpy(contents.data() + checksum_offset, &checksum, sizeof(checksum));
+
+    return contents;
+}
+
+// where the fields of the first histogram start in the payload of a serialized checkpoint of doubles
+auto first_histogram_payload_offset(const std::string& contents) -> std::size_t
+{
+    // the continue info, followed by the step sizes, the bisection level, and the size of the PRNG state
+    constexpr auto prng_size_offset = std::size_t {8 + 8 + 1 + 1 + 8 + 8 + 8};
+    constexpr auto payload_start = std::size_t {8 + 4 + 4 + 8 + 8};
+
+    auto prng_size = std::uint64_t {};
+    std::memcpy(&prng_size, contents.data() + payload_start + prng_size_offset, sizeof(prng_size));
+
+    // skip past the PRNG state and the number of histograms
+    return prng_size_offset + 8 + static_cast<std::size_t>(prng_size) + 8;
+}
+
+}  // namespace
+
+TEST_CASE("checkpoint round trip", "[ContinueFileManager]")
+{
+    const auto original = example_checkpoint();
+
+    auto stream = std::stringstream {};
+    sim::serialize_checkpoint(stream, original);
+    const auto contents = stream.str();
+
+    SECTION("every part of the state is restored")
+    {
+        auto recovered = sim::deserialize_checkpoint<double, 3>(std::span<const char> {contents});
+
+        REQUIRE(recovered.info.most_recent_block_index == 12);
+        REQUIRE(recovered.info.most_recent_saved_worldline_index == 10);
+        REQUIRE(recovered.info.is_at_least_one_worldline_index_saved);
+        REQUIRE(recovered.info.is_equilibration_complete);
+
+        REQUIRE(recovered.centre_of_mass_step_size == 0.0625);
+        REQUIRE(recovered.bisection_move_info.upper_level_frac == 0.375);
+        REQUIRE(recovered.bisection_move_info.lower_level == 3);
+
+        // the restored PRNG continues the same sequence
+        auto original_prng = original.prng;
+        REQUIRE(recovered.prng == original_prng);
+        REQUIRE(recovered.prng() == original_prng());
+
+        REQUIRE(recovered.histograms.size() == 2);
+        REQUIRE(recovered.histograms[0].bins() == original.histograms[0].bins());
+        REQUIRE(recovered.histograms[0].min() == 0.0);
+        REQUIRE(recovered.histograms[0].max() == 5.0);
+        REQUIRE(recovered.histograms[1].bins() == original.histograms[1].bins());
+        REQUIRE(recovered.histograms[1].policy() == mathtools::OutOfRangePolicy::THROW);
+
+        for (std::size_t i_tslice {0}; i_tslice < 2; ++i_tslice) {
+            for (std::size_t i_part {0}; i_part < 2; ++i_part) {
+                const auto expected = original.worldlines.get(i_tslice, i_part).coordinates();
+                REQUIRE(recovered.worldlines.get(i_tslice, i_part).coordinates() == expected);
+            }
+        }
+
+        REQUIRE(recovered.estimator_statistics.size() == 2);
+        REQUIRE(recovered.estimator_statistics[1].n_samples() == 0);
+
+        const auto& original_levels = original.estimator_statistics[0].levels();
+        const auto& recovered_levels = recovered.estimator_statistics[0].levels();
+        REQUIRE(recovered_levels.size() == original_levels.size());
+        for (std::size_t i_level {0}; i_level < original_levels.size(); ++i_level) {
+            const auto& original_level = original_levels[i_level];
+            const auto& recovered_level = recovered_levels[i_level];
+            REQUIRE(recovered_level.n_values == original_level.n_values);
+            REQUIRE(recovered_level.mean == original_level.mean);
+            REQUIRE(recovered_level.sum_squared_deviations == original_level.sum_squared_deviations);
+            REQUIRE(recovered_level.has_unpaired_value == original_level.has_unpaired_value);
+            REQUIRE(recovered_level.unpaired_value == original_level.unpaired_value);
+        }
+    }
+
+    SECTION("damaged contents are rejected")
+    {
+        auto damaged = contents;
+        damaged[damaged.size() / 2] ^= 0x01;
+        const auto bytes = std::span<const char> {damaged};
+        REQUIRE_THROWS_AS((sim::deserialize_checkpoint<double, 3>(bytes)), std::runtime_error);
+    }
+
+    SECTION("unreadable histograms are rejected, even with a matching checksum")
+    {
+        const auto histogram_offset = first_histogram_payload_offset(contents);
+
+        // the histogram fields are the minimum, the maximum, the out-of-range policy, and the number of bins
+        const auto policy_offset = histogram_offset + 16;
+        const auto n_bins_offset = policy_offset + 4;
+
+        REQUIRE(original.histograms[0].policy() == mathtools::OutOfRangePolicy::DO_NOTHING);
+        const auto valid = with_payload_field(contents, policy_offset, std::uint32_t {1});
+        const auto recovered = sim::deserialize_checkpoint<double, 3>(std::span<const char> {valid});
+        REQUIRE(recovered.histograms[0].policy() == mathtools::OutOfRangePolicy::THROW);
+
+        const auto unknown_policy = with_payload_field(contents, policy_offset, std::uint32_t {7});
+        REQUIRE_THROWS_AS(
+            (sim::deserialize_checkpoint<double, 3>(std::span<const char> {unknown_policy})), std::runtime_error
+        );
+
+        const auto too_many_bins = with_payload_field(contents, n_bins_offset, std::uint64_t {1} << 61);
+        REQUIRE_THROWS_AS(
+            (sim::deserialize_checkpoint<double, 3>(std::span<const char> {too_many_bins})), std::runtime_error
+        );
+    }
+
+    SECTION("truncated contents are rejected")
+    {
+        const auto truncated = std::span<const char> {contents}.first(contents.size() - 1);
+        REQUIRE_THROWS_AS((sim::deserialize_checkpoint<double, 3>(truncated)), std::runtime_error);
+    }
+
+    SECTION("a different precision is rejected")
+    {
+        const auto bytes = std::span<const char> {contents};
+        REQUIRE_THROWS_AS((sim::deserialize_checkpoint<float, 3>(bytes)), std::runtime_error);
+    }
+}
+
+TEST_CASE("continue file manager checkpoint file", "[ContinueFileManager]")
+{
+    namespace fs = std::filesystem;
+
+    const auto dirpath = fs::temp_directory_path() / "pimc_sim_continue_test";
+    fs::create_directories(dirpath);
+
+    auto manager = sim::ContinueFileManager {dirpath};
+    fs::remove(manager.checkpoint_filepath());
+    REQUIRE(!manager.checkpoint_exists());
+
+    manager.write_checkpoint(example_checkpoint());
+    REQUIRE(manager.checkpoint_exists());
+    REQUIRE(manager.is_continued());
+
+    auto other_manager = sim::ContinueFileManager {dirpath};
+    const auto recovered = other_manager.read_checkpoint<double, 3>();
+    REQUIRE(recovered.info.most_recent_block_index == 12);
+    REQUIRE(other_manager.get_info().most_recent_block_index == 12);
+    REQUIRE(recovered.worldlines.n_timeslices() == 2);
+
+    fs::remove_all(dirpath);
+}
@@ -1,3 +1,4 @@
+#include <array>
 #include <cmath>
 #include <concepts>
 #include <tuple>
@@ -7,6 +8,7 @@
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
 #include "coordinates/cartesian.hpp"
+#include "coordinates/measure.hpp"
 #include "interactions/four_body/constants.hpp"
 #include "interactions/four_body/dispersion_potential.hpp"
 
@@ -46,3 +48,32 @@ TEST_CASE("dispersion potential equality", "FourBodyDispersionPotential")
         REQUIRE_THAT(original_energy, Catch::Matchers::WithinRel(rescaled_energy));
     }
 }
+
+TEST_CASE("dispersion potential from side lengths", "FourBodyDispersionPotential")
+{
+    using Point = coord::Cartesian<double, 3>;
+
+    const auto bade_coeff = interact::constants4b::BADE_COEFF_AVTZ<double>;
+    const auto potential = interact::disp::FourBodyDispersionPotential<double, 3>(bade_coeff);
+
+    const auto points = GENERATE(
+        std::tuple {Point {0.0, 0.0, 0.0}, Point {3.0, 0.0, 0.0}, Point {0.0, 4.0, 0.0}, Point {0.0, 0.0, 5.0}},
+        std::tuple {Point {1.0, -2.0, 0.5}, Point {4.5, 1.0, -1.0}, Point {-2.0, 3.0, 2.0}, Point {0.5, 0.5, 6.0}},
+        std::tuple {Point {0.0, 0.0, 0.0}, Point {6.0, 0.0, 0.0}, Point {3.0, 5.0, 0.0}, Point {3.0, 1.5, 4.0}}
+    );
+
+    const auto& [p0, p1, p2, p3] = points;
+    const auto side_lengths = std::array<double, 6> {
+        coord::distance(p0, p1),
+        coord::distance(p0, p2),
+        coord::distance(p0, p3),
+        coord::distance(p1, p2),
+        coord::distance(p1, p3),
+        coord::distance(p2, p3),
+    };
+
+    const auto expected = potential(p0, p1, p2, p3);
+    const auto actual = potential(side_lengths);
+
+    REQUIRE_THAT(actual, Catch::Matchers::WithinRel(expected, 1.0e-10));
+}
@@ -0,0 +1,81 @@
+#include <stdexcept>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "coordinates/attard/four_body.hpp"
+#include "interactions/four_body/energy_cache.hpp"
+
+TEST_CASE("FourBodyEnergyCache key", "[FourBodyEnergyCache]")
+{
+    using SideLengths = coord::FourBodySideLengths<double>;
+
+    const auto cache = interact::FourBodyEnergyCache<double> {1.0e-3, 16};
+    const auto sides = SideLengths {3.0, 3.1, 3.2, 3.3, 3.4, 3.5};
+
+    SECTION("relabelling the particles gives the same key")
+    {
+        // swap particles 0 and 1: (01, 02, 03, 12, 13, 23) -> (10, 12, 13, 02, 03, 23)
+        const auto swapped = SideLengths {3.0, 3.3, 3.4, 3.1, 3.2, 3.5};
+        REQUIRE(cache.key(sides) == cache.key(swapped));
+    }
+
+    SECTION("side lengths within the same bin give the same key")
+    {
+        const auto nearby = SideLengths {3.0 + 1.0e-4, 3.1, 3.2, 3.3 - 1.0e-4, 3.4, 3.5};
+        REQUIRE(cache.key(sides) == cache.key(nearby));
+    }
+
+    SECTION("side lengths in different bins give different keys")
+    {
+        const auto distant = SideLengths {3.0 + 1.0e-2, 3.1, 3.2, 3.3, 3.4, 3.5};
+        REQUIRE(cache.key(sides) != cache.key(distant));
+    }
+}
+
+TEST_CASE("FourBodyEnergyCache lookup", "[FourBodyEnergyCache]")
+{
+    using SideLengths = coord::FourBodySideLengths<double>;
+
+    auto cache = interact::FourBodyEnergyCache<double> {1.0e-3, 2};
+    const auto key0 = cache.key(SideLengths {3.0, 3.0, 3.0, 3.0, 3.0, 3.0});
+    const auto key1 = cache.key(SideLengths {4.0, 4.0, 4.0, 4.0, 4.0, 4.0});
+    const auto key2 = cache.key(SideLengths {5.0, 5.0, 5.0, 5.0, 5.0, 5.0});
+
+    SECTION("hits and misses are counted")
+    {
+        REQUIRE(!cache.find(key0));
+        cache.insert(key0, -1.5);
+
+        const auto energy = cache.find(key0);
+        REQUIRE(energy);
+        REQUIRE(*energy == -1.5);
+
+        REQUIRE(cache.n_hits() == 1);
+        REQUIRE(cache.n_misses() == 1);
+
+        cache.reset_counters();
+        REQUIRE(cache.n_hits() == 0);
+        REQUIRE(cache.n_misses() == 0);
+    }
+
+    SECTION("least recently used entry is evicted")
+    {
+        cache.insert(key0, 1.0);
+        cache.insert(key1, 2.0);
+
+        // touching key0 makes key1 the least recently used entry
+        REQUIRE(cache.find(key0));
+        cache.insert(key2, 3.0);
+
+        REQUIRE(cache.size() == 2);
+        REQUIRE(cache.find(key0));
+        REQUIRE(!cache.find(key1));
+        REQUIRE(cache.find(key2));
+    }
+
+    SECTION("invalid construction")
+    {
+        REQUIRE_THROWS_AS(interact::FourBodyEnergyCache<double>(0.0, 2), std::runtime_error);
+        REQUIRE_THROWS_AS(interact::FourBodyEnergyCache<double>(1.0e-3, 0), std::runtime_error);
+    }
+}
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "simulation/hardware_counters.hpp"
+
+namespace
+{
+
+auto counts_with(std::initializer_list<std::pair<sim::HardwareEvent, std::uint64_t>> values) -> sim::HardwareCounts
+{
+    auto counts = sim::HardwareCounts {};
+    for (const auto& [event, value] : values) {
+        counts[static_cast<std::size_t>(event)] = value;
+    }
+
+    return counts;
+}
+
+}  // namespace
+
+TEST_CASE("HardwareCounterPhases derived metrics", "[HardwareCounterPhases]")
+{
+    using HE = sim::HardwareEvent;
+
+    SECTION("the metrics are ratios of the counts")
+    {
+        const auto counts = counts_with({
+            {HE::CYCLES,              1000},
+            {HE::INSTRUCTIONS,        2500},
+            {HE::L1D_READ_ACCESSES,   800 },
+            {HE::L1D_READ_MISSES,     40  },
+            {HE::LLC_REFERENCES,      20  },
+            {HE::LLC_MISSES,          5   },
+            {HE::BRANCH_INSTRUCTIONS, 400 },
+            {HE::BRANCH_MISSES,       4   }
+        });
+
+        const auto metrics = sim::HardwareCounterPhases::derived_metrics(counts);
+        REQUIRE(metrics[0] == 2.5);
+        REQUIRE(metrics[1] == 0.05);
+        REQUIRE(metrics[2] == 0.25);
+        REQUIRE(metrics[3] == 0.01);
+    }
+
+    SECTION("a metric is NaN if an event is missing or nothing was counted")
+    {
+        const auto counts = counts_with({
+            {HE::CYCLES,         0  },
+            {HE::INSTRUCTIONS,   100},
+            {HE::LLC_REFERENCES, 10 },
+            {HE::LLC_MISSES,     1  }
+        });
+
+        const auto metrics = sim::HardwareCounterPhases::derived_metrics(counts);
+        REQUIRE(std::isnan(metrics[0]));
+        REQUIRE(std::isnan(metrics[1]));
+        REQUIRE(metrics[2] == 0.1);
+        REQUIRE(std::isnan(metrics[3]));
+    }
+}
+
+TEST_CASE("HardwareCounterPhases accumulation", "[HardwareCounterPhases]")
+{
+    using HE = sim::HardwareEvent;
+    using Phase = sim::HardwareCounterPhase;
+
+    // the counters are never opened, so this works whether or not the machine allows them
+    auto phases = sim::HardwareCounterPhases {false};
+    REQUIRE(!phases.is_available());
+    REQUIRE(!phases.read()[0].has_value());
+
+    SECTION("the differences between readings are summed per phase")
+    {
+        phases.add(Phase::MOVES, counts_with({{HE::CYCLES, 100}, {HE::INSTRUCTIONS, 50}}),
+                   counts_with({{HE::CYCLES, 300}, {HE::INSTRUCTIONS, 450}}));
+        phases.add(Phase::MOVES, counts_with({{HE::CYCLES, 500}, {HE::INSTRUCTIONS, 500}}),
+                   counts_with({{HE::CYCLES, 700}, {HE::INSTRUCTIONS, 700}}));
+
+        const auto& totals = phases.totals(Phase::MOVES);
+        REQUIRE(totals[static_cast<std::size_t>(HE::CYCLES)] == 400);
+        REQUIRE(totals[static_cast<std::size_t>(HE::INSTRUCTIONS)] == 600);
+        REQUIRE(!totals[static_cast<std::size_t>(HE::LLC_MISSES)].has_value());
+        REQUIRE(!phases.totals(Phase::ESTIMATORS)[0].has_value());
+
+        const auto data = phases.block_data(3);
+        REQUIRE(std::tuple_size_v<decltype(data)> == 1 + sim::N_HARDWARE_METRICS * sim::N_HARDWARE_COUNTER_PHASES);
+        REQUIRE(std::get<0>(data) == 3);
+        REQUIRE(std::get<1>(data) == 1.5);
+        REQUIRE(std::isnan(std::get<2>(data)));
+        REQUIRE(std::isnan(std::get<5>(data)));
+
+        phases.reset();
+        REQUIRE(!phases.totals(Phase::MOVES)[0].has_value());
+    }
+
+    SECTION("a scope over unavailable counters adds nothing")
+    {
+        {
+            const auto scope = phases.scope(Phase::INPUT_OUTPUT);
+        }
+
+        REQUIRE(!phases.totals(Phase::INPUT_OUTPUT)[0].has_value());
+    }
+}
@@ -1,4 +1,5 @@
 #include <cstddef>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -67,6 +68,86 @@ TEST_CASE("basic histogram", "[Histogram]")
 
         REQUIRE(histogram.bins() == std::vector<std::uint64_t> {0, 0, 0, 0, 0});
     }
+
+    SECTION("does not throw for entries in bounds when setting the policy to throw")
+    {
+        auto histogram = mathtools::Histogram<double>(0.0, 1.0, 10, mathtools::OutOfRangePolicy::THROW);
+        REQUIRE(histogram.add(0.5));
+        REQUIRE(histogram.bins()[5] == 1);
+    }
+}
+
+TEST_CASE("add many entries to a histogram", "[Histogram]")
+{
+    SECTION("same bins as adding the entries one at a time")
+    {
+        auto values = std::vector<double> {};
+        for (std::size_t i {0}; i < 1000; ++i) {
+            // includes values outside the bounds, and values that land exactly on the bin edges
+            values.push_back(-0.1 + 0.0012 * static_cast<double>(i));
+        }
+        values.push_back(1.0);
+
+        auto one_at_a_time = mathtools::Histogram<double>(0.0, 1.0, 25);
+        auto n_expected = std::size_t {0};
+        for (auto value : values) {
+            n_expected += static_cast<std::size_t>(one_at_a_time.add(value));
+        }
+
+        auto all_at_once = mathtools::Histogram<double>(0.0, 1.0, 25);
+        const auto n_added = all_at_once.add_many(values);
+
+        REQUIRE(n_added == n_expected);
+        REQUIRE(all_at_once.bins() == one_at_a_time.bins());
+    }
+
+    SECTION("NaN is out of bounds for both ways of adding entries")
+    {
+        const auto nan = std::numeric_limits<double>::quiet_NaN();
+        const auto values = std::vector<double> {0.1, nan, 0.7, nan};
+
+        auto one_at_a_time = mathtools::Histogram<double>(0.0, 1.0, 5);
+        auto n_expected = std::size_t {0};
+        for (auto value : values) {
+            n_expected += static_cast<std::size_t>(one_at_a_time.add(value));
+        }
+
+        auto all_at_once = mathtools::Histogram<double>(0.0, 1.0, 5);
+        const auto n_added = all_at_once.add_many(values);
+
+        REQUIRE(n_expected == 2);
+        REQUIRE(n_added == n_expected);
+        REQUIRE(all_at_once.bins() == one_at_a_time.bins());
+        REQUIRE(one_at_a_time.bins() == std::vector<std::uint64_t> {1, 0, 0, 1, 0});
+
+        auto throwing = mathtools::Histogram<double>(0.0, 1.0, 5, mathtools::OutOfRangePolicy::THROW);
+        REQUIRE_THROWS_AS(throwing.add(nan), std::runtime_error);
+        REQUIRE_THROWS_AS(throwing.add_many(std::vector<double> {nan}), std::runtime_error);
+    }
+
+    SECTION("throws if any entry is out of bounds when setting the policy to throw")
+    {
+        auto histogram = mathtools::Histogram<double>(0.0, 1.0, 10, mathtools::OutOfRangePolicy::THROW);
+        const auto values = std::vector<double> {0.1, 0.2, 1.5};
+        REQUIRE_THROWS_AS(histogram.add_many(values), std::runtime_error);
+    }
+
+    SECTION("merge histograms")
+    {
+        auto histogram0 = mathtools::Histogram<double>(0.0, 1.0, 5);
+        histogram0.add(0.1);
+        histogram0.add(0.5);
+
+        auto histogram1 = mathtools::Histogram<double>(0.0, 1.0, 5);
+        histogram1.add(0.15);
+        histogram1.add(0.9);
+
+        histogram0.merge(histogram1);
+        REQUIRE(histogram0.bins() == std::vector<std::uint64_t> {2, 0, 1, 0, 1});
+
+        const auto incompatible = mathtools::Histogram<double>(0.0, 2.0, 5);
+        REQUIRE_THROWS_AS(histogram0.merge(incompatible), std::runtime_error);
+    }
 }
 
 TEST_CASE("write histogram", "[Histogram]")
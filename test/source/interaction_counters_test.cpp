@@ -0,0 +1,106 @@
+// the counters are compiled out unless this is defined
+#define PIMC_SIM_INTERACTION_COUNTERS
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/thread_pool.hpp"
+#include "coordinates/box_sides.hpp"
+#include "coordinates/cartesian.hpp"
+#include "interactions/interaction_counters.hpp"
+#include "interactions/three_body/three_body_parah2.hpp"
+#include "interactions/two_body/two_body_pointwise_wrapper.hpp"
+#include "mathtools/grid/grid3d.hpp"
+#include "mathtools/interpolate/trilinear_interp.hpp"
+
+namespace
+{
+
+struct InversePairPotential
+{
+    auto operator()(double dist) const noexcept -> double
+    {
+        return 1.0 / dist;
+    }
+};
+
+auto count_of(const interact::InteractionCounts& counts, interact::InteractionCounter counter) -> std::uint64_t
+{
+    return counts[static_cast<std::size_t>(counter)];
+}
+
+}  // namespace
+
+TEST_CASE("interaction counters", "[interaction_counters]")
+{
+    using IC = interact::InteractionCounter;
+    using Point = coord::Cartesian<double, 3>;
+
+    // start from zero, whatever other test cases have counted
+    interact::collect_interaction_counts();
+
+    SECTION("pair evaluations are counted, but not the pairs outside the box cutoff")
+    {
+        const auto box = coord::BoxSides<double, 3> {10.0, 10.0, 10.0};
+        const auto pot = interact::PeriodicTwoBodyPointPotential<InversePairPotential, double, 3> {{}, box};
+
+        const auto p0 = Point {0.0, 0.0, 0.0};
+        const auto p1 = Point {1.0, 0.0, 0.0};
+        const auto p2 = Point {4.9, 4.9, 4.9};
+
+        pot(p0, p1);
+        pot(p0, p2);
+        pot.within_box_cutoff(p0, p1);
+        pot.within_box_cutoff(p0, p2);
+
+        const auto counts = interact::collect_interaction_counts();
+        REQUIRE(count_of(counts, IC::PAIR_EVALUATIONS) == 3);
+        REQUIRE(count_of(counts, IC::TRIPLET_EVALUATIONS) == 0);
+
+        // collecting the counts resets them
+        REQUIRE(count_of(interact::collect_interaction_counts(), IC::PAIR_EVALUATIONS) == 0);
+    }
+
+    SECTION("the counts made on every thread are summed")
+    {
+        auto pool = common::ThreadPool {4};
+        pool.parallel_for(1000, [](std::size_t) { interact::count_interaction(IC::QUADRUPLET_LONG, 2); });
+
+        const auto counts = interact::collect_interaction_counts();
+        REQUIRE(count_of(counts, IC::QUADRUPLET_LONG) == 2000);
+    }
+
+    SECTION("three-body samples outside the grid fall back to the ATM potential")
+    {
+        auto grid = mathtools::Grid3D<double> {mathtools::Shape3D {2, 2, 2}};
+        const auto interpolator = mathtools::TrilinearInterpolator<double> {
+            std::move(grid),
+            mathtools_utils::AxisLimits {0.0, 100.0},
+            mathtools_utils::AxisLimits {0.0, 100.0},
+            mathtools_utils::AxisLimits {0.0, 1.0}
+        };
+        const auto pot = interact::ThreeBodyParaH2Potential<double> {interpolator, 1.0};
+
+        pot(3.0, 3.0, 3.0);
+        pot(3.0, 3.5, 4.0);
+        pot(500.0, 500.0, 500.0);
+
+        const auto counts = interact::collect_interaction_counts();
+        REQUIRE(count_of(counts, IC::THREE_BODY_ATM_FALLBACKS) == 1);
+    }
+
+    SECTION("the block data has one column per counter")
+    {
+        auto counts = interact::InteractionCounts {};
+        counts[static_cast<std::size_t>(IC::TRIPLET_EVALUATIONS)] = 17;
+
+        const auto data = interact::interaction_counts_block_data(5, counts);
+        REQUIRE(std::tuple_size_v<decltype(data)> == 1 + interact::N_INTERACTION_COUNTERS);
+        REQUIRE(std::get<0>(data) == 5);
+        REQUIRE(std::get<2>(data) == 17);
+    }
+}
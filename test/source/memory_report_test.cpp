@@ -0,0 +1,133 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/memory_usage.hpp"
+#include "coordinates/cartesian.hpp"
+#include "mathtools/grid/grid3d.hpp"
+#include "mathtools/grid/square_adjacency_matrix.hpp"
+#include "mathtools/histogram/histogram.hpp"
+#include "simulation/memory_report.hpp"
+#include "worldline/worldline.hpp"
+
+namespace
+{
+
+struct UntrackedObject
+{
+    double value {};
+};
+
+}  // namespace
+
+TEST_CASE("memory usage of the large objects", "[MemoryUsage]")
+{
+    SECTION("the worldlines hold every bead")
+    {
+        const auto worldlines = worldline::Worldlines<double, 3> {4, 5};
+        const auto usage = worldlines.memory_usage();
+
+        REQUIRE(usage.owned_bytes >= 4 * 5 * sizeof(coord::Cartesian<double, 3>));
+        REQUIRE(usage.shared_bytes == 0);
+    }
+
+    SECTION("an owned grid is not shared")
+    {
+        const auto grid = mathtools::Grid3D<float> {mathtools::Shape3D {2, 3, 4}};
+        const auto usage = grid.memory_usage();
+
+        REQUIRE(usage.owned_bytes == 2 * 3 * 4 * sizeof(float));
+        REQUIRE(usage.shared_bytes == 0);
+    }
+
+    SECTION("a grid over a shared block counts the block as shared")
+    {
+        const auto shared_data = std::shared_ptr<const float> {new float[24] {}, std::default_delete<float[]> {}};
+        const auto grid = mathtools::Grid3D<float> {shared_data, mathtools::Shape3D {2, 3, 4}};
+        const auto usage = grid.memory_usage();
+
+        REQUIRE(usage.owned_bytes == 0);
+        REQUIRE(usage.shared_bytes == 2 * 3 * 4 * sizeof(float));
+    }
+
+    SECTION("the adjacency matrix holds a row of indices for each particle")
+    {
+        const auto adjmat = mathtools::SquareAdjacencyMatrix {10};
+        REQUIRE(adjmat.memory_usage().owned_bytes >= 10 * 10 * sizeof(std::size_t));
+    }
+
+    SECTION("the histogram holds its bins")
+    {
+        const auto histogram = mathtools::Histogram<double> {0.0, 1.0, 100};
+        REQUIRE(histogram.memory_usage().owned_bytes == 100 * sizeof(std::uint64_t));
+    }
+
+    SECTION("an object that doesn't track its memory uses nothing")
+    {
+        REQUIRE(common::memory_usage(UntrackedObject {}) == common::MemoryUsage {});
+    }
+}
+
+TEST_CASE("MemoryReport", "[MemoryReport]")
+{
+    auto report = sim::MemoryReport {};
+    report.add("first", common::MemoryUsage {100, 0});
+    report.add("second", common::MemoryUsage {50, 1024});
+
+    SECTION("the total sums the entries")
+    {
+        REQUIRE(report.entries().size() == 2);
+        REQUIRE(report.total() == common::MemoryUsage {150, 1024});
+    }
+
+    SECTION("the printed report lists every entry and the resident set size")
+    {
+        auto output = std::stringstream {};
+        sim::print_memory_report(output, report, sim::ResidentSetSize {2 * 1024 * 1024, std::nullopt});
+
+        const auto text = output.str();
+        REQUIRE(text.find("first") != std::string::npos);
+        REQUIRE(text.find("second") != std::string::npos);
+        REQUIRE(text.find("shared") != std::string::npos);
+        REQUIRE(text.find("2.000 MiB") != std::string::npos);
+        REQUIRE(text.find("unavailable") != std::string::npos);
+    }
+}
+
+TEST_CASE("read_resident_set_size", "[MemoryReport]")
+{
+    SECTION("the sizes are read from the status file, in bytes")
+    {
+        auto status = std::stringstream {};
+        status << "Name:\tpimc-sim\n";
+        status << "VmPeak:\t  300000 kB\n";
+        status << "VmHWM:\t    2048 kB\n";
+        status << "VmRSS:\t    1024 kB\n";
+        status << "Threads:\t4\n";
+
+        const auto rss = sim::read_resident_set_size(status);
+
+        REQUIRE(rss.current_bytes == std::size_t {1024 * 1024});
+        REQUIRE(rss.peak_bytes == std::size_t {2048 * 1024});
+    }
+
+    SECTION("missing fields are left empty")
+    {
+        auto status = std::stringstream {"Name:\tpimc-sim\nThreads:\t4\n"};
+        const auto rss = sim::read_resident_set_size(status);
+
+        REQUIRE(!rss.current_bytes.has_value());
+        REQUIRE(!rss.peak_bytes.has_value());
+    }
+
+    SECTION("a missing status file leaves both sizes empty")
+    {
+        const auto rss = sim::read_resident_set_size("/nonexistent/status");
+
+        REQUIRE(!rss.current_bytes.has_value());
+        REQUIRE(!rss.peak_bytes.has_value());
+    }
+}
@@ -0,0 +1,105 @@
+#include <array>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "interactions/four_body/permutations.hpp"
+
+namespace
+{
+
+auto apply_exact_transformer(
+    const std::vector<float>& samples,
+    const impl_interact_trans::LessThanEpsilon<float>& comparator
+) -> std::vector<float>
+{
+    auto output = std::vector<float> {};
+    output.reserve(samples.size());
+
+    for (std::size_t i_sample {0}; i_sample < samples.size() / 6; ++i_sample) {
+        auto sample = std::array<float, 6> {};
+        for (std::size_t i {0}; i < 6; ++i) {
+            sample[i] = samples[6 * i_sample + i];
+        }
+
+        const auto minimum = interact::trans::minimum_permutation(sample, comparator);
+        output.insert(output.end(), minimum.begin(), minimum.end());
+    }
+
+    return output;
+}
+
+}  // namespace
+
+TEST_CASE("minimum_permutation", "[permutations]")
+{
+    const auto comparator = impl_interact_trans::LessThanEpsilon<float> {1.0e-4f};
+
+    SECTION("already sorted tetrahedron is unchanged")
+    {
+        const auto sample = std::array<float, 6> {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+        REQUIRE(interact::trans::minimum_permutation(sample, comparator) == sample);
+    }
+
+    SECTION("smallest side lengths are moved to the front")
+    {
+        // only 24 of the 720 orderings of the side lengths correspond to a relabelling of the four particles
+        const auto sample = std::array<float, 6> {6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f};
+        const auto expected = std::array<float, 6> {1.0f, 2.0f, 4.0f, 3.0f, 5.0f, 6.0f};
+        REQUIRE(interact::trans::minimum_permutation(sample, comparator) == expected);
+    }
+}
+
+TEST_CASE("BatchMinimumPermutationTransformer matches the exact transformer", "[permutations]")
+{
+    const auto comparator = impl_interact_trans::LessThanEpsilon<float> {1.0e-4f};
+    const auto batch_transformer = interact::trans::BatchMinimumPermutationTransformer<float> {comparator};
+
+    // the batch size is deliberately not a multiple of the chunk size used internally
+    const auto n_samples = std::size_t {1001};
+    auto prng = std::mt19937 {12345};
+
+    SECTION("uniformly distributed side lengths")
+    {
+        auto distrib = std::uniform_real_distribution<float> {0.5f, 1.0f};
+
+        auto samples = std::vector<float>(6 * n_samples);
+        for (auto& value : samples) {
+            value = distrib(prng);
+        }
+
+        const auto expected = apply_exact_transformer(samples, comparator);
+        batch_transformer(samples.data(), n_samples);
+
+        REQUIRE(samples == expected);
+    }
+
+    SECTION("side lengths with exact ties and ties within epsilon")
+    {
+        // few distinct values, each jittered by an amount comparable to epsilon, to exercise the tie-breaking
+        const auto distinct_values = std::array<float, 3> {0.6f, 0.8f, 1.0f};
+        auto index_distrib = std::uniform_int_distribution<std::size_t> {0, distinct_values.size() - 1};
+        auto jitter_distrib = std::uniform_int_distribution<int> {-2, 2};
+
+        auto samples = std::vector<float>(6 * n_samples);
+        for (auto& value : samples) {
+            const auto jitter = 6.0e-5f * static_cast<float>(jitter_distrib(prng));
+            value = distinct_values[index_distrib(prng)] + jitter;
+        }
+
+        const auto expected = apply_exact_transformer(samples, comparator);
+        batch_transformer(samples.data(), n_samples);
+
+        REQUIRE(samples == expected);
+    }
+
+    SECTION("empty batch")
+    {
+        auto samples = std::vector<float> {};
+        batch_transformer(samples.data(), 0);
+
+        REQUIRE(samples.empty());
+    }
+}
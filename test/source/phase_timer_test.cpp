@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstddef>
+#include <tuple>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "simulation/phase_timer.hpp"
+
+TEST_CASE("PhaseTimer", "[PhaseTimer]")
+{
+    using Phase = sim::SimulationPhase;
+
+    SECTION("an enabled timer accumulates time and calls per phase")
+    {
+        auto timer = sim::PhaseTimer<true> {};
+        timer.add(Phase::ESTIMATORS, std::chrono::milliseconds {250});
+        timer.add(Phase::ESTIMATORS, std::chrono::milliseconds {500});
+        timer.add(Phase::WRITER_FLUSHES, std::chrono::seconds {2});
+
+        {
+            const auto scope = timer.scope(Phase::BISECTION_MOVES);
+        }
+
+        REQUIRE(timer.seconds(Phase::ESTIMATORS) == 0.75);
+        REQUIRE(timer.n_calls(Phase::ESTIMATORS) == 2);
+        REQUIRE(timer.seconds(Phase::WRITER_FLUSHES) == 2.0);
+        REQUIRE(timer.n_calls(Phase::WRITER_FLUSHES) == 1);
+        REQUIRE(timer.n_calls(Phase::BISECTION_MOVES) == 1);
+        REQUIRE(timer.seconds(Phase::BISECTION_MOVES) >= 0.0);
+        REQUIRE(timer.n_calls(Phase::SINGLE_BEAD_MOVES) == 0);
+
+        const auto data = timer.block_data(12);
+        REQUIRE(std::tuple_size_v<decltype(data)> == 1 + 2 * sim::N_SIMULATION_PHASES);
+        REQUIRE(std::get<0>(data) == 12);
+
+        // the columns for each phase are its total time, then its number of calls
+        const auto i_estimators = 1 + 2 * static_cast<std::size_t>(Phase::ESTIMATORS);
+        REQUIRE(i_estimators == 7);
+        REQUIRE(std::get<7>(data) == 0.75);
+        REQUIRE(std::get<8>(data) == 2);
+
+        timer.reset();
+        REQUIRE(timer.seconds(Phase::ESTIMATORS) == 0.0);
+        REQUIRE(timer.n_calls(Phase::ESTIMATORS) == 0);
+    }
+
+    SECTION("a disabled timer records nothing")
+    {
+        auto timer = sim::PhaseTimer<false> {};
+        timer.add(Phase::ESTIMATORS, std::chrono::seconds {1});
+
+        {
+            const auto scope = timer.scope(Phase::ESTIMATORS);
+        }
+
+        REQUIRE(timer.seconds(Phase::ESTIMATORS) == 0.0);
+        REQUIRE(timer.n_calls(Phase::ESTIMATORS) == 0);
+    }
+}
@@ -0,0 +1,273 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "common/thread_pool.hpp"
+#include "coordinates/box_sides.hpp"
+#include "coordinates/cartesian.hpp"
+#include "coordinates/cell_list.hpp"
+#include "coordinates/measure.hpp"
+#include "coordinates/measure_wrappers.hpp"
+#include "estimators/pimc/radial_distribution_function.hpp"
+#include "estimators/pimc/three_body_potential.hpp"
+#include "estimators/pimc/two_body_potential.hpp"
+#include "interactions/three_body/three_body_pointwise_wrapper.hpp"
+#include "interactions/two_body/two_body_pointwise_wrapper.hpp"
+#include "mathtools/histogram/histogram.hpp"
+#include "mathtools/grid/square_adjacency_matrix.hpp"
+#include "worldline/worldline.hpp"
+
+namespace
+{
+
+using Point = coord::Cartesian<double, 3>;
+using Box = coord::BoxSides<double, 3>;
+
+struct InversePairPotential
+{
+    auto operator()(double dist) const noexcept -> double
+    {
+        return 1.0 / dist;
+    }
+};
+
+struct InverseProductTripletPotential
+{
+    auto operator()(double dist01, double dist02, double dist12) const noexcept -> double
+    {
+        return 1.0 / (dist01 * dist02 * dist12);
+    }
+};
+
+// only the triplets with every side length shorter than `cutoff` interact
+struct TruncatedInverseProductTripletPotential
+{
+    auto operator()(double dist01, double dist02, double dist12) const noexcept -> double
+    {
+        if (dist01 >= cutoff || dist02 >= cutoff || dist12 >= cutoff) {
+            return 0.0;
+        }
+
+        return 1.0 / (dist01 * dist02 * dist12);
+    }
+
+    double cutoff;
+};
+
+auto random_worldlines(std::size_t n_timeslices, std::size_t n_particles, const Box& box)
+    -> worldline::Worldlines<double, 3>
+{
+    auto prng = std::mt19937 {98765};
+    auto distrib = std::uniform_real_distribution<double> {0.0, 1.0};
+
+    auto worldlines = worldline::Worldlines<double, 3> {n_timeslices, n_particles};
+    for (std::size_t i_tslice {0}; i_tslice < n_timeslices; ++i_tslice) {
+        for (std::size_t i_part {0}; i_part < n_particles; ++i_part) {
+            const auto x = box[0] * distrib(prng);
+            const auto y = box[1] * distrib(prng);
+            const auto z = box[2] * distrib(prng);
+            worldlines.set(i_tslice, i_part, Point {x, y, z});
+        }
+    }
+
+    return worldlines;
+}
+
+}  // namespace
+
+TEST_CASE("ThreadPool", "[ThreadPool]")
+{
+    const auto n_threads = GENERATE(std::size_t {1}, std::size_t {2}, std::size_t {5});
+    auto pool = common::ThreadPool {n_threads};
+
+    REQUIRE(pool.n_threads() == n_threads);
+
+    SECTION("every item is visited exactly once, over repeated calls")
+    {
+        for (const auto n_items : std::array<std::size_t, 4> {0, 1, 3, 100}) {
+            auto visits = std::vector<int>(n_items, 0);
+            pool.parallel_for(n_items, [&](std::size_t i_item) { visits[i_item] += 1; });
+
+            REQUIRE(visits == std::vector<int>(n_items, 1));
+        }
+    }
+
+    SECTION("exceptions are rethrown on the calling thread")
+    {
+        const auto throw_on_seven = [](std::size_t i_item) {
+            if (i_item == 7) {
+                throw std::runtime_error {"seven"};
+            }
+        };
+
+        REQUIRE_THROWS_AS(pool.parallel_for(20, throw_on_seven), std::runtime_error);
+
+        // the pool is still usable afterwards
+        auto visits = std::vector<int>(20, 0);
+        pool.parallel_for(20, [&](std::size_t i_item) { visits[i_item] += 1; });
+        REQUIRE(visits == std::vector<int>(20, 1));
+    }
+
+    SECTION("calls with the same thread index never overlap")
+    {
+        auto is_busy = std::vector<std::atomic<bool>>(n_threads);
+        auto n_overlaps = std::atomic<int> {0};
+        auto visits = std::vector<int>(200, 0);
+
+        pool.parallel_for_with_thread_index(200, [&](std::size_t i_item, std::size_t i_thread) {
+            if (i_thread >= n_threads || is_busy[i_thread].exchange(true)) {
+                ++n_overlaps;
+                return;
+            }
+
+            visits[i_item] += 1;
+            is_busy[i_thread].store(false);
+        });
+
+        REQUIRE(n_overlaps.load() == 0);
+        REQUIRE(visits == std::vector<int>(200, 1));
+    }
+}
+
+TEST_CASE("threaded potential estimators match the serial estimators exactly", "[estimators]")
+{
+    const auto box = Box {6.0, 6.5, 7.0};
+    const auto worldlines = random_worldlines(9, 24, box);
+
+    const auto pair_pot = interact::PeriodicTwoBodyPointPotential<InversePairPotential, double, 3> {{}, box};
+    const auto triplet_pot =
+        interact::PeriodicThreeBodyPointPotential<InverseProductTripletPotential, double, 3> {{}, box};
+
+    const auto serial_pair = estim::total_pair_potential_energy_periodic(worldlines, pair_pot);
+    const auto serial_triplet = estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot);
+
+    const auto n_threads = GENERATE(std::size_t {1}, std::size_t {2}, std::size_t {3}, std::size_t {8});
+    auto pool = common::ThreadPool {n_threads};
+
+    // repeat a few times, since the order in which the timeslices are handed out varies between calls
+    for (std::size_t i_repeat {0}; i_repeat < 4; ++i_repeat) {
+        REQUIRE(estim::total_pair_potential_energy_periodic(worldlines, pair_pot, pool) == serial_pair);
+        REQUIRE(estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, pool) == serial_triplet);
+    }
+}
+
+TEST_CASE("triplet potential estimator using an adjacency matrix", "[estimators]")
+{
+    const auto box = Box {6.0, 6.5, 7.0};
+    const auto worldlines = random_worldlines(5, 20, box);
+    const auto n_particles = worldlines.n_worldlines();
+
+    const auto triplet_pot =
+        interact::PeriodicThreeBodyPointPotential<InverseProductTripletPotential, double, 3> {{}, box};
+
+    auto pool = common::ThreadPool {3};
+
+    SECTION("an adjacency matrix where everyone is a neighbour gives the full estimator")
+    {
+        auto adjmat = mathtools::SquareAdjacencyMatrix {n_particles};
+        for (std::size_t ip0 {0}; ip0 < n_particles - 1; ++ip0) {
+            for (std::size_t ip1 {ip0 + 1}; ip1 < n_particles; ++ip1) {
+                adjmat.add_neighbour_both(ip0, ip1);
+            }
+        }
+
+        const auto expected = estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot);
+        const auto actual = estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, adjmat);
+        const auto actual_threaded =
+            estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, adjmat, pool);
+
+        REQUIRE_THAT(actual, Catch::Matchers::WithinRel(expected, 1.0e-12));
+        REQUIRE(actual_threaded == actual);
+    }
+
+    SECTION("only triplets that are mutual neighbours contribute")
+    {
+        // 0-1, 0-2 and 1-2 form the only closed triplet; 3 is a neighbour of 0 alone
+        auto adjmat = mathtools::SquareAdjacencyMatrix {n_particles};
+        adjmat.add_neighbour_both(0, 1);
+        adjmat.add_neighbour_both(0, 2);
+        adjmat.add_neighbour_both(1, 2);
+        adjmat.add_neighbour_both(0, 3);
+
+        auto expected = 0.0;
+        for (std::size_t i_tslice {0}; i_tslice < worldlines.n_timeslices(); ++i_tslice) {
+            const auto timeslice = worldlines.timeslice(i_tslice);
+            expected += triplet_pot.within_box_cutoff(timeslice[0], timeslice[1], timeslice[2]);
+        }
+        expected /= static_cast<double>(worldlines.n_timeslices());
+
+        const auto actual = estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, adjmat);
+        REQUIRE_THAT(actual, Catch::Matchers::WithinRel(expected, 1.0e-12));
+    }
+}
+
+TEST_CASE("triplet potential estimator using a cell list", "[estimators]")
+{
+    const auto box = Box {10.0, 11.0, 12.0};
+    const auto worldlines = random_worldlines(4, 150, box);
+
+    auto pool = common::ThreadPool {3};
+
+    SECTION("a cutoff at the box cutoff distance gives the full estimator")
+    {
+        const auto triplet_pot =
+            interact::PeriodicThreeBodyPointPotential<InverseProductTripletPotential, double, 3> {{}, box};
+
+        const auto expected = estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot);
+        const auto cutoff = GENERATE(5.0, 100.0);
+
+        // the cell list cannot prune anything this far out
+        REQUIRE(!coord::is_cell_list_pruning_every_dimension(box, cutoff));
+        REQUIRE(estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, box, cutoff) == expected);
+        REQUIRE(estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, box, cutoff, pool) == expected);
+    }
+
+    SECTION("a shorter cutoff only keeps the triplets within the cutoff")
+    {
+        // several cells fit along each side of the box with this cutoff
+        const auto cutoff = 2.5;
+        REQUIRE(coord::is_cell_list_pruning_every_dimension(box, cutoff));
+
+        // the shortest side of the box is 10.0, so three cells fit up to a cutoff of 10.0 / 3
+        const auto longest_cutoff = coord::longest_pruning_cell_list_cutoff_distance(box);
+        REQUIRE_THAT(longest_cutoff, Catch::Matchers::WithinRel(10.0 / 3.0, 1.0e-12));
+        REQUIRE(coord::is_cell_list_pruning_every_dimension(box, longest_cutoff));
+        REQUIRE(!coord::is_cell_list_pruning_every_dimension(box, 1.001 * longest_cutoff));
+
+        const auto triplet_pot =
+            interact::PeriodicThreeBodyPointPotential<TruncatedInverseProductTripletPotential, double, 3> {
+                {cutoff}, box
+            };
+
+        const auto expected = estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot);
+
+        REQUIRE(expected > 0.0);
+        REQUIRE(estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, box, cutoff) == expected);
+        REQUIRE(estim::total_triplet_potential_energy_periodic(worldlines, triplet_pot, box, cutoff, pool) == expected);
+    }
+}
+
+TEST_CASE("sharded radial distribution function matches the serial version", "[estimators]")
+{
+    const auto box = Box {6.0, 6.5, 7.0};
+    const auto worldlines = random_worldlines(7, 30, box);
+    const auto distance_calculator = coord::PeriodicDistanceMeasureWrapper<double, 3> {box};
+
+    auto serial_histo = mathtools::Histogram<double> {0.0, 4.0, 40};
+    estim::update_radial_distribution_function_histogram(serial_histo, distance_calculator, worldlines);
+
+    const auto n_threads = GENERATE(std::size_t {1}, std::size_t {3}, std::size_t {16});
+    auto pool = common::ThreadPool {n_threads};
+
+    auto sharded_histo = mathtools::Histogram<double> {0.0, 4.0, 40};
+    estim::update_radial_distribution_function_histogram(sharded_histo, distance_calculator, worldlines, pool);
+
+    REQUIRE(sharded_histo.bins() == serial_histo.bins());
+}
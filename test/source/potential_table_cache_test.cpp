@@ -0,0 +1,188 @@
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../test_utils/test_utils.hpp"
+#include "interactions/table_cache.hpp"
+#include "interactions/three_body/published/three_body_ibrahim2022.hpp"
+#include "interactions/two_body/published/two_body_schmidt2015.hpp"
+
+namespace
+{
+
+namespace fs = std::filesystem;
+
+// each test case gets its own directory, so that the test cases can run in parallel
+auto fresh_test_dirpath(std::string_view test_name) -> fs::path
+{
+    auto dirname = std::string {"pimc_sim_potential_table_cache_test_"};
+    dirname += test_name;
+
+    const auto dirpath = fs::temp_directory_path() / dirname;
+    fs::remove_all(dirpath);
+    fs::create_directories(dirpath);
+
+    return dirpath;
+}
+
+auto copy_fsh_potential_file(const fs::path& dirpath) -> fs::path
+{
+    const auto rel_filepath = fs::path {"potentials"} / "fsh_potential_angstroms_wavenumbers.potext_sq";
+    const auto source_filepath = test_utils::resolve_project_path(rel_filepath);
+
+    const auto filepath = dirpath / "fsh.potext_sq";
+    fs::copy_file(source_filepath, filepath);
+
+    return filepath;
+}
+
+// flip one bit near the end of the file, inside the payload
+void damage_file(const fs::path& filepath)
+{
+    auto stream = std::fstream {filepath, std::ios::in | std::ios::out | std::ios::binary};
+    stream.seekg(-3, std::ios::end);
+    const auto byte = static_cast<char>(stream.get());
+
+    stream.seekp(-3, std::ios::end);
+    stream.put(static_cast<char>(byte ^ 0x10));
+}
+
+}  // namespace
+
+TEST_CASE("binary cache of the two-body potential table")
+{
+    const auto dirpath = fresh_test_dirpath("two_body");
+    const auto fsh_filepath = copy_fsh_potential_file(dirpath);
+    const auto cache_filepath = interact::table_cache_filepath(fsh_filepath);
+
+    const auto off = interact::TableCacheStatus::OFF;
+    const auto on = interact::TableCacheStatus::ON;
+
+    const auto parsed_pot = interact::two_body_schmidt2015<double>(fsh_filepath, off);
+    REQUIRE(!fs::exists(cache_filepath));
+
+    const auto expected_table = interact::read_schmidt2015_table<double>(fsh_filepath);
+
+    const auto same_as_parsed = [&](const auto& potential) {
+        for (const auto dist_squared : {4.0, 10.081, 12.0012, 29.923, 47.5247}) {
+            if (potential(dist_squared) != parsed_pot(dist_squared)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    SECTION("the first load writes the cache, and later loads read it")
+    {
+        const auto first_pot = interact::two_body_schmidt2015<double>(fsh_filepath, on);
+        REQUIRE(fs::exists(cache_filepath));
+        REQUIRE(same_as_parsed(first_pot));
+
+        const auto cached_table = interact::read_table_cache<double>(fsh_filepath);
+        REQUIRE(cached_table.has_value());
+        REQUIRE(cached_table->shape == expected_table.shape);
+        REQUIRE(cached_table->limits == expected_table.limits);
+        REQUIRE(cached_table->values == expected_table.values);
+
+        const auto second_pot = interact::two_body_schmidt2015<double>(fsh_filepath, on);
+        REQUIRE(same_as_parsed(second_pot));
+    }
+
+    SECTION("a cache for a different floating-point type is not used")
+    {
+        interact::write_table_cache<double>(fsh_filepath, expected_table);
+
+        REQUIRE(interact::read_table_cache<double>(fsh_filepath).has_value());
+        REQUIRE(!interact::read_table_cache<float>(fsh_filepath).has_value());
+    }
+
+    SECTION("a damaged cache is ignored and replaced")
+    {
+        interact::write_table_cache<double>(fsh_filepath, expected_table);
+        damage_file(cache_filepath);
+
+        REQUIRE(!interact::read_table_cache<double>(fsh_filepath).has_value());
+
+        const auto pot = interact::two_body_schmidt2015<double>(fsh_filepath, on);
+        REQUIRE(same_as_parsed(pot));
+        REQUIRE(interact::read_table_cache<double>(fsh_filepath).has_value());
+    }
+
+    SECTION("a cache built from an older version of the text file is not used")
+    {
+        interact::write_table_cache<double>(fsh_filepath, expected_table);
+
+        auto stream = std::ofstream {fsh_filepath, std::ios::app};
+        stream << '\n';
+        stream.close();
+
+        REQUIRE(!interact::read_table_cache<double>(fsh_filepath).has_value());
+    }
+
+    fs::remove_all(dirpath);
+}
+
+TEST_CASE("binary cache of the three-body potential table")
+{
+    const auto dirpath = fresh_test_dirpath("three_body");
+    const auto data_filepath = dirpath / "three_body.dat";
+
+    {
+        auto stream = std::ofstream {data_filepath};
+        stream << "# a small made-up table\n";
+        stream << "2 3 2\n";
+        stream << "2.0 4.0 1.0 3.0 0.0 1.0\n";
+        for (std::size_t i {0}; i < 12; ++i) {
+            stream << 0.25 * static_cast<double>(i) - 1.0 << '\n';
+        }
+    }
+
+    const auto parsed_pot = interact::three_body_ibrahim2022<double>(data_filepath);
+
+    const auto on = interact::TableCacheStatus::ON;
+    const auto first_pot = interact::three_body_ibrahim2022<double>(data_filepath, std::nullopt, on);
+    REQUIRE(fs::exists(interact::table_cache_filepath(data_filepath)));
+
+    const auto second_pot = interact::three_body_ibrahim2022<double>(data_filepath, std::nullopt, on);
+
+    const auto table = interact::read_table_cache<double>(data_filepath);
+    REQUIRE(table.has_value());
+    REQUIRE(table->shape == std::vector<std::size_t> {2, 3, 2});
+    REQUIRE(table->limits == std::vector<double> {2.0, 4.0, 1.0, 3.0, 0.0, 1.0});
+    REQUIRE(table->values.size() == 12);
+
+    for (const auto dist : {2.5, 3.0, 3.7}) {
+        const auto expected = parsed_pot(dist, dist * 1.1, dist * 0.95);
+        REQUIRE(first_pot(dist, dist * 1.1, dist * 0.95) == expected);
+        REQUIRE(second_pot(dist, dist * 1.1, dist * 0.95) == expected);
+    }
+
+    SECTION("a shared table keeps its values in the mapped image")
+    {
+        auto shared_table = interact::map_table_cache<double>(data_filepath);
+        REQUIRE(shared_table.has_value());
+        REQUIRE(shared_table->values.empty());
+        REQUIRE(shared_table->shared_values != nullptr);
+        REQUIRE(shared_table->n_values() == 12);
+
+        const auto shared = interact::TableCacheStatus::SHARED;
+        const auto shared_pot = interact::three_body_ibrahim2022<double>(data_filepath, std::nullopt, shared);
+
+        // the mapping outlives the image file it was made from
+        fs::remove(interact::table_cache_filepath(data_filepath));
+
+        REQUIRE(shared_table->release_values() == table->values);
+        for (const auto dist : {2.5, 3.0, 3.7}) {
+            REQUIRE(shared_pot(dist, dist * 1.1, dist * 0.95) == parsed_pot(dist, dist * 1.1, dist * 0.95));
+        }
+    }
+
+    fs::remove_all(dirpath);
+}
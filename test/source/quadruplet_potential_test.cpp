@@ -0,0 +1,111 @@
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "coordinates/attard/four_body.hpp"
+#include "coordinates/box_sides.hpp"
+#include "coordinates/cartesian.hpp"
+#include "coordinates/measure.hpp"
+#include "coordinates/periodic_shift.hpp"
+#include "estimators/pimc/four_body_potential.hpp"
+
+namespace
+{
+
+using Point = coord::Cartesian<double, 3>;
+using Box = coord::BoxSides<double, 3>;
+using SideLengths = coord::FourBodySideLengths<double>;
+
+/*
+    Records every sample it is given, so the order and values of the samples can be compared.
+*/
+struct RecordingPotential
+{
+    void add_sample(const SideLengths& sides)
+    {
+        samples.push_back(sides);
+    }
+
+    auto extract_energy() -> double
+    {
+        return static_cast<double>(samples.size());
+    }
+
+    std::vector<SideLengths> samples {};
+};
+
+// check every quadruplet of particles, after shifting all particles towards the reference particle
+auto brute_force_samples(std::span<const Point> points, const Box& box, double cutoff_distance)
+    -> std::vector<SideLengths>
+{
+    const auto cutoff_sq = cutoff_distance * cutoff_distance;
+    auto samples = std::vector<SideLengths> {};
+
+    for (std::size_t i0 {0}; i0 + 3 < points.size(); ++i0) {
+        const auto shifted = coord::shift_points_together(i0, box, points);
+
+        for (std::size_t i1 {i0 + 1}; i1 < points.size(); ++i1) {
+            for (std::size_t i2 {i1 + 1}; i2 < points.size(); ++i2) {
+                for (std::size_t i3 {i2 + 1}; i3 < points.size(); ++i3) {
+                    const auto d01 = coord::distance_squared(shifted[i0], shifted[i1]);
+                    const auto d02 = coord::distance_squared(shifted[i0], shifted[i2]);
+                    const auto d03 = coord::distance_squared(shifted[i0], shifted[i3]);
+                    const auto d12 = coord::distance_squared(shifted[i1], shifted[i2]);
+                    const auto d13 = coord::distance_squared(shifted[i1], shifted[i3]);
+                    const auto d23 = coord::distance_squared(shifted[i2], shifted[i3]);
+
+                    if (d01 > cutoff_sq || d02 > cutoff_sq || d03 > cutoff_sq || d12 > cutoff_sq || d13 > cutoff_sq
+                        || d23 > cutoff_sq) {
+                        continue;
+                    }
+
+                    samples.push_back(
+                        {std::sqrt(d01), std::sqrt(d02), std::sqrt(d03), std::sqrt(d12), std::sqrt(d13), std::sqrt(d23)}
+                    );
+                }
+            }
+        }
+    }
+
+    return samples;
+}
+
+auto is_same_sample(const SideLengths& left, const SideLengths& right) -> bool
+{
+    return left.dist01 == right.dist01 && left.dist02 == right.dist02 && left.dist03 == right.dist03
+        && left.dist12 == right.dist12 && left.dist13 == right.dist13 && left.dist23 == right.dist23;
+}
+
+}  // namespace
+
+TEST_CASE("timeslice_quadruplet_potential_energy matches brute force", "[timeslice_quadruplet_potential_energy]")
+{
+    const auto box = Box {6.0, 7.0, 8.0};
+
+    // particles are placed partly outside the box, to check that they are wrapped back in properly
+    auto prng = std::mt19937 {42};
+    auto distrib = std::uniform_real_distribution<double> {-2.0, 10.0};
+
+    auto points = std::vector<Point> {};
+    for (std::size_t i {0}; i < 60; ++i) {
+        points.emplace_back(distrib(prng), distrib(prng), distrib(prng));
+    }
+
+    const auto cutoff_distance = GENERATE(3.0, 2.2, 1.5);
+
+    auto pot = RecordingPotential {};
+    estim::timeslice_quadruplet_potential_energy<double, 3>(points, pot, box, cutoff_distance);
+
+    const auto expected = brute_force_samples(points, box, cutoff_distance);
+
+    REQUIRE(!expected.empty());
+    REQUIRE(pot.samples.size() == expected.size());
+    for (std::size_t i {0}; i < expected.size(); ++i) {
+        REQUIRE(is_same_sample(pot.samples[i], expected[i]));
+    }
+}
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <random>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "mathtools/statistics/blocking.hpp"
+#include "simulation/stopping.hpp"
+
+namespace
+{
+
+auto example_estimate(double mean, double standard_error, bool is_converged, std::size_t n_samples = 1000)
+    -> mathtools::BlockingEstimate<double>
+{
+    auto estimate = mathtools::BlockingEstimate<double> {};
+    estimate.n_samples = n_samples;
+    estimate.mean = mean;
+    estimate.standard_error = standard_error;
+    estimate.is_converged = is_converged;
+
+    return estimate;
+}
+
+}  // namespace
+
+TEST_CASE("relative error targets", "[stopping]")
+{
+    SECTION("the relative error uses the size of the mean")
+    {
+        REQUIRE_THAT(sim::relative_error(example_estimate(-200.0, 0.5, true)), Catch::Matchers::WithinRel(2.5e-3));
+    }
+
+    SECTION("a converged estimate meets a target above its relative error")
+    {
+        const auto estimate = example_estimate(1000.0, 1.0, true);
+        REQUIRE(sim::is_relative_error_target_met(estimate, 2.0e-3));
+        REQUIRE(!sim::is_relative_error_target_met(estimate, 5.0e-4));
+    }
+
+    SECTION("an estimate that hasn't converged never meets its target")
+    {
+        const auto estimate = example_estimate(1000.0, 1.0, false);
+        REQUIRE(!sim::is_relative_error_target_met(estimate, 1.0));
+    }
+
+    SECTION("a converged estimate from too few values never meets its target")
+    {
+        const auto n_minimum = sim::MINIMUM_N_SAMPLES_FOR_ERROR_TARGET;
+
+        REQUIRE(!sim::is_relative_error_target_met(example_estimate(1000.0, 1.0, true, n_minimum - 1), 1.0));
+        REQUIRE(sim::is_relative_error_target_met(example_estimate(1000.0, 1.0, true, n_minimum), 1.0));
+    }
+
+    SECTION("a short correlated run never meets its target")
+    {
+        // values from an AR(1) process with phi = 0.8, so each value is strongly correlated with the last
+        auto prng = std::mt19937 {23};
+        auto normal = std::normal_distribution<double> {0.0, 1.0};
+
+        auto analysis = mathtools::StreamingBlockingAnalysis<double> {};
+        auto value = double {0.0};
+        for (std::size_t i {0}; i < 200; ++i) {
+            value = 0.8 * value + normal(prng);
+            analysis.add(100.0 + value);
+        }
+
+        REQUIRE(!sim::is_relative_error_target_met(analysis.estimate(), 1.0));
+    }
+
+    SECTION("an estimate without an error never meets its target")
+    {
+        const auto estimate = mathtools::BlockingEstimate<double> {};
+        REQUIRE(std::isnan(sim::relative_error(estimate)));
+        REQUIRE(!sim::is_relative_error_target_met(estimate, 1.0));
+    }
+}
+
+TEST_CASE("WallClockBudget", "[stopping]")
+{
+    using clock = sim::WallClockBudget::clock;
+    using std::chrono::seconds;
+
+    const auto start = clock::time_point {};
+
+    SECTION("without a budget, the time never runs out")
+    {
+        auto budget = sim::WallClockBudget {std::nullopt, start};
+        budget.start_block(start);
+        budget.end_block(start + seconds {100});
+
+        REQUIRE(!budget.is_nearly_exhausted(start + seconds {1000000}));
+    }
+
+    SECTION("the next block is assumed to take as long as the longest one so far")
+    {
+        auto budget = sim::WallClockBudget {100.0, start};
+
+        budget.start_block(start + seconds {5});
+        budget.end_block(start + seconds {25});
+        budget.start_block(start + seconds {25});
+        budget.end_block(start + seconds {35});
+
+        // the longest block took 20 seconds, so one more fits until 80 seconds have passed
+        REQUIRE(!budget.is_nearly_exhausted(start + seconds {35}));
+        REQUIRE(!budget.is_nearly_exhausted(start + seconds {80}));
+        REQUIRE(budget.is_nearly_exhausted(start + seconds {81}));
+    }
+
+    SECTION("the budget runs out once the time has passed, even before any block")
+    {
+        const auto budget = sim::WallClockBudget {10.0, start};
+
+        REQUIRE(!budget.is_nearly_exhausted(start + seconds {9}));
+        REQUIRE(budget.is_nearly_exhausted(start + seconds {11}));
+    }
+}
@@ -0,0 +1,108 @@
+// the tracer is compiled out unless this is defined
+#define PIMC_SIM_TRACE_EVENTS
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/trace_events.hpp"
+
+namespace
+{
+
+auto trace_filepath() -> std::filesystem::path
+{
+    namespace fs = std::filesystem;
+
+    const auto dirpath = fs::temp_directory_path() / "pimc_sim_trace_events_test";
+    fs::remove_all(dirpath);
+    fs::create_directories(dirpath);
+
+    return dirpath / "trace_events.json";
+}
+
+auto read_file(const std::filesystem::path& filepath) -> std::string
+{
+    auto in_stream = std::ifstream {filepath};
+    return std::string {std::istreambuf_iterator<char> {in_stream}, std::istreambuf_iterator<char> {}};
+}
+
+auto count_occurrences(const std::string& contents, const std::string& pattern) -> std::size_t
+{
+    auto count = std::size_t {0};
+    for (auto pos = contents.find(pattern); pos != std::string::npos; pos = contents.find(pattern, pos + 1)) {
+        ++count;
+    }
+
+    return count;
+}
+
+}  // namespace
+
+TEST_CASE("trace events", "[trace]")
+{
+    namespace trace = common::trace;
+
+    const auto filepath = trace_filepath();
+
+    SECTION("scopes are only recorded while recording is on")
+    {
+        {
+            const auto scope = trace::TraceScope {"before"};
+        }
+
+        trace::set_recording(true);
+        {
+            const auto outer = trace::TraceScope {"block", "i_block", 7};
+            const auto inner = trace::TraceScope {"move"};
+        }
+
+        // the events of other threads are written out too
+        auto worker = std::thread {[]() { const auto scope = trace::TraceScope {"worker"}; }};
+        worker.join();
+
+        trace::set_recording(false);
+        {
+            const auto scope = trace::TraceScope {"after"};
+        }
+
+        const auto summary = trace::write_trace_events(filepath);
+        REQUIRE(summary.n_events == 3);
+        REQUIRE(summary.n_overwritten_events == 0);
+
+        const auto contents = read_file(filepath);
+        REQUIRE(contents.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+        REQUIRE(count_occurrences(contents, "\"ph\":\"X\"") == 3);
+        REQUIRE(count_occurrences(contents, "\"name\":\"block\"") == 1);
+        REQUIRE(count_occurrences(contents, "\"args\":{\"i_block\":7}") == 1);
+        REQUIRE(count_occurrences(contents, "\"name\":\"move\"") == 1);
+        REQUIRE(count_occurrences(contents, "\"name\":\"worker\"") == 1);
+        REQUIRE(count_occurrences(contents, "\"before\"") == 0);
+        REQUIRE(count_occurrences(contents, "\"after\"") == 0);
+
+        // writing the events empties the buffers
+        const auto second_summary = trace::write_trace_events(filepath);
+        REQUIRE(second_summary.n_events == 0);
+    }
+
+    SECTION("a full buffer overwrites its oldest events")
+    {
+        const auto n_extra = std::size_t {5};
+        const auto capacity = impl_common_trace::DEFAULT_TRACE_BUFFER_CAPACITY;
+
+        trace::set_recording(true);
+        for (std::size_t i {0}; i < capacity + n_extra; ++i) {
+            const auto scope = trace::TraceScope {"event"};
+        }
+        trace::set_recording(false);
+
+        const auto summary = trace::write_trace_events(filepath);
+        REQUIRE(summary.n_events == capacity);
+        REQUIRE(summary.n_overwritten_events == n_extra);
+    }
+}
@@ -1,3 +1,6 @@
+#include <memory>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
@@ -61,3 +64,46 @@ TEST_CASE("test basic trilinear interpolation", "[TrilinearInterpolator]")
         }
     }
 }
+
+TEST_CASE("Grid3D copies and shared views", "[Grid3D]")
+{
+    SECTION("copies of a grid that owns its values are independent")
+    {
+        auto grid = create_234_grid();
+        auto copy = grid;
+        copy.set(1, 2, 3, -1.0);
+
+        REQUIRE(copy.get(1, 2, 3) == -1.0);
+        REQUIRE(grid.get(1, 2, 3) == trilinear_function(1.0, 2.0, 3.0));
+
+        auto assigned = mathtools::Grid3D<double> {mathtools::Shape3D {1, 1, 1}};
+        assigned = grid;
+        grid.set(0, 0, 0, -2.0);
+        REQUIRE(assigned.get(0, 0, 0) == trilinear_function(0.0, 0.0, 0.0));
+    }
+
+    SECTION("a grid can view values it does not own")
+    {
+        const auto owning_grid = create_234_grid();
+        const auto values = owning_grid.data();
+
+        auto storage = std::make_shared<std::vector<double>>(values.begin(), values.end());
+        const auto shared_data = std::shared_ptr<const double> {storage, storage->data()};
+
+        const auto shape = owning_grid.shape();
+        const auto shared_grid = mathtools::Grid3D<double> {shared_data, shape};
+        const auto shared_copy = shared_grid;
+
+        REQUIRE(shared_grid.is_shared());
+        REQUIRE(!owning_grid.is_shared());
+        REQUIRE(shared_copy.data().data() == storage->data());
+
+        for (std::size_t i0 {0}; i0 < shape.size0; ++i0) {
+            for (std::size_t i1 {0}; i1 < shape.size1; ++i1) {
+                for (std::size_t i2 {0}; i2 < shape.size2; ++i2) {
+                    REQUIRE(shared_copy.get(i0, i1, i2) == owning_grid.get(i0, i1, i2));
+                }
+            }
+        }
+    }
+}